@@ -0,0 +1,228 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file AdaptiveDebouncer.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Per-key debouncing, with windows adapting to how much each key bounces
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include "config.h"
+#include "Matrix.h"
+#include "KeyboardScanner.h"
+
+/** \brief Per-key debouncer
+ *
+ * Every key has its own debounce window: a key changes state once its raw
+ * reading has been stable for that many scans. Everything between the first
+ * edge and the end of the window is a \a transition.
+ *
+ * Windows adapt to each key. After every transition, the window should have
+ * covered the time from the first to the last edge, plus
+ * #ADAPTIVE_DEBOUNCE_MARGIN:
+ * - If it was shorter, it is made that long right away.
+ * - If it was longer, it is shortened by one scan, so that a single clean
+ *   transition does not undo what was learnt from many bouncy ones.
+ *
+ * When a key bounces again shortly after a transition is over (i.e. its window
+ * was too short and it was probably pressed twice), its window is also made
+ * longer than the quiet time that fooled it.
+ *
+ * Windows never go below #ADAPTIVE_DEBOUNCE_MIN or above the maximum set with
+ * setLength(), which is also where they start from.
+ *
+ * Only keys that changed recently are looked at, so scanning an idle keyboard
+ * costs next to nothing.
+ *
+ * This has the same methods as the debouncers in Debouncers.h.
+ */
+template <byte NUMROWS, byte NUMCOLS, typename TYPECOLS>
+class AdaptiveDebouncer {
+public:
+	typedef MatrixBase<NUMROWS, TYPECOLS> Matrix;
+
+	/** \brief Start debouncing
+	 *
+	 * \param[in] initial Raw matrix to start from, taken as stable
+	 * \param[in] maxWindow See setLength()
+	 */
+	void begin (const Matrix& initial, const byte maxWindow) {
+		for (byte row = 0; row < NUMROWS; ++row) {
+			raw[row] = initial[row];
+			stable[row] = initial[row];
+			active[row] = 0;
+		}
+
+		memset (keys, 0x00, sizeof (keys));
+		setLength (maxWindow);
+		for (byte row = 0; row < NUMROWS; ++row) {
+			for (byte col = 0; col < NUMCOLS; ++col) {
+				keys[row][col].stats.window = maxLength;
+			}
+		}
+	}
+
+	//! \brief Set the longest window any key can use, in scans
+	void setLength (const byte w) {
+		maxLength = w > ADAPTIVE_DEBOUNCE_MIN ? w : ADAPTIVE_DEBOUNCE_MIN;
+		for (byte row = 0; row < NUMROWS; ++row) {
+			for (byte col = 0; col < NUMCOLS; ++col) {
+				byte& window = keys[row][col].stats.window;
+				if (window > maxLength) {
+					window = maxLength;
+				}
+			}
+		}
+	}
+
+	/** \brief Feed a new raw reading of a row
+	 *
+	 * \param[in] row The row that was read
+	 * \param[in] data Raw column readings
+	 * \return The debounced row
+	 */
+	TYPECOLS update (const byte row, const TYPECOLS data) {
+		const TYPECOLS changed = raw[row] ^ data;
+		raw[row] = data;
+
+		TYPECOLS todo = active[row] | changed;
+		TYPECOLS mask = 1;
+		for (byte col = 0; todo != 0; ++col, todo >>= 1, mask <<= 1) {
+			if (todo & 1) {
+				track (row, col, mask, changed & mask);
+			}
+		}
+
+		return stable[row];
+	}
+
+	//! \brief Every key is debounced on its own, so the matrix can be used after any scan
+	boolean settled () {
+		return true;
+	}
+
+	//! \brief Last raw reading of a row
+	TYPECOLS getRaw (const byte row) const {
+		return raw[row];
+	}
+
+	const BounceStats *getStats (const byte row, const byte col) const {
+		return &keys[row][col].stats;
+	}
+
+	//! \brief Clear all statistics, windows are kept
+	void resetStats () {
+		for (byte row = 0; row < NUMROWS; ++row) {
+			for (byte col = 0; col < NUMCOLS; ++col) {
+				BounceStats& s = keys[row][col].stats;
+				const byte window = s.window;
+				memset (&s, 0x00, sizeof (s));
+				s.window = window;
+			}
+		}
+	}
+
+private:
+	struct Tracker {
+		BounceStats stats;
+		byte edges;		//!< Edges in the current transition, 0 if there is none
+		byte span;		//!< Scans since the first edge of the current transition
+		byte idle;		//!< Scans since the last edge
+	};
+
+	//! \brief Last raw readings
+	Matrix raw;
+
+	//! \brief Debounced matrix
+	Matrix stable;
+
+	//! \brief Keys in a transition or that just completed one
+	Matrix active;
+
+	Tracker keys[NUMROWS][NUMCOLS];
+
+	byte maxLength;
+
+	static void increment (byte& b) {
+		if (b < 0xFF) {
+			++b;
+		}
+	}
+
+	//! \brief Make the window of \a k at least \a length scans long
+	void grow (Tracker& k, const word length) {
+		if (length > k.stats.window) {
+			k.stats.window = length < maxLength ? length : maxLength;
+		}
+	}
+
+	void track (const byte row, const byte col, const TYPECOLS mask, const boolean edge) {
+		Tracker& k = keys[row][col];
+
+		if (edge) {
+			if (k.edges == 0) {
+				if (active[row] & mask) {
+					/* The previous transition is barely over, so this is most
+					 * likely a bounce that came after the window closed
+					 */
+					increment (k.stats.chatter);
+					grow (k, k.idle + 1 + ADAPTIVE_DEBOUNCE_MARGIN);
+				}
+				k.span = 0;
+				active[row] |= mask;
+			} else {
+				increment (k.span);
+			}
+			increment (k.edges);
+			k.idle = 0;
+		} else {
+			increment (k.idle);
+			if (k.edges > 0) {
+				increment (k.span);
+				if (k.idle >= k.stats.window) {
+					settle (row, mask, k);
+				}
+			} else if (k.idle >= maxLength) {
+				// Quiet for long enough, stop looking at this key
+				active[row] &= ~mask;
+			}
+		}
+	}
+
+	//! \brief End of a transition, the key keeps being watched for late bounces
+	void settle (const byte row, const TYPECOLS mask, Tracker& k) {
+		if ((raw[row] ^ stable[row]) & mask) {
+			stable[row] ^= mask;
+
+			BounceStats& s = k.stats;
+			if (s.transitions < 0xFFFF) {
+				++s.transitions;
+				s.edges = s.edges + k.edges < 0xFFFF ? s.edges + k.edges : 0xFFFF;
+			}
+
+			const byte settleTime = k.span - k.idle;
+			if (settleTime > s.maxSettle) {
+				s.maxSettle = settleTime;
+			}
+
+			const word needed = settleTime + 1 + ADAPTIVE_DEBOUNCE_MARGIN;
+			if (needed > s.window) {
+				grow (k, needed);
+			} else if (s.window > needed && s.window > ADAPTIVE_DEBOUNCE_MIN) {
+				--s.window;
+			}
+		}
+		// Otherwise the key went back to where it was: just noise, filtered out
+
+		k.edges = 0;
+	}
+};
@@ -18,9 +18,12 @@
 
 #include <Arduino.h>
 #include "LedControl.h"
+#include "Dispatch.h"
 
 class Animation {
 public:
+#ifndef ENABLE_STATIC_DISPATCH
 	virtual void begin (LedControl& lc_) = 0;
 	virtual boolean step () = 0;
+#endif
 };
@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file AnimationBytecode.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Startup animation played from a compact bytecode program
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include <avr/pgmspace.h>
+#include "AnimationBytecode.h"
+#include "C16Key.h"
+#include "MatrixCoordinates.h"
+
+void AnimationBytecode::load (const byte *prog) {
+	program = prog;
+}
+
+void AnimationBytecode::begin (LedControl& lc_) {
+	lc = &lc_;
+	pc = program;
+	depth = 0;
+	for (byte r = 0; r < 8; ++r) {
+		frame[r] = 0x00;
+	}
+}
+
+void AnimationBytecode::setRow (const byte row, const byte value) {
+	if (frame[row] != value) {
+		frame[row] = value;
+		lc -> setRow (0, row, value);
+	}
+}
+
+boolean AnimationBytecode::step () {
+	// Run opcodes until we get to something that must be shown for a while
+	while (pc) {
+		const byte op = pgm_read_byte (pc++);
+
+		if (op >= ANIM_OP_KEY_ON) {
+			const byte k = op & 0x3F;
+			if (k < N_PHYSICAL_KEYS) {
+				const MatrixCoordinates& pos = ledCoordinates[k];
+				const byte mask = 0x80 >> pos.col;		// Same as LedControl::setLed()
+				if ((op & ANIM_OP_KEY_OFF) == ANIM_OP_KEY_OFF) {
+					setRow (pos.row, frame[pos.row] & ~mask);
+				} else {
+					setRow (pos.row, frame[pos.row] | mask);
+				}
+			}
+		} else {
+			switch (op) {
+				case ANIM_OP_CLEAR:
+					for (byte r = 0; r < 8; ++r) {
+						setRow (r, 0x00);
+					}
+					break;
+				case ANIM_OP_FRAME:
+					for (byte r = 0; r < 8; ++r) {
+						setRow (r, pgm_read_byte (pc++));
+					}
+					break;
+				case ANIM_OP_DELTA: {
+					const byte rowMask = pgm_read_byte (pc++);
+					for (byte r = 0; r < 8; ++r) {
+						if (rowMask & (1 << r)) {
+							setRow (r, frame[r] ^ pgm_read_byte (pc++));
+						}
+					}
+					break;
+				}
+				case ANIM_OP_RLE: {
+					byte r = 0;
+					while (r < 8) {
+						const byte count = pgm_read_byte (pc++);
+						const byte value = pgm_read_byte (pc++);
+						for (byte n = 0; n < count && r < 8; ++n) {
+							setRow (r++, value);
+						}
+					}
+					break;
+				}
+				case ANIM_OP_WAIT:
+					delay (pgm_read_byte (pc++));
+					return true;
+				case ANIM_OP_LOOP:
+					if (depth < MAX_LOOP_DEPTH) {
+						loops[depth].count = pgm_read_byte (pc++);
+						loops[depth].start = pc;
+						++depth;
+					} else {
+						// Malformed program
+						pc = nullptr;
+					}
+					break;
+				case ANIM_OP_NEXT:
+					if (depth > 0) {
+						Loop& l = loops[depth - 1];
+						if (--l.count > 0) {
+							pc = l.start;
+						} else {
+							--depth;
+						}
+					}
+					break;
+				case ANIM_OP_END:
+				default:
+					pc = nullptr;
+					break;
+			}
+		}
+	}
+
+	return false;
+}
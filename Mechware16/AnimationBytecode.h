@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file AnimationBytecode.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Startup animation played from a compact bytecode program
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include "Animation.h"
+
+/** \brief Animation bytecode opcodes
+ *
+ * A program is a sequence of opcodes stored in flash, each one possibly
+ * followed by some operand bytes. Frames are expressed in LED matrix space,
+ * i.e. one byte per row as expected by LedControl::setRow(), while the KEY_*
+ * opcodes address a single key by its #C16Key value, so that they do not
+ * depend on how the leds are wired.
+ *
+ * Programs are not supposed to be written by hand, use tools/animenc.py.
+ */
+enum AnimationOpcode: byte {
+	ANIM_OP_END = 0x00,			//!< End of program
+	ANIM_OP_CLEAR = 0x01,		//!< Turn all leds off
+	ANIM_OP_FRAME = 0x02,		//!< Full frame: 8 row bytes follow
+	ANIM_OP_DELTA = 0x03,		//!< Row mask follows, then one byte for every bit set, to be XOR'ed to that row
+	ANIM_OP_RLE = 0x04,			//!< (count, row value) pairs follow, until 8 rows are covered
+	ANIM_OP_WAIT = 0x05,		//!< Show current frame for the number of ms that follows
+	ANIM_OP_LOOP = 0x06,		//!< Repeat what follows up to ANIM_OP_NEXT for the number of times that follows
+	ANIM_OP_NEXT = 0x07,		//!< End of loop body
+	ANIM_OP_KEY_ON = 0x80,		//!< Turn on the led of key (opcode & 0x3F)
+	ANIM_OP_KEY_OFF = 0xC0		//!< Turn off the led of key (opcode & 0x3F)
+};
+
+/** \brief Bytecode interpreter animation
+ *
+ * Plays any of the programs listed in AnimationPrograms.h, so that new
+ * animations only cost the bytes of their program.
+ */
+class AnimationBytecode: public Animation {
+public:
+	/** \brief Select program to be played
+	 *
+	 * \param[in] prog Pointer to the program, in flash
+	 */
+	void load (const byte *prog);
+
+	DISPATCH_VIRTUAL void begin (LedControl& lc_) DISPATCH_OVERRIDE;
+	DISPATCH_VIRTUAL boolean step () DISPATCH_OVERRIDE;
+
+private:
+	//! \brief Maximum nesting of loops
+	static constexpr byte MAX_LOOP_DEPTH = 2;
+
+	struct Loop {
+		const byte *start;
+		byte count;
+	};
+
+	LedControl *lc;
+
+	const byte *program;
+
+	//! \brief Program counter, points in flash
+	const byte *pc;
+
+	//! \brief Current led pattern, needed for delta frames
+	byte frame[8];
+
+	Loop loops[MAX_LOOP_DEPTH];
+
+	byte depth;
+
+	void setRow (const byte row, const byte value);
+};
@@ -20,8 +20,8 @@
 
 class AnimationChasing: public Animation {
 public:
-	virtual void begin (LedControl& lc_) override;
-	virtual boolean step () override;
+	DISPATCH_VIRTUAL void begin (LedControl& lc_) DISPATCH_OVERRIDE;
+	DISPATCH_VIRTUAL boolean step () DISPATCH_OVERRIDE;
 
 private:
 	LedControl *lc;
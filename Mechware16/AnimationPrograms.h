@@ -0,0 +1,46 @@
+/**
+ * \file AnimationPrograms.h
+ * \brief Bytecode animation programs
+ *
+ * GENERATED by tools/animenc.py, DO NOT EDIT! Modify the sources in
+ * tools/animations/ and regenerate this file instead, with:
+ *   tools/animenc.py -o Mechware16/AnimationPrograms.h tools/animations/blink.anim tools/animations/sweep.anim tools/animations/fill.anim
+ *
+ * 3 programs, 182 bytes total.
+ */
+
+#pragma once
+
+#include <avr/pgmspace.h>
+
+// blink.anim, 12 bytes
+const byte animProgramBlink[] PROGMEM = {
+	0x06, 0x03, 0x04, 0x08, 0xFF, 0x05, 0x96, 0x01, 0x05, 0x96, 0x07, 0x00
+};
+
+// sweep.anim, 93 bytes
+const byte animProgramSweep[] PROGMEM = {
+	0x02, 0xFF, 0x00, 0x00, 0xBF, 0x41, 0x00, 0x00, 0x00, 0x05, 0x46, 0x02, 0x00, 0xBE, 0x80, 0x00,
+	0x00, 0x40, 0xBF, 0x40, 0x05, 0x46, 0x03, 0xE6, 0xFF, 0xBF, 0x7E, 0xFF, 0xC0, 0x05, 0x46, 0x02,
+	0x00, 0x00, 0x40, 0x40, 0x3E, 0x81, 0x00, 0x3F, 0x05, 0x46, 0x04, 0x04, 0x00, 0x01, 0x80, 0x03,
+	0x00, 0x05, 0x46, 0x03, 0xBC, 0x40, 0x40, 0xBE, 0x81, 0x3F, 0x05, 0x46, 0x02, 0x00, 0x41, 0x3F,
+	0x00, 0x00, 0x3E, 0x40, 0x80, 0x05, 0x46, 0x03, 0xE6, 0xFF, 0xBF, 0x7E, 0xFF, 0xC0, 0x05, 0x46,
+	0x02, 0xFF, 0x00, 0x00, 0xBF, 0x41, 0x00, 0x00, 0x00, 0x05, 0x46, 0x01, 0x00
+};
+
+// fill.anim, 77 bytes
+const byte animProgramFill[] PROGMEM = {
+	0x04, 0x04, 0x00, 0x01, 0x80, 0x03, 0x00, 0x05, 0x50, 0x03, 0xBC, 0x40, 0x40, 0x3E, 0x81, 0x3F,
+	0x05, 0x50, 0x03, 0xE6, 0x41, 0x3F, 0x3E, 0x40, 0x80, 0x05, 0x50, 0x03, 0xE6, 0xBE, 0x80, 0x40,
+	0xBF, 0x40, 0x05, 0x50, 0x04, 0x08, 0xFF, 0x05, 0xFA, 0x03, 0x19, 0xFF, 0xBF, 0x41, 0x05, 0x50,
+	0x03, 0xE6, 0xBE, 0x80, 0x40, 0xBF, 0x40, 0x05, 0x50, 0x03, 0xE6, 0x41, 0x3F, 0x3E, 0x40, 0x80,
+	0x05, 0x50, 0x04, 0x04, 0x00, 0x01, 0x80, 0x03, 0x00, 0x05, 0x50, 0x01, 0x00
+};
+
+constexpr byte N_ANIMATION_PROGRAMS = 3;
+
+const byte * const animationPrograms[N_ANIMATION_PROGRAMS] PROGMEM = {
+	animProgramBlink,
+	animProgramSweep,
+	animProgramFill
+};
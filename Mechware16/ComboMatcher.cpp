@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file ComboMatcher.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Table-driven key combo matcher
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include <avr/pgmspace.h>
+#include "ComboMatcher.h"
+
+void ComboMatcher::begin (const Combo *t, const byte n, ComboCallback cb) {
+	table = t;
+	tableSize = n;
+	callback = cb;
+	last.clear ();
+	activeIdx = NO_COMBO;
+}
+
+byte ComboMatcher::match (const KeyState& keys) {
+	byte ret = NO_COMBO;
+
+	for (byte i = 0; i < tableSize && ret == NO_COMBO; ++i) {
+		Combo c;
+		memcpy_P (&c, &table[i], sizeof (c));
+		if (keys.all (c.keys)) {
+			ret = i;
+			if (ret != activeIdx) {
+				active = c;
+			}
+		}
+	}
+
+	return ret;
+}
+
+void ComboMatcher::trigger () {
+	callback (active.action, active.arg);
+	if (triggers < 2) {
+		++triggers;
+	}
+	since = millis ();
+}
+
+void ComboMatcher::update (const KeyState& keys) {
+	if (keys != last) {
+		last = keys;
+
+		const byte idx = match (keys);
+		if (idx != activeIdx) {
+			// A different combo (or none at all) is now pressed
+			activeIdx = idx;
+			triggers = 0;
+			since = millis ();
+			if (activeIdx != NO_COMBO && active.trigger != COMBO_ON_HOLD) {
+				trigger ();
+			}
+		}
+	}
+
+	if (activeIdx != NO_COMBO) {
+		const unsigned long held = millis () - since;
+		switch (active.trigger) {
+			case COMBO_ON_HOLD:
+				if (triggers == 0 && held >= HOLD_MS) {
+					trigger ();
+				}
+				break;
+			case COMBO_REPEAT:
+				// The first repetition comes after a longer delay
+				if (held >= (triggers < 2 ? REPEAT_DELAY_MS : REPEAT_INTERVAL_MS)) {
+					trigger ();
+				}
+				break;
+			case COMBO_ON_PRESS:
+			default:
+				break;
+		}
+	}
+}
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file ComboMatcher.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Table-driven key combo matcher
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "KeyState.h"
+
+//! \brief When the action of a combo is triggered
+enum ComboTrigger: byte {
+	COMBO_ON_PRESS,		//!< Once, as soon as the combo is pressed
+	COMBO_ON_HOLD,		//!< Once, after the combo has been held for a while
+	COMBO_REPEAT		//!< As soon as the combo is pressed, then repeatedly while it is held
+};
+
+//! \brief Entry of a combo table
+struct Combo {
+	KeyState keys;			//!< Keys that must all be pressed
+	byte action;			//!< Meaning is up to the callback
+	byte arg;				//!< Meaning is up to the callback
+	ComboTrigger trigger;
+};
+
+/** \brief Table-driven key combo matcher
+ *
+ * Combos are listed in a table in flash. The first entry whose keys are all
+ * pressed is the active combo, so entries that are a superset of others must
+ * come first. Other keys can be pressed at the same time.
+ *
+ * The table is only looked at when the pressed keys change. Between changes,
+ * update() only has some work to do while an #COMBO_ON_HOLD or #COMBO_REPEAT
+ * combo is held.
+ */
+class ComboMatcher {
+public:
+	//! \brief Called with the action and argument of the combo that triggered
+	typedef void (*ComboCallback) (const byte action, const byte arg);
+
+	//! \brief How long #COMBO_ON_HOLD combos must be held (ms)
+	static constexpr word HOLD_MS = 1000;
+
+	//! \brief How long #COMBO_REPEAT combos are held before they start repeating (ms)
+	static constexpr word REPEAT_DELAY_MS = 500;
+
+	//! \brief Interval between repetitions of #COMBO_REPEAT combos (ms)
+	static constexpr word REPEAT_INTERVAL_MS = 150;
+
+	/** \brief Start matching combos
+	 *
+	 * \param[in] table Combo table, in flash
+	 * \param[in] n Number of entries in the table
+	 * \param[in] cb Function called when combos trigger
+	 */
+	void begin (const Combo *table, const byte n, ComboCallback cb);
+
+	//! \brief Feed the keys currently pressed, triggering any combos
+	void update (const KeyState& keys);
+
+private:
+	static constexpr byte NO_COMBO = 0xFF;
+
+	const Combo *table;
+
+	byte tableSize;
+
+	ComboCallback callback;
+
+	//! \brief Keys pressed at the last update
+	KeyState last;
+
+	//! \brief Index of the active combo, #NO_COMBO if there is none
+	byte activeIdx;
+
+	//! \brief Copy of the active combo, so that flash is only read on changes
+	Combo active;
+
+	//! \brief When the active combo was pressed or last repeated
+	unsigned long since;
+
+	//! \brief Times the active combo has triggered, stops counting at 2
+	byte triggers;
+
+	byte match (const KeyState& keys);
+
+	void trigger ();
+};
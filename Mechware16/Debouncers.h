@@ -0,0 +1,316 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file Debouncers.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Debouncing strategies for matrix scanners
+ *
+ * A debouncer is handed every row a #MatrixKeyboardScanner reads and tells
+ * what the row should be taken as. All debouncers have the same methods:
+ * - <tt>void begin (const Matrix& initial, const byte length)</tt>: start from
+ *   a first raw reading of the matrix.
+ * - <tt>void setLength (const byte length)</tt>: change the debounce length,
+ *   in scans. What it means exactly depends on the debouncer.
+ * - <tt>TYPECOLS update (const byte row, const TYPECOLS data)</tt>: feed a raw
+ *   reading of a row, return the debounced row.
+ * - <tt>TYPECOLS getRaw (const byte row) const</tt>: last raw reading of a row.
+ * - <tt>boolean settled ()</tt>: called once all rows have been updated, false
+ *   if the debounced matrix must not be used yet.
+ * - <tt>const BounceStats *getStats (const byte row, const byte col) const</tt>
+ *   and <tt>void resetStats ()</tt>, for those that keep statistics.
+ *
+ * Which one the scanners use is selected with #DEBOUNCER, the host/debench
+ * tool compares them against simulated and recorded bouncing.
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include "config.h"
+#include "Matrix.h"
+#include "KeyboardScanner.h"
+
+//! \brief Methods of debouncers that keep no statistics
+class NoBounceStats {
+public:
+	const BounceStats *getStats (const byte row, const byte col) const {
+		(void) row;
+		(void) col;
+		return NULL;
+	}
+
+	void resetStats () {
+	}
+};
+
+/** \brief Debouncer with a single counter for the whole matrix
+ *
+ * The matrix is used once it has not changed at all for \a length scans. This
+ * is the cheapest strategy, but any key bouncing holds back all the others.
+ */
+template <byte NUMROWS, byte NUMCOLS, typename TYPECOLS>
+class CounterDebouncer: public NoBounceStats {
+public:
+	typedef MatrixBase<NUMROWS, TYPECOLS> Matrix;
+
+	void begin (const Matrix& initial, const byte len) {
+		for (byte row = 0; row < NUMROWS; ++row) {
+			raw[row] = initial[row];
+		}
+		setLength (len);
+
+		// The initial reading must be stable as well
+		count = len;
+	}
+
+	void setLength (const byte len) {
+		length = len;
+	}
+
+	TYPECOLS update (const byte row, const TYPECOLS data) {
+		// If a change was detected, activate debounce counter
+		if (raw[row] != data) {
+			count = length;
+		}
+		raw[row] = data;
+
+		return data;
+	}
+
+	TYPECOLS getRaw (const byte row) const {
+		return raw[row];
+	}
+
+	boolean settled () {
+		boolean ret = true;
+
+		// Count down, but avoid underflow
+		if (count > 1) {
+			--count;
+			ret = false;
+		}
+
+		return ret;
+	}
+
+private:
+	Matrix raw;
+
+	byte length;
+
+	byte count;
+};
+
+/** \brief Base for debouncers with a counter per key
+ *
+ * Only keys whose raw reading differs from their debounced state, or whose
+ * counter is running, are looked at, so an idle keyboard costs next to
+ * nothing. Derived classes provide <tt>step (row, mask, count, pressed)</tt>,
+ * which gets a key whose debounced state is \a pressed and returns true if it
+ * must be flipped, and <tt>idle (count, pressed)</tt>, which returns true if
+ * the key needs not be looked at any longer.
+ */
+template <byte NUMROWS, byte NUMCOLS, typename TYPECOLS, typename DERIVED>
+class PerKeyDebouncerBase: public NoBounceStats {
+public:
+	typedef MatrixBase<NUMROWS, TYPECOLS> Matrix;
+
+	void begin (const Matrix& initial, const byte len) {
+		for (byte row = 0; row < NUMROWS; ++row) {
+			raw[row] = initial[row];
+			stable[row] = initial[row];
+			busy[row] = 0;
+		}
+		memset (counts, 0x00, sizeof (counts));
+		length = len;
+	}
+
+	void setLength (const byte len) {
+		length = len;
+	}
+
+	TYPECOLS update (const byte row, const TYPECOLS data) {
+		raw[row] = data;
+
+		TYPECOLS todo = busy[row] | (stable[row] ^ data);
+		TYPECOLS mask = 1;
+		for (byte col = 0; todo != 0; ++col, todo >>= 1, mask <<= 1) {
+			if (todo & 1) {
+				byte& count = counts[row][col];
+				const boolean pressed = !(stable[row] & mask);
+				DERIVED& self = static_cast<DERIVED&> (*this);
+				if (self.step (row, mask, count, pressed)) {
+					stable[row] ^= mask;
+				}
+
+				if (self.idle (count, !(stable[row] & mask))) {
+					busy[row] &= ~mask;
+				} else {
+					busy[row] |= mask;
+				}
+			}
+		}
+
+		return stable[row];
+	}
+
+	TYPECOLS getRaw (const byte row) const {
+		return raw[row];
+	}
+
+	boolean settled () {
+		return true;
+	}
+
+protected:
+	Matrix raw;
+
+	Matrix stable;
+
+	//! \brief Keys that must be looked at even if they did not change
+	Matrix busy;
+
+	byte counts[NUMROWS][NUMCOLS];
+
+	byte length;
+
+	boolean isRawPressed (const byte row, const TYPECOLS mask) const {
+		return !(raw[row] & mask);
+	}
+};
+
+/** \brief Debouncer with a counter per key
+ *
+ * A key changes state once its raw reading has been different from its state
+ * for \a length scans in a row, so every key waits for itself only. Presses
+ * and releases are both delayed by \a length scans.
+ */
+template <byte NUMROWS, byte NUMCOLS, typename TYPECOLS>
+class PerKeyDebouncer: public PerKeyDebouncerBase<NUMROWS, NUMCOLS, TYPECOLS, PerKeyDebouncer<NUMROWS, NUMCOLS, TYPECOLS> > {
+	typedef PerKeyDebouncerBase<NUMROWS, NUMCOLS, TYPECOLS, PerKeyDebouncer<NUMROWS, NUMCOLS, TYPECOLS> > Base;
+	friend Base;
+
+	boolean step (const byte row, const TYPECOLS mask, byte& count, const boolean pressed) {
+		boolean flip = false;
+		if (this->isRawPressed (row, mask) != pressed) {
+			if (++count >= this->length) {
+				count = 0;
+				flip = true;
+			}
+		} else {
+			// Bounced back
+			count = 0;
+		}
+
+		return flip;
+	}
+
+	boolean idle (const byte count, const boolean pressed) const {
+		(void) pressed;
+		return count == 0;
+	}
+};
+
+/** \brief Debouncer reporting presses right away
+ *
+ * A press is taken as soon as a key reads low. A release needs the key to read
+ * high for \a length scans in a row, after which presses are ignored for
+ * another \a length scans, so that bounces of the release are not taken as a
+ * new press. This gives the lowest press latency, but any glitch on a released
+ * key is a press.
+ */
+template <byte NUMROWS, byte NUMCOLS, typename TYPECOLS>
+class EagerDebouncer: public PerKeyDebouncerBase<NUMROWS, NUMCOLS, TYPECOLS, EagerDebouncer<NUMROWS, NUMCOLS, TYPECOLS> > {
+	typedef PerKeyDebouncerBase<NUMROWS, NUMCOLS, TYPECOLS, EagerDebouncer<NUMROWS, NUMCOLS, TYPECOLS> > Base;
+	friend Base;
+
+	/* Pressed keys count the scans they read released, released ones count
+	 * down the scans left before they can be pressed again
+	 */
+	boolean step (const byte row, const TYPECOLS mask, byte& count, const boolean pressed) {
+		boolean flip = false;
+		const boolean rawPressed = this->isRawPressed (row, mask);
+		if (pressed) {
+			if (!rawPressed) {
+				if (++count >= this->length) {
+					count = this->length;
+					flip = true;
+				}
+			} else {
+				count = 0;
+			}
+		} else if (count > 0) {
+			--count;
+		} else if (rawPressed) {
+			flip = true;
+		}
+
+		return flip;
+	}
+
+	boolean idle (const byte count, const boolean pressed) const {
+		(void) pressed;
+		return count == 0;
+	}
+};
+
+/** \brief Debouncer integrating the readings of each key
+ *
+ * Every key has a counter that goes up on scans it reads pressed and down on
+ * scans it reads released, between 0 and \a length. The key is pressed when
+ * the counter reaches \a length and released when it gets back to 0, so
+ * isolated glitches are filtered out even while a key keeps bouncing.
+ */
+template <byte NUMROWS, byte NUMCOLS, typename TYPECOLS>
+class IntegratorDebouncer: public PerKeyDebouncerBase<NUMROWS, NUMCOLS, TYPECOLS, IntegratorDebouncer<NUMROWS, NUMCOLS, TYPECOLS> > {
+	typedef PerKeyDebouncerBase<NUMROWS, NUMCOLS, TYPECOLS, IntegratorDebouncer<NUMROWS, NUMCOLS, TYPECOLS> > Base;
+	friend Base;
+
+public:
+	void begin (const typename Base::Matrix& initial, const byte len) {
+		Base::begin (initial, len);
+		setLength (len);
+	}
+
+	void setLength (const byte len) {
+		/* Counters of keys in between would not mean the same any longer, so
+		 * put them all at rest
+		 */
+		for (byte row = 0; row < NUMROWS; ++row) {
+			for (byte col = 0; col < NUMCOLS; ++col) {
+				this->counts[row][col] = this->stable[row] & (1 << col) ? 0 : len;
+			}
+			this->busy[row] = this->raw[row] ^ this->stable[row];
+		}
+		this->length = len;
+	}
+
+private:
+	boolean step (const byte row, const TYPECOLS mask, byte& count, const boolean pressed) {
+		boolean flip = false;
+		if (this->isRawPressed (row, mask)) {
+			if (count < this->length) {
+				++count;
+			}
+			flip = !pressed && count >= this->length;
+		} else {
+			if (count > 0) {
+				--count;
+			}
+			flip = pressed && count == 0;
+		}
+
+		return flip;
+	}
+
+	boolean idle (const byte count, const boolean pressed) const {
+		return count == (pressed ? this->length : 0);
+	}
+};
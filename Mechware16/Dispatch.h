@@ -0,0 +1,36 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file Dispatch.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Virtual or static dispatch of scanner, mapper and animation methods
+ *
+ * Scanners, mappers and animations are class hierarchies, but the sketch only
+ * ever calls them through objects of known type (see ActiveScanner in
+ * Mechware16.ino). With #ENABLE_STATIC_DISPATCH their methods are not virtual,
+ * so no vtables are kept in RAM. Code that needs a pointer to the base
+ * classes then no longer works, which is why that is not the default.
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include "config.h"
+
+#ifdef ENABLE_STATIC_DISPATCH
+#define DISPATCH_VIRTUAL
+#define DISPATCH_OVERRIDE
+#else
+//! \brief Use instead of \a virtual for methods of dispatchable classes
+#define DISPATCH_VIRTUAL virtual
+
+//! \brief Use instead of \a override for methods of dispatchable classes
+#define DISPATCH_OVERRIDE override
+#endif
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file EepromWriter.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Non-blocking EEPROM writes
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include <EEPROM.h>
+#include "EepromWriter.h"
+
+#ifndef MECHWARE16_HOST
+// State of the write in progress, shared with the ISR
+static const byte * volatile writeSrc;
+static volatile word writeAddr;
+static volatile byte writeLeft;
+
+
+/* EEPROM Ready ISR, fires as long as it is enabled and no write is in
+ * progress, so we just start writing the next byte every time
+ */
+ISR (EE_READY_vect) {
+	if (writeLeft > 0) {
+		const byte b = *writeSrc;
+		EEAR = writeAddr;
+		EECR |= _BV (EERE);
+		if (EEDR != b) {
+			EEDR = b;
+			EECR |= _BV (EEMPE);
+			EECR |= _BV (EEPE);
+		}
+
+		++writeSrc;
+		++writeAddr;
+		--writeLeft;
+	} else {
+		// All done
+		EECR &= ~_BV (EERIE);
+	}
+}
+
+
+boolean EepromWriter::write (const word addr, const void *src, const byte len) {
+	boolean ret = false;
+
+	if (!busy ()) {
+		writeSrc = reinterpret_cast<const byte *> (src);
+		writeAddr = addr;
+		writeLeft = len;
+
+		EECR |= _BV (EERIE);
+		ret = true;
+	}
+
+	return ret;
+}
+
+boolean EepromWriter::busy () {
+	return (EECR & _BV (EERIE)) != 0;
+}
+#else
+boolean EepromWriter::write (const word addr, const void *src, const byte len) {
+	const byte *p = reinterpret_cast<const byte *> (src);
+	for (byte i = 0; i < len; ++i) {
+		EEPROM.update (addr + i, p[i]);
+	}
+
+	return true;
+}
+
+boolean EepromWriter::busy () {
+	return false;
+}
+#endif
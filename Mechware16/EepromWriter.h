@@ -0,0 +1,47 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file EepromWriter.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Non-blocking EEPROM writes
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+/** \brief Non-blocking EEPROM writes
+ *
+ * Writing is done one byte at a time from the EEPROM Ready interrupt, so the
+ * main loop never waits for the ~3.4 ms each byte takes. Bytes that already
+ * hold the right value are skipped, to save time and wear.
+ *
+ * There is a single write in progress at any time, shared by everything that
+ * writes to EEPROM (#SettingsStore and #KeymapOverrides), so check busy()
+ * before starting one.
+ *
+ * On the host, writes complete right away.
+ */
+class EepromWriter {
+public:
+	/** \brief Start writing a block of data
+	 *
+	 * \param[in] addr EEPROM address to write to
+	 * \param[in] src Data to be written, must stay unchanged until the write
+	 *                is complete
+	 * \param[in] len Number of bytes to write
+	 * \return False if another write is in progress, true otherwise
+	 */
+	static boolean write (const word addr, const void *src, const byte len);
+
+	//! \brief True if a write is in progress
+	static boolean busy ();
+};
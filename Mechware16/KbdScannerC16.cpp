@@ -20,41 +20,85 @@
 #include "KbdScannerC16.h"
 #include "UsbKeyboard.h"
 
-#ifndef ENABLE_EURO_KEY
-constexpr Key POUND_SIGN = A(163);
+#ifndef ENABLE_KEY_LAYERS
+constexpr Key HELP = KEY_F8;
+constexpr Key HELP_SHIFTED = KEY_F7;
 #else
-constexpr Key POUND_SIGN = A(164);
+// F7 and F8 are still available as Fn + 7/8
+constexpr Key HELP = LAYER_MOMENTARY (KeyMapperC16::FNLAYER_FN);
+constexpr Key HELP_SHIFTED = HELP;
+#endif
+
+#ifndef ENABLE_TAP_HOLD
+constexpr Key CMD_POSITIONAL = KEY_LEFT_CTRL;
+constexpr Key CMD_SYMBOLIC = KEY_LEFT_ALT;
+constexpr Key CLEAR = KEY_HOME;
+#else
+constexpr Key CMD_POSITIONAL = DUAL_ROLE (KeyMapperC16::DUALROLE_CMD_CTRL);
+constexpr Key CMD_SYMBOLIC = DUAL_ROLE (KeyMapperC16::DUALROLE_CMD_ALT);
+constexpr Key CLEAR = DUAL_ROLE (KeyMapperC16::DUALROLE_CLEAR);
 #endif
 
 constexpr Key KeyMapperC16::keymapPositional[C16_MATRIX_ROWS][C16_MATRIX_COLS] = {
-	{KEY_BACKSPACE,		KEY_ENTER,			KEY_EQUAL,		KEY_F8,		KEY_F1,		KEY_F2,			KEY_F3,				KEY_LEFT_BRACE},
+	{KEY_BACKSPACE,		KEY_ENTER,			KEY_EQUAL,		HELP,		KEY_F1,		KEY_F2,			KEY_F3,				KEY_LEFT_BRACE},
 	{KEY_3,				KEY_W,				KEY_A,			KEY_4,		KEY_Z,		KEY_S,			KEY_E,				KEY_LEFT_SHIFT},
 	{KEY_5,				KEY_R,				KEY_D,			KEY_6,		KEY_C,		KEY_F,			KEY_T,				KEY_X},
 	{KEY_7,				KEY_Y,				KEY_G,			KEY_8,		KEY_B,		KEY_H,			KEY_U,				KEY_V},
 	{KEY_9,				KEY_I,				KEY_J,			KEY_0,		KEY_M,		KEY_K,			KEY_O,				KEY_N},
 	{KEY_DOWN,			KEY_P,				KEY_L,			KEY_UP,		KEY_PERIOD,	KEY_SEMICOLON,	KEY_MINUS,			KEY_COMMA},
 	{KEY_LEFT,			KEY_BACKSLASH,		KEY_QUOTE,		KEY_RIGHT,	KEY_TILDE,	KEY_INSERT,		KEY_RIGHT_BRACE,	KEY_SLASH},
-	{KEY_1,				KEY_HOME,			KEY_TAB,		KEY_2,		KEY_SPACE,	KEY_LEFT_CTRL,	KEY_Q,				KEY_ESC}
+	{KEY_1,				CLEAR,				KEY_TAB,		KEY_2,		KEY_SPACE,	CMD_POSITIONAL,	KEY_Q,				KEY_ESC}
 };
 
 const Key KeyMapperC16::keymapSymbolic[C16_MATRIX_ROWS][C16_MATRIX_COLS] = {
-	{KEY_BACKSPACE,		KEY_ENTER,			POUND_SIGN,		KEY_F8,		KEY_F1,		KEY_F2,			KEY_F3,				A('@')},
+	{KEY_BACKSPACE,		KEY_ENTER,			POUND_SIGN,		HELP,		KEY_F1,		KEY_F2,			KEY_F3,				A('@')},
 	{A('3'),			A('w'),				A('a'),			A('4'),		A('z'),		A('s'),			A('e'),				KEY_LEFT_SHIFT},
 	{A('5'),			A('r'),				A('d'),			A('6'),		A('c'),		A('f'),			A('t'),				A('x')},
 	{A('7'),			A('y'),				A('g'),			A('8'),		A('b'),		A('h'),			A('u'),				A('v')},
 	{A('9'),			A('i'),				A('j'),			A('0'),		A('m'),		A('k'),			A('o'),				A('n')},
 	{KEY_DOWN,			A('p'),				A('l'),			KEY_UP,		A('.'),		A(':'),			A('-'),				A(',')},
 	{KEY_LEFT,			A('*'),				A(';'),			KEY_RIGHT,	KEY_ESC,	A('='),			A('+'),				A('/')},
-	{A('1'),			KEY_HOME,			KEY_LEFT_CTRL,	A('2'),		A(' '),		KEY_LEFT_ALT,	A('q'),				KEY_TAB}
+	{A('1'),			CLEAR,				KEY_LEFT_CTRL,	A('2'),		A(' '),		CMD_SYMBOLIC,	A('q'),				KEY_TAB}
 };
 
 const Key KeyMapperC16::keymapSymbolicShifted[C16_MATRIX_ROWS][C16_MATRIX_COLS] = {
-	{KEY_INSERT,		KEY_ENTER,			POUND_SIGN,		KEY_F7,		KEY_F4,		KEY_F5,			KEY_F6,				A('@')},
+	{KEY_INSERT,		KEY_ENTER,			POUND_SIGN,		HELP_SHIFTED,	KEY_F4,		KEY_F5,			KEY_F6,				A('@')},
 	{A('#'),			A('W'),				A('A'),			A('$'),		A('Z'),		A('S'),			A('E'),				KEY_LEFT_SHIFT},
 	{A('%'),			A('R'),				A('D'),			A('&'),		A('C'),		A('F'),			A('T'),				A('X')},
 	{A('\''),			A('Y'),				A('G'),			A('('),		A('B'),		A('H'),			A('U'),				A('V')},
 	{A(')'),			A('I'),				A('J'),			A('^'),		A('M'),		A('K'),			A('O'),				A('N')},
 	{KEY_DOWN,			A('P'),				A('L'),			KEY_UP,		A('>'),		A('['),			A('-'),				A('<')},
 	{KEY_LEFT,			A('*'),				A(']'),			KEY_RIGHT,	KEY_ESC,	A('='),			A('+'),				A('?')},
-	{A('!'),			KEY_HOME,			KEY_LEFT_CTRL,	A('\"'),	A(' '),		KEY_LEFT_ALT,	A('Q'),				KEY_TAB}
+	{A('!'),			CLEAR,				KEY_LEFT_CTRL,	A('\"'),	A(' '),		CMD_SYMBOLIC,	A('Q'),				KEY_TAB}
+};
+
+#ifdef ENABLE_KEY_LAYERS
+#define ___ KEY_TRANSPARENT
+
+constexpr KeyMapperC16::LayerTable KeyMapperC16::layersFn[KeyMapperC16::N_FNLAYERS] = {
+	// FNLAYER_FN
+	{
+		{KEY_DELETE,		___,				___,			___,		KEY_F11,	KEY_F12,		KEY_PRINT,			___},
+		{KEY_F3,			___,				___,			KEY_F4,		___,		___,			___,				___},
+		{KEY_F5,			___,				___,			KEY_F6,		___,		___,			___,				___},
+		{KEY_F7,			___,				___,			KEY_F8,		___,		___,			___,				___},
+		{KEY_F9,			___,				___,			KEY_F10,	___,		___,			___,				___},
+		{KEY_PAGE_DOWN,		___,				___,			KEY_PAGE_UP,	___,		___,			___,				___},
+		{KEY_HOME,			___,				___,			KEY_END,	___,		___,			___,				___},
+		{KEY_F1,			LAYER_TOGGLE (FNLAYER_FN),	___,	KEY_F2,		___,		___,			___,				KEY_PAUSE}
+	}
 };
+
+#undef ___
+#endif
+
+#ifdef ENABLE_TAP_HOLD
+constexpr DualRoleKey KeyMapperC16::dualRoleKeys[KeyMapperC16::N_DUALROLES] = {
+	// DUALROLE_CMD_CTRL
+	{KEY_LEFT_GUI,		KEY_LEFT_CTRL,		TAPHOLD_INTERRUPT},
+	// DUALROLE_CMD_ALT
+	{KEY_LEFT_GUI,		KEY_LEFT_ALT,		TAPHOLD_INTERRUPT},
+	// DUALROLE_CLEAR
+	{KEY_HOME,			KEY_RIGHT_ALT,		TAPHOLD_INTERRUPT}
+};
+#endif
@@ -24,7 +24,7 @@
 class KbdScannerC16: public MatrixKeyboardScanner<C16_MATRIX_ROWS, C16_MATRIX_COLS, byte, DEBOUNCE_FACTOR_C16, KeyMapperC16> {
 public:
 
-	virtual void updateLeds (const boolean capsLock, const boolean numLock, const boolean scrollLock) override {
+	DISPATCH_VIRTUAL void updateLeds (const boolean capsLock, const boolean numLock, const boolean scrollLock) DISPATCH_OVERRIDE {
 		// Update caps lock led status
 		//~ fastDigitalWrite (LED_PIN, capsLock || numLock || scrollLock);
 	}
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file KbdScannerC64.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Commodore 64 Keyboard Scanner
+ * \ingroup KeyboardScanners
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include <Arduino.h>
+#include "config.h"
+#include "KbdScannerC64.h"
+#include "UsbKeyboard.h"
+
+constexpr Key C64Layout::keymapPositional[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] = {
+	{KEY_BACKSPACE,		KEY_ENTER,			KEY_RIGHT,		KEY_F7,		KEY_F1,		KEY_F3,			KEY_F5,				KEY_DOWN},
+	{KEY_3,				KEY_W,				KEY_A,			KEY_4,		KEY_Z,		KEY_S,			KEY_E,				KEY_LEFT_SHIFT},
+	{KEY_5,				KEY_R,				KEY_D,			KEY_6,		KEY_C,		KEY_F,			KEY_T,				KEY_X},
+	{KEY_7,				KEY_Y,				KEY_G,			KEY_8,		KEY_B,		KEY_H,			KEY_U,				KEY_V},
+	{KEY_9,				KEY_I,				KEY_J,			KEY_0,		KEY_M,		KEY_K,			KEY_O,				KEY_N},
+	{KEY_MINUS,			KEY_P,				KEY_L,			KEY_EQUAL,	KEY_PERIOD,	KEY_SEMICOLON,	KEY_LEFT_BRACE,		KEY_COMMA},
+	{KEY_INSERT,		KEY_RIGHT_BRACE,	KEY_QUOTE,		KEY_HOME,	KEY_RIGHT_SHIFT,	KEY_NON_US_NUM,	KEY_BACKSLASH,	KEY_SLASH},
+	{KEY_1,				KEY_TILDE,			KEY_TAB,		KEY_2,		KEY_SPACE,	KEY_LEFT_CTRL,	KEY_Q,				KEY_ESC}
+};
+
+constexpr Key C64Layout::keymapSymbolic[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] = {
+	{KEY_BACKSPACE,		KEY_ENTER,			KEY_RIGHT,		KEY_F7,		KEY_F1,		KEY_F3,			KEY_F5,				KEY_DOWN},
+	{A('3'),			A('w'),				A('a'),			A('4'),		A('z'),		A('s'),			A('e'),				KEY_LEFT_SHIFT},
+	{A('5'),			A('r'),				A('d'),			A('6'),		A('c'),		A('f'),			A('t'),				A('x')},
+	{A('7'),			A('y'),				A('g'),			A('8'),		A('b'),		A('h'),			A('u'),				A('v')},
+	{A('9'),			A('i'),				A('j'),			A('0'),		A('m'),		A('k'),			A('o'),				A('n')},
+	{A('+'),			A('p'),				A('l'),			A('-'),		A('.'),		A(':'),			A('@'),				A(',')},
+	{POUND_SIGN,		A('*'),				A(';'),			KEY_HOME,	KEY_RIGHT_SHIFT,	A('='),		A('^'),				A('/')},
+	{A('1'),			A('_'),				KEY_LEFT_CTRL,	A('2'),		A(' '),		KEY_LEFT_ALT,	A('q'),				KEY_ESC}
+};
+
+constexpr Key C64Layout::keymapSymbolicShifted[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] = {
+	{KEY_INSERT,		KEY_ENTER,			KEY_LEFT,		KEY_F8,		KEY_F2,		KEY_F4,			KEY_F6,				KEY_UP},
+	{A('#'),			A('W'),				A('A'),			A('$'),		A('Z'),		A('S'),			A('E'),				KEY_LEFT_SHIFT},
+	{A('%'),			A('R'),				A('D'),			A('&'),		A('C'),		A('F'),			A('T'),				A('X')},
+	{A('\''),			A('Y'),				A('G'),			A('('),		A('B'),		A('H'),			A('U'),				A('V')},
+	{A(')'),			A('I'),				A('J'),			A('0'),		A('M'),		A('K'),			A('O'),				A('N')},
+	{A('+'),			A('P'),				A('L'),			A('-'),		A('>'),		A('['),			A('@'),				A('<')},
+	{POUND_SIGN,		A('*'),				A(']'),			KEY_HOME,	KEY_RIGHT_SHIFT,	A('='),		A('^'),				A('?')},
+	{A('!'),			A('_'),				KEY_LEFT_CTRL,	A('\"'),	A(' '),		KEY_LEFT_ALT,	A('Q'),				KEY_ESC}
+};
+
+/* Positional, plus: number keys, + and - give F1-F12, F1/F3/F5/F7 give
+ * F2/F4/F6/F8, the cursor keys give Page Down and End, the up arrow gives Page
+ * Up, DEL gives Delete, RUN/STOP gives Pause and C= gives the GUI key
+ */
+constexpr Key C64Layout::keymapRestore[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] = {
+	{KEY_DELETE,		KEY_ENTER,			KEY_END,		KEY_F8,		KEY_F2,		KEY_F4,			KEY_F6,				KEY_PAGE_DOWN},
+	{KEY_F3,			KEY_W,				KEY_A,			KEY_F4,		KEY_Z,		KEY_S,			KEY_E,				KEY_LEFT_SHIFT},
+	{KEY_F5,			KEY_R,				KEY_D,			KEY_F6,		KEY_C,		KEY_F,			KEY_T,				KEY_X},
+	{KEY_F7,			KEY_Y,				KEY_G,			KEY_F8,		KEY_B,		KEY_H,			KEY_U,				KEY_V},
+	{KEY_F9,			KEY_I,				KEY_J,			KEY_F10,	KEY_M,		KEY_K,			KEY_O,				KEY_N},
+	{KEY_F11,			KEY_P,				KEY_L,			KEY_F12,	KEY_PERIOD,	KEY_SEMICOLON,	KEY_LEFT_BRACE,		KEY_COMMA},
+	{KEY_INSERT,		KEY_RIGHT_BRACE,	KEY_QUOTE,		KEY_HOME,	KEY_RIGHT_SHIFT,	KEY_NON_US_NUM,	KEY_PAGE_UP,	KEY_SLASH},
+	{KEY_F1,			KEY_TILDE,			KEY_TAB,		KEY_F2,		KEY_SPACE,	KEY_LEFT_GUI,	KEY_Q,				KEY_PAUSE}
+};
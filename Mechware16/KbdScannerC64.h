@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file KbdScannerC64.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Commodore 64 Keyboard Scanner
+ * \ingroup KeyboardScanners
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include "KbdScannerCbm.h"
+
+/** \brief Commodore 64 keyboard, see #KeyMapperCbm
+ *
+ * Rows are the lines the C64 drives through port A of CIA 1, columns are the
+ * ones it reads through port B, in the same order, so that the matrix is the
+ * one found in the Programmer's Reference Guide.
+ */
+struct C64Layout {
+	static constexpr byte LSHIFT_ROW = 1;
+	static constexpr byte LSHIFT_COL = 7;
+	static constexpr byte RSHIFT_ROW = 6;
+	static constexpr byte RSHIFT_COL = 4;
+	static constexpr byte CBM_ROW = 7;
+	static constexpr byte CBM_COL = 5;
+
+	//! \brief INST and the cursor keys
+	static constexpr KeyState unshifted () {
+		return KeyState::at (0, 0) | KeyState::at (0, 2) | KeyState::at (0, 7);
+	}
+
+	static const Key keymapPositional[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] PROGMEM;
+
+	static const Key keymapSymbolic[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] PROGMEM;
+
+	static const Key keymapSymbolicShifted[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] PROGMEM;
+
+	static const Key keymapRestore[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] PROGMEM;
+};
+
+typedef KeyMapperCbm<C64Layout> KeyMapperC64;
+
+//! \brief C64 keyboard scanner
+typedef KbdScannerCbm<C64Layout> KbdScannerC64;
@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file KbdScannerCbm.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Commodore 64/VIC-20 Keyboard Scanner
+ * \ingroup KeyboardScanners
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include "KeyMapperCbm.h"
+#include "MatrixKeyboardScanner.h"
+
+/** \brief Scanner for C64-style keyboards
+ *
+ * The matrix is scanned like any other, RESTORE is read separately and handed
+ * to the mapper once it has been stable for #DEBOUNCE_FACTOR_C64 samples.
+ *
+ * \tparam LAYOUT Description of the keyboard, see #KeyMapperCbm
+ */
+template <typename LAYOUT>
+class KbdScannerCbm: public MatrixKeyboardScanner<CBM_MATRIX_ROWS, CBM_MATRIX_COLS, byte, DEBOUNCE_FACTOR_C64, KeyMapperCbm<LAYOUT> > {
+private:
+	typedef MatrixKeyboardScanner<CBM_MATRIX_ROWS, CBM_MATRIX_COLS, byte, DEBOUNCE_FACTOR_C64, KeyMapperCbm<LAYOUT> > Base;
+
+	RestorePort restorePort;
+
+	//! \brief Last RESTORE reading
+	boolean restoreRaw = false;
+
+	//! \brief Samples left before RESTORE is considered stable
+	byte restoreDebounce = 0;
+
+	void sampleRestore () {
+		const boolean pressed = restorePort.read ();
+		if (pressed != restoreRaw) {
+#ifdef ENABLE_MATRIX_TRACE
+			matrixTrace.restore (pressed);
+#endif
+			restoreRaw = pressed;
+			restoreDebounce = DEBOUNCE_FACTOR_C64;
+		} else if (restoreDebounce > 0 && --restoreDebounce == 0) {
+			this->mapper.setRestore (pressed);
+		}
+	}
+
+public:
+	DISPATCH_VIRTUAL boolean begin () DISPATCH_OVERRIDE {
+		restorePort.begin ();
+		return Base::begin ();
+	}
+
+	DISPATCH_VIRTUAL void loop () DISPATCH_OVERRIDE {
+		Base::loop ();
+		sampleRestore ();
+	}
+
+	DISPATCH_VIRTUAL KeyboardScanner::ScanStatus scan (KeyBuffer& buf) DISPATCH_OVERRIDE {
+		sampleRestore ();
+		return Base::scan (buf);
+	}
+};
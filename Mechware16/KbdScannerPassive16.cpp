@@ -19,6 +19,8 @@
 #include "CircularBuffer.h"
 #include "UsbKeyboard.h"
 #include "Log.h"
+#include "LatencyStats.h"
+#include "MatrixTrace.h"
 
 struct KeyMatrixSample {
 	byte rows;			// If this is made a uint8_t we save 6 bytes, how come?!?
@@ -58,6 +60,17 @@ void KbdScannerPassive16::clearMatrix () {
 	}
 }
 
+#ifdef ENABLE_MATRIX_TRACE
+boolean KbdScannerPassive16::isMatrixClear () const {
+	byte all = 0xFF;
+	for (byte row = 0; row < C16_MATRIX_ROWS; ++row) {
+		all &= matrix[row];
+	}
+
+	return all == 0xFF;
+}
+#endif
+
 boolean KbdScannerPassive16::begin () {
 	clearMatrix ();
 	inPort.begin ();
@@ -95,16 +108,36 @@ void KbdScannerPassive16::loop () {
 		 * out exactly which one, otherwise it takes no further action and just terminates the scan there.
 		 */
 		if (sample.rows == 0x00 && sample.cols == 0xFF) {
+#ifdef ENABLE_MATRIX_TRACE
+			if (!isMatrixClear ()) {
+				matrixTrace.sample (sample.rows, sample.cols);
+			}
+#endif
 			// All keys released
 			clearMatrix ();
 		} else if (countSetBits (sample.rows) == 7) {
 			// Exactly one row is cleared, find out which one and update all its columns
 			for (byte row = 0; row < C16_MATRIX_ROWS; ++row) {
 				if ((sample.rows & (1 << row)) == 0) {
+#ifdef ENABLE_LATENCY_STATS
+					if (matrix[row] & ~sample.cols) {
+						latencyStats.mark (LATSTAGE_DETECTED);
+					}
+#endif
+#ifdef ENABLE_MATRIX_TRACE
+					if (matrix[row] != sample.cols) {
+						matrixTrace.sample (sample.rows, sample.cols);
+					}
+#endif
 					matrix[row] = sample.cols;
 					break;		// There is necessarily only one row at 0
 				}
 			}
+#ifdef ENABLE_MATRIX_TRACE
+		} else if (sample.rows != 0x00) {
+			// Not the quick test, so something weird is going on
+			matrixTrace.sample (sample.rows, sample.cols);
+#endif
 		}
 	}
 }
@@ -112,7 +145,14 @@ void KbdScannerPassive16::loop () {
 KeyboardScanner::ScanStatus KbdScannerPassive16::scan (KeyBuffer& buf) {
 	ScanStatus scanStatus = matrixSamples.available () ? SCAN_IN_PROGRESS : SCAN_COMPLETE;
 	if (scanStatus == SCAN_COMPLETE) {
+#ifdef ENABLE_LATENCY_STATS
+		// There's no debouncing, readings are as settled as they will ever be
+		latencyStats.mark (LATSTAGE_SETTLED);
+#endif
 		mapper.map (matrix, buf);
+#ifdef ENABLE_LATENCY_STATS
+		latencyStats.mark (LATSTAGE_BUFFERED);
+#endif
 	}
 
 	return scanStatus;
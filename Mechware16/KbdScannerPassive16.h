@@ -56,13 +56,22 @@ private:
 	 * All matrix points are marked as released.
 	 */
 	void clearMatrix () ;
+
+#ifdef ENABLE_MATRIX_TRACE
+	//! \brief True if all matrix points are released
+	boolean isMatrixClear () const;
+#endif
 	
 public:
-	virtual boolean begin () override;
-	virtual boolean end () override;
+	DISPATCH_VIRTUAL boolean begin () DISPATCH_OVERRIDE;
+	DISPATCH_VIRTUAL boolean end () DISPATCH_OVERRIDE;
 	
-	virtual void loop () override;
+	DISPATCH_VIRTUAL void loop () DISPATCH_OVERRIDE;
+
+	DISPATCH_VIRTUAL void setKeyMapMode (const KeyMapMode mode) DISPATCH_OVERRIDE {
+		mapper.setMode (mode);
+	}
 	
-	virtual KeyboardScanner::ScanStatus scan (KeyBuffer& buf) override;
+	DISPATCH_VIRTUAL KeyboardScanner::ScanStatus scan (KeyBuffer& buf) DISPATCH_OVERRIDE;
 };
 
@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file KbdScannerVic20.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Commodore VIC-20 Keyboard Scanner
+ * \ingroup KeyboardScanners
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include <Arduino.h>
+#include "config.h"
+#include "KbdScannerVic20.h"
+#include "UsbKeyboard.h"
+
+// Same keys as the C64 keymaps, only at different positions
+
+constexpr Key Vic20Layout::keymapPositional[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] = {
+	{KEY_1,				KEY_3,				KEY_5,			KEY_7,		KEY_9,		KEY_MINUS,		KEY_INSERT,			KEY_BACKSPACE},
+	{KEY_TILDE,			KEY_W,				KEY_R,			KEY_Y,		KEY_I,		KEY_P,			KEY_RIGHT_BRACE,	KEY_ENTER},
+	{KEY_TAB,			KEY_A,				KEY_D,			KEY_G,		KEY_J,		KEY_L,			KEY_QUOTE,			KEY_RIGHT},
+	{KEY_ESC,			KEY_LEFT_SHIFT,		KEY_X,			KEY_V,		KEY_N,		KEY_COMMA,		KEY_SLASH,			KEY_DOWN},
+	{KEY_SPACE,			KEY_Z,				KEY_C,			KEY_B,		KEY_M,		KEY_PERIOD,		KEY_RIGHT_SHIFT,	KEY_F1},
+	{KEY_LEFT_CTRL,		KEY_S,				KEY_F,			KEY_H,		KEY_K,		KEY_SEMICOLON,	KEY_NON_US_NUM,		KEY_F3},
+	{KEY_Q,				KEY_E,				KEY_T,			KEY_U,		KEY_O,		KEY_LEFT_BRACE,	KEY_BACKSLASH,		KEY_F5},
+	{KEY_2,				KEY_4,				KEY_6,			KEY_8,		KEY_0,		KEY_EQUAL,		KEY_HOME,			KEY_F7}
+};
+
+constexpr Key Vic20Layout::keymapSymbolic[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] = {
+	{A('1'),			A('3'),				A('5'),			A('7'),		A('9'),		A('+'),			POUND_SIGN,			KEY_BACKSPACE},
+	{A('_'),			A('w'),				A('r'),			A('y'),		A('i'),		A('p'),			A('*'),				KEY_ENTER},
+	{KEY_LEFT_CTRL,		A('a'),				A('d'),			A('g'),		A('j'),		A('l'),			A(';'),				KEY_RIGHT},
+	{KEY_ESC,			KEY_LEFT_SHIFT,		A('x'),			A('v'),		A('n'),		A(','),			A('/'),				KEY_DOWN},
+	{A(' '),			A('z'),				A('c'),			A('b'),		A('m'),		A('.'),			KEY_RIGHT_SHIFT,	KEY_F1},
+	{KEY_LEFT_ALT,		A('s'),				A('f'),			A('h'),		A('k'),		A(':'),			A('='),				KEY_F3},
+	{A('q'),			A('e'),				A('t'),			A('u'),		A('o'),		A('@'),			A('^'),				KEY_F5},
+	{A('2'),			A('4'),				A('6'),			A('8'),		A('0'),		A('-'),			KEY_HOME,			KEY_F7}
+};
+
+constexpr Key Vic20Layout::keymapSymbolicShifted[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] = {
+	{A('!'),			A('#'),				A('%'),			A('\''),	A(')'),		A('+'),			POUND_SIGN,			KEY_INSERT},
+	{A('_'),			A('W'),				A('R'),			A('Y'),		A('I'),		A('P'),			A('*'),				KEY_ENTER},
+	{KEY_LEFT_CTRL,		A('A'),				A('D'),			A('G'),		A('J'),		A('L'),			A(']'),				KEY_LEFT},
+	{KEY_ESC,			KEY_LEFT_SHIFT,		A('X'),			A('V'),		A('N'),		A('<'),			A('?'),				KEY_UP},
+	{A(' '),			A('Z'),				A('C'),			A('B'),		A('M'),		A('>'),			KEY_RIGHT_SHIFT,	KEY_F2},
+	{KEY_LEFT_ALT,		A('S'),				A('F'),			A('H'),		A('K'),		A('['),			A('='),				KEY_F4},
+	{A('Q'),			A('E'),				A('T'),			A('U'),		A('O'),		A('@'),			A('^'),				KEY_F6},
+	{A('\"'),			A('$'),				A('&'),			A('('),		A('0'),		A('-'),			KEY_HOME,			KEY_F8}
+};
+
+constexpr Key Vic20Layout::keymapRestore[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] = {
+	{KEY_F1,			KEY_F3,				KEY_F5,			KEY_F7,		KEY_F9,		KEY_F11,		KEY_INSERT,			KEY_DELETE},
+	{KEY_TILDE,			KEY_W,				KEY_R,			KEY_Y,		KEY_I,		KEY_P,			KEY_RIGHT_BRACE,	KEY_ENTER},
+	{KEY_TAB,			KEY_A,				KEY_D,			KEY_G,		KEY_J,		KEY_L,			KEY_QUOTE,			KEY_END},
+	{KEY_PAUSE,			KEY_LEFT_SHIFT,		KEY_X,			KEY_V,		KEY_N,		KEY_COMMA,		KEY_SLASH,			KEY_PAGE_DOWN},
+	{KEY_SPACE,			KEY_Z,				KEY_C,			KEY_B,		KEY_M,		KEY_PERIOD,		KEY_RIGHT_SHIFT,	KEY_F2},
+	{KEY_LEFT_GUI,		KEY_S,				KEY_F,			KEY_H,		KEY_K,		KEY_SEMICOLON,	KEY_NON_US_NUM,		KEY_F4},
+	{KEY_Q,				KEY_E,				KEY_T,			KEY_U,		KEY_O,		KEY_LEFT_BRACE,	KEY_PAGE_UP,		KEY_F6},
+	{KEY_F2,			KEY_F4,				KEY_F6,			KEY_F8,		KEY_F10,	KEY_F12,		KEY_HOME,			KEY_F8}
+};
@@ -0,0 +1,54 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file KbdScannerVic20.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Commodore VIC-20 Keyboard Scanner
+ * \ingroup KeyboardScanners
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include "KbdScannerCbm.h"
+
+/** \brief Commodore VIC-20 keyboard, see #KeyMapperCbm
+ *
+ * The keyboard itself is the same as the one of the C64, but the VIC-20 wires
+ * it differently. Rows are the lines the VIC-20 drives through port B of VIA 2,
+ * columns are the ones it reads through port A, in the same order, so that the
+ * matrix is the one the KERNAL uses.
+ */
+struct Vic20Layout {
+	static constexpr byte LSHIFT_ROW = 3;
+	static constexpr byte LSHIFT_COL = 1;
+	static constexpr byte RSHIFT_ROW = 4;
+	static constexpr byte RSHIFT_COL = 6;
+	static constexpr byte CBM_ROW = 5;
+	static constexpr byte CBM_COL = 0;
+
+	//! \brief INST and the cursor keys
+	static constexpr KeyState unshifted () {
+		return KeyState::at (0, 7) | KeyState::at (2, 7) | KeyState::at (3, 7);
+	}
+
+	static const Key keymapPositional[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] PROGMEM;
+
+	static const Key keymapSymbolic[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] PROGMEM;
+
+	static const Key keymapSymbolicShifted[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] PROGMEM;
+
+	static const Key keymapRestore[CBM_MATRIX_ROWS][CBM_MATRIX_COLS] PROGMEM;
+};
+
+typedef KeyMapperCbm<Vic20Layout> KeyMapperVic20;
+
+//! \brief VIC-20 keyboard scanner
+typedef KbdScannerCbm<Vic20Layout> KbdScannerVic20;
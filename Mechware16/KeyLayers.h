@@ -0,0 +1,420 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file KeyLayers.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Fn layers on top of a keymap
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+#include "KeyboardScanner.h"
+#include "KeymapOverrides.h"
+#include "KeyState.h"
+#ifdef ENABLE_TAP_HOLD
+#include "TapHold.h"
+#endif
+
+/** \name Layer keys
+ *
+ * Keys that switch layers rather than producing a keypress. They live in the
+ * part of the #Key space that neither USB keycodes nor ASCII keys use: bit 14
+ * is set, bits 8-10 tell what the key does and bits 0-2 which layer it works
+ * on. Dual-role keys use bits 0-7 for their entry in the dual-role key table.
+ */
+//! @{
+const uint16_t MASK_LAYERKEY = (uint16_t) (1U << 14);
+
+enum LayerOp: byte {
+	LAYEROP_TRANSPARENT,	//!< Not a layer key, see #KEY_TRANSPARENT
+	LAYEROP_MOMENTARY,		//!< Layer is active while the key is held
+	LAYEROP_TOGGLE,			//!< Every press switches the layer on or off
+	LAYEROP_ONESHOT,		//!< Layer is active until the next key is released
+	LAYEROP_DUALROLE		//!< Does something else when tapped and held, see #TapHold
+};
+
+#define LAYERKEY(op, n) ((MASK_LAYERKEY) | ((op) << 8) | (n))
+#define LAYER_MOMENTARY(n) LAYERKEY (LAYEROP_MOMENTARY, n)
+#define LAYER_TOGGLE(n) LAYERKEY (LAYEROP_TOGGLE, n)
+#define LAYER_ONESHOT(n) LAYERKEY (LAYEROP_ONESHOT, n)
+#define DUAL_ROLE(n) LAYERKEY (LAYEROP_DUALROLE, n)
+
+//! \brief Use the key of the layers below
+#define KEY_TRANSPARENT LAYERKEY (LAYEROP_TRANSPARENT, 0)
+
+#define KEYPRESS_IS_LAYER(k) (((k) & 0xC000) == MASK_LAYERKEY)
+#define LAYER_OP_EXTRACT(k) static_cast<LayerOp> (((k) >> 8) & 0x07)
+#define LAYER_EXTRACT(k) static_cast<byte> ((k) & 0x07)
+#define DUALROLE_EXTRACT(k) static_cast<byte> ((k) & 0xFF)
+//! @}
+
+/** \brief Fn layers on top of a keymap
+ *
+ * Layers are keymaps that are stacked over the base keymap of the mapper while
+ * they are active. Positions that are #KEY_TRANSPARENT in a layer take their
+ * key from the layers below, down to the base keymap.
+ *
+ * Working out the key of a position through the stack every time it is pressed
+ * would take one flash read per active layer. Instead, whenever the active
+ * layers (or the base keymap) change, every position is resolved once and the
+ * table it gets its key from is remembered, so looking a key up always takes a
+ * single flash read, however many layers are active. Layers only change when a
+ * layer key is pressed or released, so this is a rare event.
+ *
+ * Layer keys must be #KEY_TRANSPARENT in the layers they activate, or their
+ * position will produce a different key as soon as the layer is on.
+ *
+ * Keymap overrides apply to layers too: layer N is looked up in
+ * #KeymapOverrides as the layer number given to setLayers() plus N.
+ *
+ * With #ENABLE_TAP_HOLD, the dual-role keys found in the keymaps are handed
+ * over to a #TapHold. Those decided to be holds of a layer key work like that
+ * layer key.
+ */
+template <byte NUMROWS, byte NUMCOLS>
+class KeyLayers {
+public:
+	static_assert (NUMROWS <= KeyState::ROWS && NUMCOLS <= KeyState::COLS, "Matrix is too large for layers");
+
+	//! \brief Maximum number of layers
+	static constexpr byte MAX_LAYERS = 8;
+
+	//! \brief A layer, same layout as keymaps
+	typedef Key Table[NUMROWS][NUMCOLS];
+
+	/** \brief Set the layers that can be activated
+	 *
+	 * \param[in] _tables Layers, lowest first
+	 * \param[in] n Number of layers
+	 * \param[in] _overrideLayer Number identifying the first layer in
+	 *                           #KeymapOverrides
+	 */
+	void setLayers (const Table *_tables, const byte n, const byte _overrideLayer) {
+		tables = _tables;
+		nTables = n < MAX_LAYERS ? n : MAX_LAYERS;
+		overrideLayer = _overrideLayer;
+		resolve ();
+	}
+
+#ifdef ENABLE_TAP_HOLD
+	/** \brief Set the dual-role keys used by #DUAL_ROLE keys
+	 *
+	 * \param[in] table Dual-role keys, in flash
+	 * \param[in] n Number of entries in the table
+	 */
+	void setDualRoleKeys (const DualRoleKey *table, const byte n) {
+		dualRoles = table;
+		nDualRoles = n;
+	}
+#endif
+
+	/** \brief Set the base keymap
+	 *
+	 * \param[in] _base Base keymap
+	 * \param[in] _baseOverrideLayer Number identifying \a _base in
+	 *                               #KeymapOverrides
+	 */
+	void setBase (const Key (*_base)[NUMCOLS], const byte _baseOverrideLayer) {
+		if (_base != base || _baseOverrideLayer != baseOverrideLayer) {
+			base = _base;
+			baseOverrideLayer = _baseOverrideLayer;
+			resolve ();
+		}
+	}
+
+	/** \brief Handle layer keys
+	 *
+	 * Must be called with every new matrix, before looking keys up.
+	 *
+	 * \param[in] pressed All keys that are pressed
+	 */
+	void update (const KeyState& pressed) {
+		if (keymapOverrides.getSequence () != overridesSeq) {
+			// Overrides might have added or removed layer keys
+			resolve ();
+		}
+
+#ifdef ENABLE_TAP_HOLD
+		const word now = millis ();
+		const KeyState dualPresses = pressed & dualRoleKeys & ~last;
+		if (!dualPresses.empty ()) {
+			for (byte row = 0; row < NUMROWS; ++row) {
+				for (byte col = 0; col < NUMCOLS; ++col) {
+					if (dualPresses.isPressed (row, col)) {
+						const DualRoleKey drk = getDualRole (lookup (row, col));
+						tapHold.press (row, col, drk.resolution, now);
+					}
+				}
+			}
+		}
+		tapHold.update (pressed, dualRoleKeys, now);
+#endif
+
+		/* Turning a layer on can reveal more layer keys under the keys that
+		 * are already pressed, so go on until things settle
+		 */
+		byte n = 0;
+		while (handleLayerKeys (pressed) && ++n < MAX_LAYERS)
+			;
+
+		if (oneShot) {
+			/* Keep the layer until all the keys pressed while it was on have
+			 * been released, so they don't change under the user's fingers
+			 */
+			oneShotKeys |= pressed & ~last & ~layerKeys;
+			if (!oneShotKeys.empty () && !pressed.any (oneShotKeys)) {
+				oneShot = 0;
+				oneShotKeys.clear ();
+				activate ();
+			}
+		}
+		last = pressed;
+	}
+
+	/** \brief Get the key to be reported for a pressed position
+	 *
+	 * \param[in] row Matrix row
+	 * \param[in] col Matrix column
+	 * \param[out] key Key to be reported
+	 * \return False if nothing must be reported, as for layer keys
+	 */
+	boolean map (const byte row, const byte col, Key& key) const {
+		boolean ret = !layerKeys.isPressed (row, col);
+		if (ret) {
+			key = lookup (row, col);
+#ifdef ENABLE_TAP_HOLD
+			ret = !tapHold.isHeldBack (row, col);
+		} else if (tapHold.isHolding (row, col)) {
+			key = getDualRole (lookup (row, col)).hold;
+			ret = !KEYPRESS_IS_LAYER (key);
+#endif
+		}
+
+		return ret;
+	}
+
+#ifdef ENABLE_TAP_HOLD
+	/** \brief Add the keys that must be reported for this scan only
+	 *
+	 * See TapHold::getTapped().
+	 *
+	 * \param[out] kbuf Where to add them
+	 */
+	void appendTapped (KeyBuffer& kbuf) const {
+		const KeyState& tapped = tapHold.getTapped ();
+		for (byte row = 0; !tapped.empty () && row < NUMROWS; ++row) {
+			for (byte col = 0; col < NUMCOLS; ++col) {
+				if (tapped.isPressed (row, col)) {
+					Key key = lookup (row, col);
+					if (dualRoleKeys.isPressed (row, col)) {
+						key = getDualRole (key).tap;
+					}
+
+					if (key != 0 && !KEYPRESS_IS_LAYER (key)) {
+						KeyEvent evt {
+							.key = key,
+							.row = row,
+							.col = col
+						};
+						if (!kbuf.append (evt)) {
+							Log.error (LOG_STR ("Cannot report tapped key\n"));
+						}
+					}
+				}
+			}
+		}
+	}
+#endif
+
+	//! \brief Key of a position, according to the active layers
+	Key lookup (const byte row, const byte col) const {
+		const byte src = source[row][col];
+
+		Key key;
+		if (src == 0) {
+			if (!keymapOverrides.lookup (baseOverrideLayer, row, col, key)) {
+				key = read (&base[row][col]);
+			}
+		} else if (!keymapOverrides.lookup (overrideLayer + src - 1, row, col, key)) {
+			key = read (&tables[src - 1][row][col]);
+		}
+
+		return key;
+	}
+
+	//! \brief Active layers, bit N is layer N
+	byte getActive () const {
+		return active;
+	}
+
+private:
+	const Key (*base)[NUMCOLS] = nullptr;
+
+	byte baseOverrideLayer = 0;
+
+	const Table *tables = nullptr;
+
+	byte nTables = 0;
+
+	byte overrideLayer = 0;
+
+	//! \brief Where each position gets its key from: 0 is the base keymap, N is layer N - 1
+	byte source[NUMROWS][NUMCOLS] = {};
+
+	//! \brief Positions that hold layer keys with the current #source
+	KeyState layerKeys;
+
+	//! \brief Layer keys held at the last update()
+	KeyState lastHeld;
+
+	//! \brief Keys pressed at the last update()
+	KeyState last;
+
+	//! \brief Keys pressed while a one-shot layer was on
+	KeyState oneShotKeys;
+
+#ifdef ENABLE_TAP_HOLD
+	const DualRoleKey *dualRoles = nullptr;
+
+	byte nDualRoles = 0;
+
+	//! \brief Positions that hold dual-role keys with the current #source
+	KeyState dualRoleKeys;
+
+	TapHold tapHold;
+#endif
+
+	byte momentary = 0;
+
+	byte toggled = 0;
+
+	byte oneShot = 0;
+
+	byte active = 0;
+
+	//! \brief Sequence number of the #KeymapOverrides #source was worked out with
+	byte overridesSeq = 0;
+
+	static Key read (const Key *k) {
+#ifdef KEYMAPS_IN_FLASH
+		return pgm_read_word (k);
+#else
+		return *k;
+#endif
+	}
+
+#ifdef ENABLE_TAP_HOLD
+	//! \brief Dual-role key a #DUAL_ROLE key refers to
+	DualRoleKey getDualRole (const Key key) const {
+		DualRoleKey drk {0, 0, TAPHOLD_TERM};
+		const byte n = DUALROLE_EXTRACT (key);
+		if (n < nDualRoles) {
+			memcpy_P (&drk, &dualRoles[n], sizeof (drk));
+		}
+
+		return drk;
+	}
+#endif
+
+	/** \brief Update the active layers according to the layer keys held
+	 *
+	 * \return True if the active layers changed
+	 */
+	boolean handleLayerKeys (const KeyState& pressed) {
+#ifdef ENABLE_TAP_HOLD
+		// Dual-role keys only count as layer keys once they are holds
+		const KeyState held = (pressed & layerKeys & ~dualRoleKeys) | (tapHold.getHolding () & dualRoleKeys);
+#else
+		const KeyState held = pressed & layerKeys;
+#endif
+		if (held != lastHeld) {
+			momentary = 0;
+			for (byte row = 0; row < NUMROWS; ++row) {
+				for (byte col = 0; col < NUMCOLS; ++col) {
+					if (held.isPressed (row, col)) {
+						Key key = lookup (row, col);
+#ifdef ENABLE_TAP_HOLD
+						if (dualRoleKeys.isPressed (row, col)) {
+							key = getDualRole (key).hold;
+						}
+#endif
+						const byte mask = 1 << LAYER_EXTRACT (key);
+						const boolean newPress = !lastHeld.isPressed (row, col);
+						switch (KEYPRESS_IS_LAYER (key) ? LAYER_OP_EXTRACT (key) : LAYEROP_TRANSPARENT) {
+							case LAYEROP_MOMENTARY:
+								momentary |= mask;
+								break;
+							case LAYEROP_TOGGLE:
+								if (newPress) {
+									toggled ^= mask;
+								}
+								break;
+							case LAYEROP_ONESHOT:
+								if (newPress) {
+									oneShot |= mask;
+									oneShotKeys.clear ();
+								}
+								break;
+							case LAYEROP_TRANSPARENT:
+							case LAYEROP_DUALROLE:
+							default:
+								break;
+						}
+					}
+				}
+			}
+			lastHeld = held;
+		}
+
+		return activate ();
+	}
+
+	/** \brief Resolve the layers again if the active ones changed
+	 *
+	 * \return True if they did
+	 */
+	boolean activate () {
+		const byte a = momentary | toggled | oneShot;
+		const boolean changed = a != active;
+		if (changed) {
+			active = a;
+			resolve ();
+		}
+
+		return changed;
+	}
+
+	//! \brief Work out #source and #layerKeys for the active layers
+	void resolve () {
+		overridesSeq = keymapOverrides.getSequence ();
+		if (base) {
+			for (byte row = 0; row < NUMROWS; ++row) {
+				for (byte col = 0; col < NUMCOLS; ++col) {
+					byte src = 0;
+					for (byte i = nTables; src == 0 && i > 0; --i) {
+						if ((active & (1 << (i - 1))) && read (&tables[i - 1][row][col]) != KEY_TRANSPARENT) {
+							src = i;
+						}
+					}
+					source[row][col] = src;
+
+					const Key key = lookup (row, col);
+					layerKeys.set (row, col, KEYPRESS_IS_LAYER (key));
+#ifdef ENABLE_TAP_HOLD
+					dualRoleKeys.set (row, col, KEYPRESS_IS_LAYER (key) && LAYER_OP_EXTRACT (key) == LAYEROP_DUALROLE);
+#endif
+				}
+			}
+		}
+	}
+};
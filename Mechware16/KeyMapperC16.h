@@ -19,7 +19,7 @@
 
 #include "config.h"
 #include "MatrixKeyboardScanner.h"
-#include "UsbKeyboard.h"
+#include "SymbolicShift.h"
 #include "Log.h"
 
 /** \brief Number of rows in the C16/Plus4 keyboard matrix
@@ -47,17 +47,42 @@
  * The Plus/4 also has an additional Power Led that is wired in the keyboard
  * connector, while it is separate on the C16. No idea on the C116.
  * 
- * This mapper works the same as the one for the C64 (#KeyMapperC64), so please
+ * This mapper works the same as the one for the C64 (#KeyMapperCbm), so please
  * refer to that for any information.
+ *
+ * The mapping mode is set through setMode() before begin(), but holding down
+ * the C= key at startup always selects positional mode.
  */
 class KeyMapperC16: public KeyMapper<C16_MATRIX_ROWS, C16_MATRIX_COLS, byte> {
-private:
-	enum KbdMode {
-		KBD_POSITIONAL,
-		KBD_SYMBOLIC
+public:
+	//! \brief Numbers identifying our keymaps in #KeymapOverrides
+	enum Layer: byte {
+		LAYER_POSITIONAL,
+		LAYER_SYMBOLIC,
+		LAYER_SYMBOLIC_SHIFTED,
+		LAYER_FN
+	};
+
+#ifdef ENABLE_KEY_LAYERS
+	//! \brief Our Fn layers
+	enum FnLayer: byte {
+		FNLAYER_FN,
+		N_FNLAYERS
+	};
+#endif
+
+#ifdef ENABLE_TAP_HOLD
+	//! \brief Our dual-role keys
+	enum DualRole: byte {
+		DUALROLE_CMD_CTRL,
+		DUALROLE_CMD_ALT,
+		DUALROLE_CLEAR,
+		N_DUALROLES
 	};
+#endif
 
-	KbdMode kmode;
+private:
+	KeyMapMode kmode = KEYMAP_SYMBOLIC;
 	
 	// C16, Positional Mapping with our own mapping settings
 	static const Key keymapPositional[C16_MATRIX_ROWS][C16_MATRIX_COLS] PROGMEM;
@@ -65,86 +90,71 @@ private:
 	static const Key keymapSymbolic[C16_MATRIX_ROWS][C16_MATRIX_COLS] PROGMEM;
 
 	static const Key keymapSymbolicShifted[C16_MATRIX_ROWS][C16_MATRIX_COLS] PROGMEM;
+
+#ifdef ENABLE_KEY_LAYERS
+	// Used in all modes, on top of the keymaps above
+	static const LayerTable layersFn[N_FNLAYERS] PROGMEM;
+#endif
+
+#ifdef ENABLE_TAP_HOLD
+	static const DualRoleKey dualRoleKeys[N_DUALROLES] PROGMEM;
+#endif
 	
-	KbdMode getStartupMode (const Matrix& mtx) const {
-		KbdMode md = KBD_SYMBOLIC;
+	KeyMapMode getStartupMode (const Matrix& mtx) const {
+		KeyMapMode md = kmode;
 		if ((mtx[7] & (1 << 5)) == 0) {
 			// C= key pressed
-			md = KBD_POSITIONAL;
+			md = KEYMAP_POSITIONAL;
 		}
 
 		return md;
 	}
 	
 public:
-	virtual boolean begin (const Matrix& mtx) override {
+	DISPATCH_VIRTUAL boolean begin (const Matrix& mtx) DISPATCH_OVERRIDE {
 		switch ((kmode = getStartupMode (mtx))) {
-			case KBD_POSITIONAL:
-				Log.info (F("Starting up in POSITIONAL mode\n"));
-				setKeyMap (keymapPositional);
+			case KEYMAP_POSITIONAL:
+				Log.info (LOG_STR ("Starting up in POSITIONAL mode\n"));
 				break;
-			case KBD_SYMBOLIC:
+			case KEYMAP_SYMBOLIC:
 			default:
-				Log.info (F("Starting up in SYMBOLIC mode\n"));
-				// Nothing to do
+				Log.info (LOG_STR ("Starting up in SYMBOLIC mode\n"));
 				break;
 		}
+#ifdef ENABLE_KEY_LAYERS
+		setLayers (layersFn, N_FNLAYERS, LAYER_FN);
+#endif
+#ifdef ENABLE_TAP_HOLD
+		setDualRoleKeys (dualRoleKeys, N_DUALROLES);
+#endif
+		setMode (kmode);
 		return KeyMapper<C16_MATRIX_ROWS, C16_MATRIX_COLS, byte>::begin (mtx);
 	}
 
-	virtual byte map (const Matrix& mtx, KeyBuffer& kbuf) override {
+	DISPATCH_VIRTUAL void setMode (const KeyMapMode md) DISPATCH_OVERRIDE {
+		kmode = md;
+		if (kmode == KEYMAP_POSITIONAL) {
+			setKeyMap (keymapPositional, LAYER_POSITIONAL);
+		}
+		// Symbolic keymaps are selected in map(), according to SHIFT
+	}
+
+	DISPATCH_VIRTUAL byte map (const Matrix& mtx, KeyBuffer& kbuf) DISPATCH_OVERRIDE {
 		byte ret = 0;
 		
-		if (kmode == KBD_POSITIONAL) {
+		if (kmode == KEYMAP_POSITIONAL) {
 			ret = KeyMapper<C16_MATRIX_ROWS, C16_MATRIX_COLS, byte>::map (mtx, kbuf);
 		} else {
 			if ((mtx[1] & (1 << 7)) == 0) {
 				// Shift is pressed
-				setKeyMap (keymapSymbolicShifted);
+				setKeyMap (keymapSymbolicShifted, LAYER_SYMBOLIC_SHIFTED);
 			} else {
-				setKeyMap (keymapSymbolic);
+				setKeyMap (keymapSymbolic, LAYER_SYMBOLIC);
 			}
 
 			ret = KeyMapper<C16_MATRIX_ROWS, C16_MATRIX_COLS, byte>::map (mtx, kbuf);
 
-			// See if we need to remove the SHIFT key from the buffer
-			if (kbuf.size > 1 && kbuf.find (static_cast<Key> (KEY_LEFT_SHIFT), eventKeyCompare) >= 0) {
-				boolean remove = false;
-				for (byte i = 0; i < kbuf.size && !remove; ++i) {
-					switch (kbuf[i].key) {
-						case KEY_LEFT_SHIFT:
-						case KEY_LEFT_CTRL:
-						case KEY_LEFT_ALT:
-						case KEY_UP:
-						case KEY_DOWN:
-						case KEY_LEFT:
-						case KEY_RIGHT:
-						case KEY_HOME:
-						case KEY_TAB:
-						case KEY_ESC:
-							// These keys can be pressed with SHIFT freely
-							break;
-						case KEY_F1 ... KEY_F8:
-							/* The function keys change their meaning with shift, so
-							 * we'd better remove it
-							 */
-							remove = true;
-							break;
-						default:
-							/* Some keys require shift to be (de)synthesized, so
-							 * let's pretend it's not pressed
-							 */
-							if (!UsbKeyboard::keyNeedsShift (kbuf[i].key)) {
-								remove = true;
-							}
-							break;
-					}
-				}
-
-				if (remove) {
-					kbuf.remove (static_cast<Key> (KEY_LEFT_SHIFT), eventKeyCompare);
-				}
-			}
+			dropSymbolicShift (kbuf);
 		}
 
 		return ret;
@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file KeyMapperCbm.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Commodore 64/VIC-20 Keyboard Mapper
+ * \ingroup KeyboardScanners
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include "config.h"
+#include "MatrixKeyboardScanner.h"
+#include "SymbolicShift.h"
+#include "Log.h"
+
+/** \brief Number of rows in the C64/VIC-20 keyboard matrix
+ *
+ * \sa CBM_MATRIX_COLS
+ */
+#define CBM_MATRIX_ROWS 8
+
+/** \brief Number of columns in the C64/VIC-20 keyboard matrix
+ *
+ * \sa CBM_MATRIX_ROWS
+ */
+#define CBM_MATRIX_COLS 8
+
+/** \brief Keyboard mapper for C64-style keyboards
+ *
+ * The C64 and VIC-20 keyboards have 66 keys: Shift Lock is a mechanical latch
+ * on the same line as the left Shift key and RESTORE is not part of the
+ * matrix, so the remaining 64 keys fill a matrix of 8 rows and 8 columns.
+ *
+ * Two mapping modes are supported:
+ * - In positional mode, every key produces the key that is in the same place
+ *   on a PC keyboard, which is what emulators expect.
+ * - In symbolic mode, every key produces the symbol printed on it, with or
+ *   without SHIFT. SHIFT only reaches the host together with keys that need
+ *   it, see dropSymbolicShift(). Since there are only two cursor keys, their
+ *   shifted directions are sent without SHIFT.
+ *
+ * While RESTORE is held, keys are always mapped positionally, but some of
+ * them produce the keys that C64 keyboards lack, e.g. the number keys produce
+ * F1-F10. See the keymaps for the details.
+ *
+ * Everything that differs between keyboards comes from \a LAYOUT, which must
+ * provide:
+ * - Keymaps \a keymapPositional, \a keymapSymbolic, \a keymapSymbolicShifted
+ *   and \a keymapRestore, of #CBM_MATRIX_ROWS x #CBM_MATRIX_COLS keys.
+ * - The positions of the Shift keys (\a LSHIFT_ROW, \a LSHIFT_COL,
+ *   \a RSHIFT_ROW, \a RSHIFT_COL) and of the C= key (\a CBM_ROW, \a CBM_COL).
+ * - A function \a unshifted() returning the #KeyState of keys that must never
+ *   be sent with SHIFT in symbolic mode.
+ *
+ * The mapping mode is set through setMode() before begin(), but holding down
+ * the C= key at startup always selects positional mode.
+ *
+ * \tparam LAYOUT Description of the keyboard
+ */
+template <typename LAYOUT>
+class KeyMapperCbm: public KeyMapper<CBM_MATRIX_ROWS, CBM_MATRIX_COLS, byte> {
+public:
+	//! \brief Numbers identifying our keymaps in #KeymapOverrides
+	enum Layer: byte {
+		LAYER_POSITIONAL,
+		LAYER_SYMBOLIC,
+		LAYER_SYMBOLIC_SHIFTED,
+		LAYER_RESTORE
+	};
+
+private:
+	typedef KeyMapper<CBM_MATRIX_ROWS, CBM_MATRIX_COLS, byte> Base;
+
+	KeyMapMode kmode = KEYMAP_SYMBOLIC;
+
+	boolean restore = false;
+
+	static boolean isPressed (const Matrix& mtx, const byte row, const byte col) {
+		return (mtx[row] & (1 << col)) == 0;
+	}
+
+public:
+	DISPATCH_VIRTUAL boolean begin (const Matrix& mtx) DISPATCH_OVERRIDE {
+		if (isPressed (mtx, LAYOUT::CBM_ROW, LAYOUT::CBM_COL)) {
+			kmode = KEYMAP_POSITIONAL;
+		}
+
+		switch (kmode) {
+			case KEYMAP_POSITIONAL:
+				Log.info (LOG_STR ("Starting up in POSITIONAL mode\n"));
+				break;
+			case KEYMAP_SYMBOLIC:
+			default:
+				Log.info (LOG_STR ("Starting up in SYMBOLIC mode\n"));
+				break;
+		}
+
+		return Base::begin (mtx);
+	}
+
+	DISPATCH_VIRTUAL void setMode (const KeyMapMode md) DISPATCH_OVERRIDE {
+		// Keymaps are selected in map(), according to SHIFT and RESTORE
+		kmode = md;
+	}
+
+	/** \brief Tell whether RESTORE is pressed
+	 *
+	 * It is not part of the matrix, so the scanner must read it on its own.
+	 */
+	void setRestore (const boolean pressed) {
+		restore = pressed;
+	}
+
+	DISPATCH_VIRTUAL byte map (const Matrix& mtx, KeyBuffer& kbuf) DISPATCH_OVERRIDE {
+		byte ret;
+
+		if (restore) {
+			setKeyMap (LAYOUT::keymapRestore, LAYER_RESTORE);
+			ret = Base::map (mtx, kbuf);
+		} else if (kmode == KEYMAP_POSITIONAL) {
+			setKeyMap (LAYOUT::keymapPositional, LAYER_POSITIONAL);
+			ret = Base::map (mtx, kbuf);
+		} else {
+			if (isPressed (mtx, LAYOUT::LSHIFT_ROW, LAYOUT::LSHIFT_COL) ||
+			    isPressed (mtx, LAYOUT::RSHIFT_ROW, LAYOUT::RSHIFT_COL)) {
+				setKeyMap (LAYOUT::keymapSymbolicShifted, LAYER_SYMBOLIC_SHIFTED);
+			} else {
+				setKeyMap (LAYOUT::keymapSymbolic, LAYER_SYMBOLIC);
+			}
+
+			ret = Base::map (mtx, kbuf);
+
+			dropSymbolicShift (kbuf, !(kbuf.getPositions () & LAYOUT::unshifted ()).empty ());
+		}
+
+		return ret;
+	}
+};
@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file KeySet.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Set of key events, with fast lookup by matrix position
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "KeyState.h"
+
+/** \brief Set of key events, with fast lookup by matrix position
+ *
+ * Events are kept in the order they were added, which is the order keys get
+ * reported in. Alongside them, a #KeyState tells whether a position is in the
+ * set without looking at the events at all.
+ *
+ * There can be at most one event per position.
+ *
+ * \tparam T Event type, must have \a row and \a col members
+ * \tparam SIZE Maximum number of events
+ */
+template <typename T, byte SIZE>
+class KeySet {
+public:
+	//! \brief Number of events in the set, read-only
+	byte size;
+
+	void begin () {
+		size = 0;
+		positions.clear ();
+	}
+
+	const T& operator [](const byte i) const {
+		return buf[i];
+	}
+
+	boolean full () const {
+		return size >= SIZE;		// Better be safe ;)
+	}
+
+	//! \brief Check if there is an event for a matrix position
+	boolean contains (const byte row, const byte col) const {
+		return positions.isPressed (row, col);
+	}
+
+	//! \brief Positions of all events
+	const KeyState& getPositions () const {
+		return positions;
+	}
+
+	/** \brief Find an event
+	 *
+	 * \param[in] o What to look for
+	 * \param[in] cmp Function object called as cmp (event, o), returning true
+	 *                for the event being looked for
+	 * \return The index of the first matching event, -1 if there is none
+	 */
+	template <typename O, typename Cmp>
+	int8_t find (const O& o, Cmp cmp) const {
+		int8_t ret = -1;
+
+		for (byte i = 0; i < size; ++i) {
+			if (cmp (buf[i], o)) {
+				ret = i;
+				break;
+			}
+		}
+
+		return ret;
+	}
+
+	/** \brief Add an event at the end
+	 *
+	 * \return False if the set is full or already has an event for the same
+	 *         position
+	 */
+	boolean append (const T& evt) {
+		boolean ok = !full () && !contains (evt.row, evt.col);
+		if (ok) {
+			buf[size++] = evt;
+			positions.set (evt.row, evt.col, true);
+		}
+
+		return ok;
+	}
+
+	//! \brief Remove the event for a matrix position, if there is one
+	boolean remove (const byte row, const byte col) {
+		boolean found = contains (row, col);
+		if (found) {
+			byte i = 0;
+			while (buf[i].row != row || buf[i].col != col) {
+				++i;
+			}
+			removeAt (i);
+		}
+
+		return found;
+	}
+
+	//! \brief Remove the first event matching \a o, see find()
+	template <typename O, typename Cmp>
+	boolean remove (const O& o, Cmp cmp) {
+		int8_t pos = find (o, cmp);
+		boolean found = pos >= 0;
+		if (found) {
+			removeAt (pos);
+		}
+
+		return found;
+	}
+
+	//! \brief Remove the event at index \a i, which must be < #size
+	void removeAt (const byte i) {
+		positions.set (buf[i].row, buf[i].col, false);
+
+		// Keep the order, there are only a few events anyway
+		for (byte j = i; j < size - 1; ++j) {
+			buf[j] = buf[j + 1];
+		}
+
+		--size;
+	}
+
+private:
+	T buf[SIZE];
+
+	KeyState positions;
+};
@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file KeyState.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Set of pressed keys, one bit per matrix position
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+/** \brief Set of pressed keys, one bit per matrix position
+ *
+ * Key at row R, column C is bit R * #COLS + C of a 64-bit word, so whole sets
+ * can be compared, combined and counted at once, while single rows are still
+ * available as bytes, the same way the scanners read them.
+ *
+ * Unlike scanner matrices, a bit is set when the key is pressed.
+ *
+ * Constant sets can be built at compile time with at() and combined with |.
+ */
+class KeyState {
+public:
+	typedef uint64_t Bits;
+
+	static constexpr byte ROWS = 8;
+	static constexpr byte COLS = 8;
+
+	constexpr KeyState (): bits (0) {
+	}
+
+	constexpr explicit KeyState (const Bits b): bits (b) {
+	}
+
+	//! \brief Bit index of a matrix position
+	static constexpr byte index (const byte row, const byte col) {
+		return row * COLS + col;
+	}
+
+	//! \brief Set containing only the key at bit \a i
+	static constexpr KeyState at (const byte i) {
+		return KeyState (static_cast<Bits> (1) << i);
+	}
+
+	//! \brief Set containing only the key at \a row, \a col
+	static constexpr KeyState at (const byte row, const byte col) {
+		return at (index (row, col));
+	}
+
+	boolean isPressed (const byte row, const byte col) const {
+		return rows[row] & (1 << col);
+	}
+
+	void set (const byte row, const byte col, const boolean pressed) {
+		if (pressed) {
+			rows[row] |= 1 << col;
+		} else {
+			rows[row] &= ~(1 << col);
+		}
+	}
+
+	void clear () {
+		bits = 0;
+	}
+
+	//! \brief Pressed keys in a row, bit N is column N
+	byte row (const byte r) const {
+		return rows[r];
+	}
+
+	//! \brief Replace a whole row, see row()
+	void setRow (const byte r, const byte pressed) {
+		rows[r] = pressed;
+	}
+
+	//! \brief Check if all keys in \a mask are pressed
+	boolean all (const KeyState& mask) const {
+		return (bits & mask.bits) == mask.bits;
+	}
+
+	//! \brief Check if any key in \a mask is pressed
+	boolean any (const KeyState& mask) const {
+		return (bits & mask.bits) != 0;
+	}
+
+	boolean empty () const {
+		return bits == 0;
+	}
+
+	//! \brief Number of pressed keys
+	byte count () const {
+		return __builtin_popcountll (bits);
+	}
+
+	constexpr KeyState operator | (const KeyState& o) const {
+		return KeyState (bits | o.bits);
+	}
+
+	constexpr KeyState operator & (const KeyState& o) const {
+		return KeyState (bits & o.bits);
+	}
+
+	//! \brief Keys that changed state between two sets
+	constexpr KeyState operator ^ (const KeyState& o) const {
+		return KeyState (bits ^ o.bits);
+	}
+
+	constexpr KeyState operator ~ () const {
+		return KeyState (~bits);
+	}
+
+	KeyState& operator |= (const KeyState& o) {
+		bits |= o.bits;
+		return *this;
+	}
+
+	KeyState& operator &= (const KeyState& o) {
+		bits &= o.bits;
+		return *this;
+	}
+
+	constexpr boolean operator == (const KeyState& o) const {
+		return bits == o.bits;
+	}
+
+	constexpr boolean operator != (const KeyState& o) const {
+		return bits != o.bits;
+	}
+
+private:
+	// Both AVR and the hosts we build on are little-endian, so rows[R] is row R
+	union {
+		Bits bits;
+		byte rows[ROWS];
+	};
+};
@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file KeyboardHandler.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Turns scan results into USB key press/release events
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include "config.h"
+#include "KeyboardScanner.h"
+#include "UsbKeyboard.h"
+#include "Log.h"
+#include "LatencyStats.h"
+
+//! \brief Event counters, mainly useful for diagnostics
+struct Counters {
+	unsigned long scans;		//!< Completed keyboard scans
+	word presses;				//!< Keys pressed
+	word releases;				//!< Keys released
+	word failures;				//!< Failed presses/releases
+};
+
+/** \brief Turns scan results into USB key press/release events
+ *
+ * Remembers which key was reported for every matrix position, so that it can
+ * tell which keys were pressed and released since the previous scan. A key is
+ * released when its position is no longer pressed or is now mapped to a
+ * different key.
+ */
+template <byte NUMROWS, byte NUMCOLS>
+class KeyboardHandler {
+	static_assert (NUMROWS <= KEYBUF_MAX_ROWS && NUMCOLS <= KEYBUF_MAX_COLS, "Matrix too large for KeyBuffer");
+
+public:
+	//! \brief Called with the matrix position of every key pressed or released
+	typedef void (*KeyCallback) (const byte row, const byte col);
+
+	Counters counters;
+
+	void begin (UsbKeyboard& kbd, KeyCallback pressed, KeyCallback released) {
+		usbKeyboard = &kbd;
+		onKeyPressed = pressed;
+		onKeyReleased = released;
+		memset (&counters, 0x00, sizeof (counters));
+		clear ();
+	}
+
+	//! \brief Mark all keys as released, without reporting anything
+	void clear () {
+		held.begin ();
+	}
+
+	//! \brief Keys currently being reported as pressed, by matrix position
+	const KeyState& getPressed () const {
+		return held.getPositions ();
+	}
+
+	/** \brief Generates key press/release events
+	 *
+	 * \param newBuf Keys currently being pressed
+	 */
+	void handle (const KeyBuffer& newBuf) {
+#ifdef ENABLE_LATENCY_STATS
+		boolean pressed = false;
+#endif
+
+		// Check for keys that were just released, backwards since they are removed as we go
+		const KeyState released = held.getPositions () & ~newBuf.getPositions ();
+		for (byte i = held.size; !released.empty () && i-- > 0;) {
+			const KeyEvent& evt = held[i];
+			if (released.isPressed (evt.row, evt.col)) {
+				release (i);
+			}
+		}
+
+		// Check for keys that were just pressed
+		for (byte i = 0; i < newBuf.size; ++i) {
+			const KeyEvent& evt = newBuf[i];
+			boolean isNew = true;
+			if (held.contains (evt.row, evt.col)) {
+				const byte h = held.find (evt, EventHasPosition ());
+				if (held[h].key == evt.key) {
+					isNew = false;
+				} else {
+					// Still pressed, but now it means something else
+					release (h);
+				}
+			}
+
+			if (isNew) {
+				// New key pressed
+				Log.trace (LOG_STR ("USB Key pressed: %X\n"), (int) evt.key);
+				boolean ok = usbKeyboard -> press (evt.key);
+#ifdef PEDANTIC_PRESS_RELEASE_CHECKS
+				if (ok) {
+#endif
+					// Failed presses are retried at every scan, only notify once
+					onKeyPressed (evt.row, evt.col);
+					++counters.presses;
+					held.append (evt);
+#ifdef ENABLE_LATENCY_STATS
+					pressed = true;
+#endif
+#ifdef PEDANTIC_PRESS_RELEASE_CHECKS
+				} else {
+#else
+				if (!ok) {
+#endif
+					/* Any failures are probably due to the internal HID Library
+					 * buffer being full
+					 */
+					++counters.failures;
+					Log.error (LOG_STR ("Key press failed: %X\n"), (int) evt.key);
+				}
+			}
+		}
+
+#ifdef ENABLE_LATENCY_STATS
+		if (usbKeyboard -> commit () && pressed) {
+			latencyStats.mark (LATSTAGE_REPORTED);
+		} else {
+			// Whatever was being followed did not turn into a key press
+			latencyStats.cancel (LATSTAGE_REPORTED);
+		}
+#else
+		usbKeyboard -> commit ();
+#endif
+	}
+
+private:
+	UsbKeyboard *usbKeyboard;
+
+	//! \brief Keys being reported, with the USB keycode each was reported as
+	KeyBuffer held;
+
+	KeyCallback onKeyPressed;
+
+	KeyCallback onKeyReleased;
+
+	//! \brief Release the key at index \a i of #held
+	void release (const byte i) {
+		const KeyEvent evt = held[i];
+		const Key usbKeycode = evt.key;
+		Log.trace (LOG_STR ("USB Key released: %X\n"), (int) usbKeycode);
+		if (!usbKeyboard -> release (usbKeycode)) {
+			/* This means the key was not being reported, which happens when
+			 * another key with the same keycode (e.g. ' and ") was released
+			 * first. Retrying would never succeed, so forget about the key
+			 * anyway, even with PEDANTIC_PRESS_RELEASE_CHECKS.
+			 */
+			++counters.failures;
+			Log.error (LOG_STR ("Key release failed: %X\n"), (int) usbKeycode);
+		}
+
+		onKeyReleased (evt.row, evt.col);
+		++counters.releases;
+		held.removeAt (i);
+	}
+};
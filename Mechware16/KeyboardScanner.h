@@ -28,7 +28,8 @@
 
 #include "config.h"
 #include <Arduino.h>
-#include "SmallBuffer.h"
+#include "KeySet.h"
+#include "Dispatch.h"
 
 /** \brief Size of keyboard buffer
  * 
@@ -36,6 +37,18 @@
  */
 const byte KEYBUF_SIZE = 6;
 
+/** \brief Largest matrix whose keys can be put in a #KeyBuffer
+ *
+ * \sa KEYBUF_MAX_COLS
+ */
+const byte KEYBUF_MAX_ROWS = KeyState::ROWS;
+
+/** \brief Largest matrix whose keys can be put in a #KeyBuffer
+ *
+ * \sa KEYBUF_MAX_ROWS
+ */
+const byte KEYBUF_MAX_COLS = KeyState::COLS;
+
 //! \brief Type used to represent keypresses
 typedef word Key;	// Maybe this could be KeyboardKeycode from HID-Project/src/KeyboardLayouts/ImprovedKeylayouts.h?
 
@@ -47,15 +60,44 @@ struct KeyEvent {
 };
 
 //! \brief Key event buffer
-typedef SmallBuffer<KeyEvent, KEYBUF_SIZE> KeyBuffer;
+typedef KeySet<KeyEvent, KEYBUF_SIZE> KeyBuffer;
 
 //! \brief Helper for searching for a specific \a Key in a \a KeyBuffer
-boolean eventKeyCompare (const KeyEvent& evt, const Key& k);
+struct EventHasKey {
+	boolean operator () (const KeyEvent& evt, const Key& k) const {
+		return evt.key == k;
+	}
+};
+
+//! \brief Helper for searching for the event at the same position as another
+struct EventHasPosition {
+	boolean operator () (const KeyEvent& evt, const KeyEvent& o) const {
+		return evt.row == o.row && evt.col == o.col;
+	}
+};
+
+//! \brief Bounce statistics of a single key, see #AdaptiveDebouncer
+struct BounceStats {
+	word transitions;		//!< Times the key changed state
+	word edges;				//!< Raw edges seen during those, one per transition if the key never bounces
+	byte maxSettle;			//!< Longest time from the first to the last edge of a transition (scans)
+	byte chatter;			//!< Times the key bounced again after a transition was over
+	byte window;			//!< Current debounce window (scans)
+};
+
+//! \brief Ways keys can be translated into USB keycodes
+enum KeyMapMode: byte {
+	KEYMAP_POSITIONAL,		//!< Keys are mapped according to their position
+	KEYMAP_SYMBOLIC			//!< Keys are mapped according to their legend
+};
 
 /** \brief Abstract Keyboard Scanner (Parent Class)
  * 
  * This is the abstract class that must be derived by all the various keyboard
  * scanners.
+ *
+ * With #ENABLE_STATIC_DISPATCH nothing is virtual: derived classes must be
+ * used directly and provide their own begin(), end() and scan().
  */
 class KeyboardScanner {
 protected:
@@ -67,11 +109,13 @@ public:
 		SCAN_COMPLETE			//!< Scan completed
 	};
 	
+#ifndef ENABLE_STATIC_DISPATCH
 	//! \brief Initialize scanner
 	virtual boolean begin () = 0;
 	
 	//! \brief Cleanup scanner
 	virtual boolean end () = 0;
+#endif
 
 	/** \brief Do internal stuff
 	 *
@@ -79,9 +123,10 @@ public:
 	 * scanner to do its internal housekeeping. A do-nothing default
 	 * implementation is provided.
 	 */
-	virtual void loop () {
+	DISPATCH_VIRTUAL void loop () {
 	}
 
+#ifndef ENABLE_STATIC_DISPATCH
 	/** \brief Scan keyboard
 	 * 
 	 * This function shall scan the keyboard and report the keys currently being
@@ -92,6 +137,7 @@ public:
 	 * \return The scan result
 	 */
 	virtual ScanStatus scan (KeyBuffer& buf) = 0;
+#endif
 
 	/** \brief Update keyboard leds
 	 * 
@@ -102,10 +148,72 @@ public:
 	 * \param[in] numLock True if the Num Lock led shall be lit
 	 * \param[in] scrollLock True if the Scroll Lock led shall be lit
 	 */
-	virtual void updateLeds (const boolean capsLock, const boolean numLock, const boolean scrollLock) {
+	DISPATCH_VIRTUAL void updateLeds (const boolean capsLock, const boolean numLock, const boolean scrollLock) {
 		// Do nothing, just avoid warnings
 		(void) capsLock;
 		(void) numLock;
 		(void) scrollLock;
 	};
+
+	/** \brief Change the key mapping mode
+	 * 
+	 * This can be called both before begin(), to select the mode to start up
+	 * in, and at any later time. A do-nothing implementation is provided.
+	 * 
+	 * \param[in] mode The new mapping mode
+	 */
+	DISPATCH_VIRTUAL void setKeyMapMode (const KeyMapMode mode) {
+		(void) mode;
+	}
+
+	/** \brief Change the debounce length
+	 * 
+	 * A do-nothing implementation is provided, for scanners that do not
+	 * debounce.
+	 * 
+	 * \param[in] length Number of consecutive scans that must return the same
+	 *                   value for a reading to be considered stable
+	 */
+	DISPATCH_VIRTUAL void setDebounce (const byte length) {
+		(void) length;
+	}
+
+	/** \brief Get ready for the USB host to sleep
+	 *
+	 * Scanners that can have a key press change the level of the row lines
+	 * shall set things up so, and return true. Otherwise the keyboard keeps
+	 * being scanned to notice key presses. A do-nothing implementation is
+	 * provided.
+	 *
+	 * \return True if a pressed key pulls its row low from now on
+	 */
+	DISPATCH_VIRTUAL boolean suspend () {
+		return false;
+	}
+
+	/** \brief Undo what suspend() did
+	 *
+	 * A do-nothing implementation is provided.
+	 */
+	DISPATCH_VIRTUAL void resume () {
+	}
+
+#ifdef ENABLE_ADAPTIVE_DEBOUNCE
+	/** \brief Get the bounce statistics of a key
+	 *
+	 * \param[in] row Matrix row of the key
+	 * \param[in] col Matrix column of the key
+	 * \return The statistics, or NULL if the position is out of range or the
+	 *         scanner does not keep any
+	 */
+	DISPATCH_VIRTUAL const BounceStats *getBounceStats (const byte row, const byte col) const {
+		(void) row;
+		(void) col;
+		return NULL;
+	}
+
+	//! \brief Clear all bounce statistics
+	DISPATCH_VIRTUAL void resetBounceStats () {
+	}
+#endif
 };
@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file KeymapOverrides.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief User-defined keymap overrides
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include <EEPROM.h>
+#include <util/crc16.h>
+#include "EepromWriter.h"
+#include "KeymapOverrides.h"
+
+word KeymapOverrides::crc (const byte b, const BankHeader& hdr) {
+	word c = 0xFFFF;
+	c = _crc16_update (c, hdr.seq);
+	c = _crc16_update (c, hdr.count);
+
+	const word addr = bankAddress (b) + sizeof (BankHeader);
+	for (word i = 0; i < hdr.count * sizeof (Override); ++i) {
+		c = _crc16_update (c, EEPROM.read (addr + i));
+	}
+
+	return c;
+}
+
+boolean KeymapOverrides::checkBank (const byte b, BankHeader& hdr) {
+	EEPROM.get (bankAddress (b), hdr);
+	return hdr.count <= MAX_OVERRIDES && hdr.crc == crc (b, hdr);
+}
+
+void KeymapOverrides::load (const byte b) {
+	BankHeader hdr;
+	EEPROM.get (bankAddress (b), hdr);
+
+	memset (present, 0x00, sizeof (present));
+	count = 0;
+
+	word addr = bankAddress (b) + sizeof (BankHeader);
+	for (byte i = 0; i < hdr.count; ++i, addr += sizeof (Override)) {
+		Override o;
+		EEPROM.get (addr, o);
+
+		// Insertion sort, so that find() can do a binary search
+		byte j = count;
+		while (j > 0 && overrides[j - 1].pos > o.pos) {
+			--j;
+		}
+
+		if (j > 0 && overrides[j - 1].pos == o.pos) {
+			// Position overridden twice, last one wins
+			overrides[j - 1].key = o.key;
+		} else {
+			for (byte k = count; k > j; --k) {
+				overrides[k] = overrides[k - 1];
+			}
+			overrides[j] = o;
+			++count;
+		}
+
+		present[o.pos >> 6][(o.pos >> 3) & 0x07] |= 1 << (o.pos & 0x07);
+	}
+
+	bank = b;
+	seq = hdr.seq;
+}
+
+boolean KeymapOverrides::begin () {
+	BankHeader hdr0, hdr1;
+	const boolean ok0 = checkBank (0, hdr0);
+	const boolean ok1 = checkBank (1, hdr1);
+
+	memset (present, 0x00, sizeof (present));
+	count = 0;
+	editCount = 0;
+
+	if (ok0 && ok1) {
+		// Both valid, the most recent one wins
+		load (static_cast<int8_t> (hdr1.seq - hdr0.seq) > 0 ? 1 : 0);
+	} else if (ok0) {
+		load (0);
+	} else if (ok1) {
+		load (1);
+	} else {
+		// Nothing saved, make the first layout go to bank 0
+		bank = 1;
+		seq = 0;
+	}
+
+	return ok0 || ok1;
+}
+
+boolean KeymapOverrides::find (const byte layer, const byte row, const byte col, Key& key) const {
+	const byte pos = pack (layer, row, col);
+	boolean found = false;
+
+	int8_t lo = 0, hi = count - 1;
+	while (lo <= hi && !found) {
+		const int8_t mid = (lo + hi) / 2;
+		if (overrides[mid].pos < pos) {
+			lo = mid + 1;
+		} else if (overrides[mid].pos > pos) {
+			hi = mid - 1;
+		} else {
+			key = overrides[mid].key;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+void KeymapOverrides::edit () {
+	editCount = 0;
+}
+
+boolean KeymapOverrides::add (const byte layer, const byte row, const byte col, const Key key) {
+	boolean ret = false;
+
+	if (layer < MAX_LAYERS && row < 8 && col < 8 && editCount < MAX_OVERRIDES && step == STEP_IDLE) {
+		// Zero the padding as well, it gets written too
+		Override& o = edits.overrides[editCount];
+		o = {};
+		o.pos = pack (layer, row, col);
+		o.key = key;
+		++editCount;
+		ret = true;
+	}
+
+	return ret;
+}
+
+KeymapOverrides::ApplyStatus KeymapOverrides::apply () {
+	ApplyStatus ret = APPLY_IN_PROGRESS;
+	const byte b = 1 - bank;
+	BankHeader& hdr = edits.header;
+
+	// Each step starts a write, which the next one waits for
+	if (!EepromWriter::busy ()) {
+		switch (step) {
+			case STEP_IDLE:
+				/* Write the overrides first, with a header that makes the bank
+				 * invalid until they are all there
+				 */
+				hdr = {};
+				hdr.count = 0xFF;
+				EepromWriter::write (bankAddress (b), &edits, sizeof (BankHeader) + editCount * sizeof (Override));
+				step = STEP_OVERRIDES;
+				break;
+			case STEP_OVERRIDES:
+				hdr.seq = seq + 1;
+				hdr.count = editCount;
+				hdr.crc = crc (b, hdr);		// Computed on what is actually in EEPROM
+				EepromWriter::write (bankAddress (b), &hdr, sizeof (BankHeader));
+				step = STEP_HEADER;
+				break;
+			case STEP_HEADER: {
+				BankHeader check;
+				if (checkBank (b, check)) {
+					load (b);
+					ret = APPLY_DONE;
+				} else {
+					ret = APPLY_FAILED;
+				}
+				editCount = 0;
+				step = STEP_IDLE;
+				break;
+			}
+		}
+	}
+
+	return ret;
+}
@@ -0,0 +1,188 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file KeymapOverrides.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief User-defined keymap overrides
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "KeyboardScanner.h"
+
+/** \brief User-defined keymap overrides
+ *
+ * Overrides replace the key produced by a single matrix position in a single
+ * keymap (\a layer, as numbered by the mapper in use) and are stored in EEPROM,
+ * so that layouts can be changed without reflashing.
+ *
+ * At startup they are loaded into a compact cache in RAM: a bitmap telling
+ * which positions are overridden in each layer, plus a sorted list of the
+ * overrides themselves. The mapper checks the bitmap for every pressed key and
+ * only searches the list when there is a hit, so EEPROM is never read while
+ * scanning.
+ *
+ * New layouts are collected in RAM between edit() and apply(), then apply()
+ * writes them to the EEPROM bank that is not in use through #EepromWriter, so
+ * scanning never waits for EEPROM. Once the bank has been written and checked,
+ * the cache is rebuilt from the main loop in between two scans, so a layout is
+ * switched all at once. Should power be lost before apply() completes, the
+ * previous layout is kept.
+ */
+class KeymapOverrides {
+public:
+	//! \brief Maximum number of overrides
+	static constexpr byte MAX_OVERRIDES = 32;
+
+	//! \brief Maximum number of layers overrides can apply to
+	static constexpr byte MAX_LAYERS = 4;
+
+	//! \brief Address of the first bank in EEPROM, right after the settings ring (see SettingsStore.h)
+	static constexpr word EEP_BASE = 0x2A0;
+
+	/** \brief Load overrides from EEPROM
+	 *
+	 * \return True if a valid set of overrides was found (even if empty)
+	 */
+	boolean begin ();
+
+	/** \brief Look up an override
+	 *
+	 * \param[in] layer Keymap to look the position up in
+	 * \param[in] row Matrix row
+	 * \param[in] col Matrix column
+	 * \param[out] key The overriding key, only set if one is found
+	 * \return True if the position is overridden
+	 */
+	inline boolean lookup (const byte layer, const byte row, const byte col, Key& key) const {
+		boolean found = false;
+		if (layer < MAX_LAYERS && row < 8 && (present[layer][row] & (1 << col))) {
+			found = find (layer, row, col, key);
+		}
+
+		return found;
+	}
+
+	//! \brief Number of overrides in use
+	byte size () const {
+		return count;
+	}
+
+	//! \brief Changes every time a new layout is applied
+	byte getSequence () const {
+		return seq;
+	}
+
+	//! \brief Result of apply()
+	enum ApplyStatus: byte {
+		APPLY_DONE,				//!< The new layout is in use
+		APPLY_FAILED,			//!< The new layout could not be written, the current one is still in use
+		APPLY_IN_PROGRESS		//!< Still writing, call again
+	};
+
+	/** \brief Start a new layout
+	 *
+	 * The current one stays in use until apply(). Must not be called while
+	 * apply() is in progress.
+	 */
+	void edit ();
+
+	/** \brief Add an override to the layout being written
+	 *
+	 * \param[in] layer Keymap the override applies to
+	 * \param[in] row Matrix row
+	 * \param[in] col Matrix column
+	 * \param[in] key Key to be produced
+	 * \return False if the parameters are out of range, there is no more space
+	 *         or apply() is in progress, true otherwise
+	 */
+	boolean add (const byte layer, const byte row, const byte col, const Key key);
+
+	/** \brief Make the new layout the current one
+	 *
+	 * The layout is written to EEPROM without waiting, so this must be called
+	 * again and again as long as it returns #APPLY_IN_PROGRESS.
+	 */
+	ApplyStatus apply ();
+
+private:
+	// Position is packed as layer:2, row:3, col:3
+	struct Override {
+		byte pos;
+		Key key;
+	};
+
+	struct BankHeader {
+		byte seq;
+		byte count;
+		word crc;
+	};
+
+	struct Bank {
+		BankHeader header;
+		Override overrides[MAX_OVERRIDES];
+	};
+
+	static constexpr word BANK_SIZE = sizeof (Bank);
+
+	//! \brief Steps of apply()
+	enum ApplyStep: byte {
+		STEP_IDLE,
+		STEP_OVERRIDES,		//!< Writing the overrides, with an invalid header
+		STEP_HEADER			//!< Writing the real header
+	};
+
+	//! \brief Overrides in use, sorted by position
+	Override overrides[MAX_OVERRIDES];
+
+	byte count;
+
+	//! \brief One bit per position for each layer, set if it is overridden
+	byte present[MAX_LAYERS][8];
+
+	//! \brief Bank the overrides in use were loaded from
+	byte bank;
+
+	byte seq;
+
+	//! \brief New layout, as it will be written to EEPROM
+	Bank edits;
+
+	//! \brief Number of overrides added so far to #edits
+	byte editCount;
+
+	ApplyStep step = STEP_IDLE;
+
+	static byte pack (const byte layer, const byte row, const byte col) {
+		return (layer << 6) | (row << 3) | col;
+	}
+
+	static word bankAddress (const byte b) {
+		return EEP_BASE + b * BANK_SIZE;
+	}
+
+	boolean find (const byte layer, const byte row, const byte col, Key& key) const;
+
+	/** \brief Check whether a bank holds a valid layout
+	 *
+	 * \param[in] b Bank number
+	 * \param[out] hdr Bank header
+	 * \return True if the bank is valid
+	 */
+	static boolean checkBank (const byte b, BankHeader& hdr);
+
+	static word crc (const byte b, const BankHeader& hdr);
+
+	void load (const byte b);
+};
+
+extern KeymapOverrides keymapOverrides;
@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file LatencyStats.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Press-to-report latency histograms
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include "LatencyStats.h"
+
+void LatencyStats::begin () {
+#ifndef MECHWARE16_HOST
+	// Normal mode, clk/64, no interrupts
+	TCCR1A = 0;
+	TCCR1B = _BV (CS11) | _BV (CS10);
+	TIMSK1 = 0;
+#endif
+
+	reset ();
+}
+
+void LatencyStats::reset () {
+	memset (histograms, 0x00, sizeof (histograms));
+	next = LATSTAGE_DETECTED;
+}
+
+void LatencyStats::add (const LatencyInterval i, word ticks) {
+	// Find the highest bit set
+	byte bucket = 0;
+	while (ticks >>= 1) {
+		++bucket;
+	}
+
+	word& count = histograms[i][bucket];
+	if (count < 0xFFFF) {
+		++count;
+	}
+}
+
+void LatencyStats::record () {
+	add (LATINT_DEBOUNCE, stamps[LATSTAGE_SETTLED] - stamps[LATSTAGE_DETECTED]);
+	add (LATINT_SCHEDULE, stamps[LATSTAGE_BUFFERED] - stamps[LATSTAGE_SETTLED]);
+	add (LATINT_REPORT, stamps[LATSTAGE_REPORTED] - stamps[LATSTAGE_BUFFERED]);
+	add (LATINT_TOTAL, stamps[LATSTAGE_REPORTED] - stamps[LATSTAGE_DETECTED]);
+}
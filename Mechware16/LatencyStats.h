@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file LatencyStats.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Press-to-report latency histograms
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+//! \brief Points a key press goes through, in order
+enum LatencyStage: byte {
+	LATSTAGE_DETECTED,		//!< A column first went low
+	LATSTAGE_SETTLED,		//!< Debouncing is over
+	LATSTAGE_BUFFERED,		//!< The key was mapped into the #KeyBuffer
+	LATSTAGE_REPORTED,		//!< The USB report was committed
+	N_LATENCY_STAGES
+};
+
+//! \brief Intervals a histogram is kept for
+enum LatencyInterval: byte {
+	LATINT_DEBOUNCE,		//!< Detected to settled
+	LATINT_SCHEDULE,		//!< Settled to buffered, i.e. waiting for the next scan
+	LATINT_REPORT,			//!< Buffered to reported
+	LATINT_TOTAL,			//!< Detected to reported
+	N_LATENCY_INTERVALS
+};
+
+/** \brief Press-to-report latency histograms
+ *
+ * Timestamps are taken from Timer 1, which is left free-running at 250 kHz, so
+ * they have a 4 us resolution and wrap around after 262 ms, which is way more
+ * than any sensible latency.
+ *
+ * Only one key press is followed at a time: mark() ignores any stage but the
+ * one that is expected next, so presses happening while one is being followed
+ * are just not measured. When a press is reported, the time spent between each
+ * stage is added to a histogram.
+ *
+ * Histograms have #N_BUCKETS buckets, bucket \a n counting intervals that
+ * lasted [2^n, 2^(n+1)) ticks (bucket 0 also counts zero-length ones). Counts
+ * saturate rather than wrapping around.
+ */
+class LatencyStats {
+public:
+	//! \brief Number of buckets per histogram, one per bit of the timer
+	static constexpr byte N_BUCKETS = 16;
+
+	//! \brief Length of a timer tick
+	static constexpr byte US_PER_TICK = 4;
+
+	//! \brief Start the timer and clear all histograms
+	void begin ();
+
+	//! \brief Clear all histograms
+	void reset ();
+
+	//! \brief Current timestamp
+	static word now () {
+#ifdef MECHWARE16_HOST
+		return micros () / US_PER_TICK;
+#else
+		return TCNT1;
+#endif
+	}
+
+	//! \brief Note that the press being followed has reached stage \a s
+	inline void mark (const LatencyStage s) {
+		if (s == next) {
+			stamps[s] = now ();
+			if (s == LATSTAGE_REPORTED) {
+				record ();
+				next = LATSTAGE_DETECTED;
+			} else {
+				next = static_cast<LatencyStage> (s + 1);
+			}
+		}
+	}
+
+	/** \brief Stop following the current press if it is waiting for stage \a s
+	 *
+	 * For instance, when a press bounced away and never made it to a report.
+	 */
+	inline void cancel (const LatencyStage s) {
+		if (s == next) {
+			next = LATSTAGE_DETECTED;
+		}
+	}
+
+	const word *getHistogram (const LatencyInterval i) const {
+		return histograms[i];
+	}
+
+private:
+	word histograms[N_LATENCY_INTERVALS][N_BUCKETS];
+
+	word stamps[N_LATENCY_STAGES];
+
+	LatencyStage next;
+
+	void add (const LatencyInterval i, word ticks);
+
+	void record ();
+};
+
+extern LatencyStats latencyStats;
@@ -1,529 +1,803 @@
-/*
-    _   ___ ___  _   _ ___ _  _  ___  _    ___   ___
-   /_\ | _ \   \| | | |_ _| \| |/ _ \| |  / _ \ / __|
-  / _ \|   / |) | |_| || || .` | (_) | |_| (_) | (_ |
- /_/ \_\_|_\___/ \___/|___|_|\_|\___/|____\___/ \___|
-
-  Log library for Arduino
-  version 1.0.3
-  https://github.com/thijse/Arduino-Log
-
-  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
-
-  Modified by SukkoPera to fit in a single header file.
-  Log levels renamed after an idea by ChristianBauerAMDC.
-
-*/
-
-/**
- * \file Log.h
- * \author SukkoPera <software@sukkology.net>
- * \date 22 Feb 2020
- * \brief Log Library
- *
- * Please refer to the GitHub page and wiki for any information:
- * https://github.com/SukkoPera/MechBoard16
- */
-
-#ifndef LOGGING_H
-#define LOGGING_H
-
-//#include <stdint.h>
-//#include <stddef.h>
-#include <inttypes.h>
-#include <stdarg.h>
-#include <Arduino.h>
-#include "config.h"
-
-typedef void (*printfunction)(Print*);
-
-#define LOG_LEVEL_SILENT  0
-#define LOG_LEVEL_FATAL   1
-#define LOG_LEVEL_ERROR   2
-#define LOG_LEVEL_WARN    3
-#define LOG_LEVEL_INFO    4
-#define LOG_LEVEL_DEBUG   5
-#define LOG_LEVEL_TRACE   6
-
-typedef int DebugLevel;
-
-#define L_CR "\n"
-#define LOGGING_VERSION 1_0_3
-
-/**
- * Logging is a helper class to output informations over
- * RS232. If you know log4j or log4net, this logging class
- * is more or less similar ;-) <br>
- * Different loglevels can be used to extend or reduce output
- * All methods are able to handle any number of output parameters.
- * All methods print out a formated string (like printf).<br>
- * To reduce output and program size, reduce loglevel.
- * 
- * Output format string can contain below wildcards. Every wildcard
- * must be start with percent sign (\%)
- * 
- * ---- Wildcards
- * 
- * %s replace with a string (char*)
- * %c replace with a character
- * %d replace with an integer value
- * %l replace with a long value
- * %x replace and convert integer value to hex
- * %X like %x but prefix with 0x
- * %b replace and convert integer value to binary
- * %B like %x but prefix with 0b
- * %t replace and convert boolean value to "t" or "f"
- * %T like %t but convert to "true" or "false"
- * 
- * ---- Loglevels
- * 
- * 0 - LOG_LEVEL_SILENT     no output
- * 1 - LOG_LEVEL_FATAL      fatal errors
- * 2 - LOG_LEVEL_ERROR      all errors
- * 3 - LOG_LEVEL_WARN       errors and warnings
- * 4 - LOG_LEVEL_INFO       errors, warnings and infos
- * 5 - LOG_LEVEL_DEBUG      errors, warnings, infos, debugs
- * 6 - LOG_LEVEL_TRACE      all
- */
-
-class Logging
-{
-public:
-  /**
-   * default Constructor
-   */
-  Logging()
-#ifndef DISABLE_LOGGING
-    : _level(LOG_LEVEL_SILENT),
-    _showLevel(true),
-    _logOutput(NULL)
-#endif
-  {
-
-  }
-
-  /**
-   * Initializing, must be called as first. Note that if you use
-   * this variant of Init, you need to initialize the baud rate
-   * yourself, if printer happens to be a serial port.
-   * 
-   * \param level - logging levels <= this will be logged.
-   * \param printer - place that logging output will be sent to.
-   * \return void
-   *
-   */
-  void begin(int level, Print *logOutput, bool showLevel = true)
-  {
-#ifndef DISABLE_LOGGING
-    setLevel(level);
-    setShowLevel(showLevel);
-    _logOutput = logOutput;
-#else
-	(void) level;
-	(void) logOutput;
-	(void) showLevel;
-#endif
-  }
-
-  /**
-   * Set the log level.
-   * 
-   * \param level - The new log level.
-   * \return void
-   */
-  void setLevel(int level)
-  {
-#ifndef DISABLE_LOGGING
-    _level = constrain(level, LOG_LEVEL_SILENT, LOG_LEVEL_TRACE);
-#else
-	(void) level;
-#endif
-  }
-
-  /**
-   * Get the log level.
-   *
-   * \return The current log level.
-   */
-  int getLevel() const
-  {
-#ifndef DISABLE_LOGGING
-    return _level;
-#else
-    return 0;
-#endif
-  }
-
-  /**
-   * Set whether to show the log level.
-   * 
-   * \param showLevel - true if the log level should be shown for each log
-   *                    false otherwise.
-   * \return void
-   */
-  void setShowLevel(bool showLevel)
-  {
-#ifndef DISABLE_LOGGING
-    _showLevel = showLevel;
-#else
-	(void) showLevel;
-#endif
-  }
-
-  /**
-   * Get whether the log level is shown during logging
-   * 
-   * \return true if the log level is be shown for each log
-   *         false otherwise.
-   */
-  bool getShowLevel() const
-  {
-#ifndef DISABLE_LOGGING
-    return _showLevel;
-#else
-    return false;
-#endif
-  }
-
-  /**
-   * Sets a function to be called before each log command.
-   * 
-   * \param f - The function to be called
-   * \return void
-   */
-  void setPrefix(printfunction f)
-  {
-#ifndef DISABLE_LOGGING
-    _prefix = f;
-#else
-	(void) f;
-#endif
-  }
-
-  /**
-   * Sets a function to be called after each log command.
-   * 
-   * \param f - The function to be called
-   * \return void
-   */
-  void setSuffix(printfunction f)
-  {
-#ifndef DISABLE_LOGGING
-    _suffix = f;
-#else
-	(void) f;
-#endif
-  }
-
-  /**
-   * Output a fatal error message. Output message contains
-   * F: followed by original message
-   * Fatal error messages are printed out at
-   * loglevels >= LOG_LEVEL_FATAL
-   * 
-   * \param msg format string to output
-   * \param ... any number of variables
-   * \return void
-   */
-  template <class T, typename... Args> void fatal(T msg, Args... args)
-  {
-#if !defined (DISABLE_LOGGING) && (!defined (THRESHOLD_LEVEL) || THRESHOLD_LEVEL >= LOG_LEVEL_FATAL)
-    printLevel(LOG_LEVEL_FATAL, msg, args...);
-#endif
-  }
-
-  /**
-   * Output an error message. Output message contains
-   * E: followed by original message
-   * Error messages are printed out at
-   * loglevels >= LOG_LEVEL_ERROR
-   * 
-   * \param msg format string to output
-   * \param ... any number of variables
-   * \return void
-   */
-  template <class T, typename... Args> void error(T msg, Args... args){
-#if !defined (DISABLE_LOGGING) && (!defined (THRESHOLD_LEVEL) || THRESHOLD_LEVEL >= LOG_LEVEL_ERROR)
-    printLevel(LOG_LEVEL_ERROR, msg, args...);
-#else
-	(void) msg;
-	//~ (void) args;
-#endif
-  }
-
-  /**
-   * Output a warning message. Output message contains
-   * W: followed by original message
-   * Warning messages are printed out at
-   * loglevels >= LOG_LEVEL_WARN
-   * 
-   * \param msg format string to output
-   * \param ... any number of variables
-   * \return void
-   */
-  template <class T, typename... Args> void warn(T msg, Args...args)
-  {
-#if !defined (DISABLE_LOGGING) && (!defined (THRESHOLD_LEVEL) || THRESHOLD_LEVEL >= LOG_LEVEL_WARN)
-    printLevel(LOG_LEVEL_WARN, msg, args...);
-#else
-	(void) msg;
-	//~ (void) args;
-#endif
-  }
-
-  /**
-   * Output a info message. Output message contains
-   * N: followed by original message
-   * Notice messages are printed out at
-   * loglevels >= LOG_LEVEL_INFO
-   * 
-   * \param msg format string to output
-   * \param ... any number of variables
-   * \return void
-   */
-  template <class T, typename... Args> void info(T msg, Args...args)
-  {
-#if !defined (DISABLE_LOGGING) && (!defined (THRESHOLD_LEVEL) || THRESHOLD_LEVEL >= LOG_LEVEL_INFO)
-    printLevel(LOG_LEVEL_INFO, msg, args...);
-#else
-	(void) msg;
-	//~ (void) args;
-#endif
-  }
-
-  /**
-   * Output a debug message. Output message contains
-   * N: followed by original message
-   * Trace messages are printed out at
-   * loglevels >= LOG_LEVEL_DEBUG
-   * 
-   * \param msg format string to output
-   * \param ... any number of variables
-   * \return void
-  */
-  template <class T, typename... Args> void debug(T msg, Args... args)
-  {
-#if !defined (DISABLE_LOGGING) && (!defined (THRESHOLD_LEVEL) || THRESHOLD_LEVEL >= LOG_LEVEL_DEBUG)
-    printLevel(LOG_LEVEL_DEBUG, msg, args...);
-#else
-	(void) msg;
-	//~ (void) args;
-#endif
-  }
-
-  /**
-   * Output a trace message. Output message contains
-   * V: followed by original message
-   * Debug messages are printed out at
-   * loglevels >= LOG_LEVEL_TRACE
-   * 
-   * \param msg format string to output
-   * \param ... any number of variables
-   * \return void
-   */
-  template <class T, typename... Args> void trace(T msg, Args... args)
-  {
-#if !defined (DISABLE_LOGGING) && (!defined (THRESHOLD_LEVEL) || THRESHOLD_LEVEL >= LOG_LEVEL_TRACE)
-    printLevel(LOG_LEVEL_TRACE, msg, args...);
-#else
-	(void) msg;
-	//~ (void) args;
-#endif
-  }
-  
-  /**
-   * Output a message at a given level.
-   * 
-   * \param msg format string to output
-   * \param ... any number of variables
-   * \return void
-   */
-  template <class T, typename... Args> void log(DebugLevel level, T msg, Args... args)
-  {
-#if !defined (DISABLE_LOGGING) && (!defined (THRESHOLD_LEVEL) || THRESHOLD_LEVEL >= level)
-    printLevel(level, msg, args...);
-#else
-	(void) level;
-	//~ (void) args;
-#endif
-  }
-
-private:
-  void print(const char *format, va_list args)
-  {
-#ifndef DISABLE_LOGGING     
-    for (; *format != 0; ++format)
-    {
-      if (*format == '%')
-      {
-        ++format;
-        printFormat(*format, &args);
-      }
-      else
-      {
-        _logOutput->print(*format);
-      }
-    }
-#else
-	(void) format;
-	//~ (void) args;
-#endif
-  }
-
-  void print(const __FlashStringHelper *format, va_list args)
-  {
-#ifndef DISABLE_LOGGING     
-    PGM_P p = reinterpret_cast<PGM_P>(format);
-    char c = pgm_read_byte(p++);
-    for(;c != 0; c = pgm_read_byte(p++))
-    {
-      if (c == '%')
-      {
-        c = pgm_read_byte(p++);
-        printFormat(c, &args);
-      }
-      else
-      {
-        _logOutput->print(c);
-      }
-    }
-#else
-	(void) format;
-	(void) args;
-#endif
-  }
-
-  void printFormat(const char format, va_list *args)
-  {
-#ifndef DISABLE_LOGGING
-    if (format == '%')
-    {
-      _logOutput->print(format);
-    }
-    else if (format == 's')
-    {
-      register char *s = (char *)va_arg(*args, int);
-      _logOutput->print(s);
-    }
-    else if (format == 'S')
-    {
-      register __FlashStringHelper *s = (__FlashStringHelper *)va_arg(*args, int);
-      _logOutput->print(s);
-    }
-    else if (format == 'd' || format == 'i')
-    {
-      _logOutput->print(va_arg(*args, int), DEC);
-    }
-    else if (format == 'D' || format == 'F')
-    {
-      _logOutput->print(va_arg(*args, double));
-    }
-    else if (format == 'x')
-    {
-      _logOutput->print(va_arg(*args, int), HEX);
-    }
-    else if (format == 'X')
-    {
-      _logOutput->print("0x");
-      _logOutput->print(va_arg(*args, int), HEX);
-    }
-    else if (format == 'b')
-    {
-      _logOutput->print(va_arg(*args, int), BIN);
-    }
-    else if (format == 'B')
-    {
-      _logOutput->print("0b");
-      _logOutput->print(va_arg(*args, int), BIN);
-    }
-    else if (format == 'l')
-    {
-      _logOutput->print(va_arg(*args, long), DEC);
-    }
-    else if (format == 'u')
-    {
-      _logOutput->print(va_arg(*args, unsigned long), DEC);
-    }
-    else if (format == 'U')
-    {
-      _logOutput->print("0x");
-      _logOutput->print(va_arg(*args, unsigned long), HEX);
-    }
-    else if (format == 'w')
-    {
-      _logOutput->print(va_arg(*args, word), DEC);
-    }
-    else if (format == 'c')
-    {
-      _logOutput->print((char) va_arg(*args, int));
-    }
-    else if(format == 't')
-    {
-      if (va_arg(*args, int) == 1)
-      {
-        _logOutput->print("T");
-      }
-      else
-      {
-        _logOutput->print("F");
-      }
-    }
-    else if (format == 'T')
-    {
-      if (va_arg(*args, int) == 1)
-      {
-        _logOutput->print(F("true"));
-      }
-      else
-      {
-        _logOutput->print(F("false"));
-      }
-    }
-#else
-	(void) format;
-	(void) args;
-#endif
-  }
-
-  template <class T> void printLevel(int level, T msg, ...)
-  {
-#ifndef DISABLE_LOGGING
-    if (level > _level)
-    {
-      return;
-    }
-
-    if (_prefix != NULL)
-    {
-      _prefix(_logOutput);
-    }
-
-    if (_showLevel) {
-      static const char levels[] = "FEWIDT";
-      _logOutput->print(level < 7 ? levels[level - 1] : '?');
-      _logOutput->print(": ");
-    }
-
-    va_list args;
-    va_start(args, msg);
-    print(msg, args);
-
-    if(_suffix != NULL)
-    {
-      _suffix(_logOutput);
-    }
-#endif
-  }
-
-#ifndef DISABLE_LOGGING
-  int _level;
-  bool _showLevel;
-  Print* _logOutput;
-
-  printfunction _prefix = NULL;
-  printfunction _suffix = NULL;
-#endif
-};
-
-extern Logging Log;
-#endif
+/*
+    _   ___ ___  _   _ ___ _  _  ___  _    ___   ___
+   /_\ | _ \   \| | | |_ _| \| |/ _ \| |  / _ \ / __|
+  / _ \|   / |) | |_| || || .` | (_) | |_| (_) | (_ |
+ /_/ \_\_|_\___/ \___/|___|_|\_|\___/|____\___/ \___|
+
+  Log library for Arduino
+  version 1.0.3
+  https://github.com/thijse/Arduino-Log
+
+  Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+
+  Modified by SukkoPera to fit in a single header file.
+  Log levels renamed after an idea by ChristianBauerAMDC.
+
+*/
+
+/**
+ * \file Log.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 22 Feb 2020
+ * \brief Log Library
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#ifndef LOGGING_H
+#define LOGGING_H
+
+//#include <stdint.h>
+//#include <stddef.h>
+#include <inttypes.h>
+#include <stdarg.h>
+#include <Arduino.h>
+#include "config.h"
+#ifdef ENABLE_BINARY_LOGGING
+#include "CircularBuffer.h"
+#endif
+
+typedef void (*printfunction)(Print*);
+
+#define LOG_LEVEL_SILENT  0
+#define LOG_LEVEL_FATAL   1
+#define LOG_LEVEL_ERROR   2
+#define LOG_LEVEL_WARN    3
+#define LOG_LEVEL_INFO    4
+#define LOG_LEVEL_DEBUG   5
+#define LOG_LEVEL_TRACE   6
+
+typedef int DebugLevel;
+
+#define L_CR "\n"
+#define LOGGING_VERSION 1_0_3
+
+#ifdef ENABLE_BINARY_LOGGING
+/**
+ * Binary log records are framed like serial commands (see SerialCommands.h),
+ * with a different start-of-frame marker, so that they can share the port:
+ * - LOG_RECORD_SOF
+ * - Length of what follows, excluding the checksum
+ * - Level, ORed with LOG_RECORD_INTERNED if the message ID is a hash
+ * - Message ID, little-endian: hash of an interned format string (see
+ *   LOG_STR()), flash address of the format string, or 0xFFFF if the format
+ *   string is in RAM, in which case it follows the descriptor, as a string
+ * - Argument descriptor, two bits per argument, first argument in the lowest
+ *   bits: LOG_ARG_WORD, LOG_ARG_DWORD or LOG_ARG_STRING
+ * - Arguments: words and double words are little-endian, strings are copied
+ *   with a length byte in front
+ * - Checksum, chosen so that all bytes from the length on add up to 0
+ *
+ * Level 0 records with ID 0 report how many records were dropped because the
+ * ring was full, in a word argument.
+ */
+#define LOG_RECORD_SOF 0x5A
+#define LOG_RECORD_INTERNED 0x80
+#define LOG_ID_RAM 0xFFFF
+#define LOG_MAX_RECORD_LEN 28
+#define LOG_MAX_STRING_LEN 15
+#define LOG_MAX_ARGS 4
+
+#define LOG_ARG_WORD 1
+#define LOG_ARG_DWORD 2
+#define LOG_ARG_STRING 3
+
+/**
+ * 32-bit FNV-1a hash of a string, tools/logdecode.py must compute the very
+ * same thing.
+ */
+constexpr uint32_t logHash32(const char *s, uint32_t h = 2166136261UL)
+{
+  return *s == '\0' ? h : logHash32(s + 1, (h ^ static_cast<uint8_t>(*s)) * 16777619UL);
+}
+
+//! Message ID of an interned format string, the hash above folded to 16 bits
+constexpr uint16_t logHash(const char *s)
+{
+  return static_cast<uint16_t>(logHash32(s) >> 16) ^ static_cast<uint16_t>(logHash32(s));
+}
+
+struct LogMessageId
+{
+  uint16_t id;
+};
+
+// Makes sure hashes are computed at compile time
+template <uint16_t ID> struct LogHashed
+{
+  static constexpr uint16_t id = ID;
+};
+
+/**
+ * Use for format strings instead of F(). In binary mode the string is replaced
+ * by its hash at compile time and never makes it into the firmware, otherwise
+ * this is the same as F().
+ */
+#define LOG_STR(s) (LogMessageId {LogHashed<logHash(s)>::id})
+
+/**
+ * How each argument type is stored. Anything up to int takes a word, longs
+ * and floating-point values a double word. RAM strings are copied, flash
+ * strings are stored as their address.
+ */
+constexpr uint8_t logArgType(int) { return LOG_ARG_WORD; }
+constexpr uint8_t logArgType(unsigned int) { return LOG_ARG_WORD; }
+constexpr uint8_t logArgType(long) { return LOG_ARG_DWORD; }
+constexpr uint8_t logArgType(unsigned long) { return LOG_ARG_DWORD; }
+constexpr uint8_t logArgType(double) { return LOG_ARG_DWORD; }
+constexpr uint8_t logArgType(const char *) { return LOG_ARG_STRING; }
+constexpr uint8_t logArgType(const __FlashStringHelper *) { return LOG_ARG_WORD; }
+
+constexpr uint8_t logDescriptor()
+{
+  return 0;
+}
+
+template <typename A, typename... Rest> constexpr uint8_t logDescriptor(A arg, Rest... rest)
+{
+  return logArgType(arg) | (logDescriptor(rest...) << 2);
+}
+
+//! An argument, converted to what will be stored in the record
+union LogArg
+{
+  int16_t w;
+  int32_t dw;
+  float f;
+  const char *s;
+
+  LogArg(): dw(0) {}
+  LogArg(int x): w(x) {}
+  LogArg(unsigned int x): w(x) {}
+  LogArg(long x): dw(x) {}
+  LogArg(unsigned long x): dw(x) {}
+  LogArg(double x): f(x) {}
+  LogArg(const char *x): s(x) {}
+  LogArg(const __FlashStringHelper *x): w(reinterpret_cast<uintptr_t>(x)) {}
+};
+#else
+#define LOG_STR(s) F(s)
+#endif
+
+/**
+ * Logging is a helper class to output informations over
+ * RS232. If you know log4j or log4net, this logging class
+ * is more or less similar ;-) <br>
+ * Different loglevels can be used to extend or reduce output
+ * All methods are able to handle any number of output parameters.
+ * All methods print out a formated string (like printf).<br>
+ * To reduce output and program size, reduce loglevel.
+ * 
+ * Output format string can contain below wildcards. Every wildcard
+ * must be start with percent sign (\%)
+ * 
+ * ---- Wildcards
+ * 
+ * %s replace with a string (char*)
+ * %c replace with a character
+ * %d replace with an integer value
+ * %l replace with a long value
+ * %x replace and convert integer value to hex
+ * %X like %x but prefix with 0x
+ * %b replace and convert integer value to binary
+ * %B like %x but prefix with 0b
+ * %t replace and convert boolean value to "t" or "f"
+ * %T like %t but convert to "true" or "false"
+ * 
+ * ---- Loglevels
+ * 
+ * 0 - LOG_LEVEL_SILENT     no output
+ * 1 - LOG_LEVEL_FATAL      fatal errors
+ * 2 - LOG_LEVEL_ERROR      all errors
+ * 3 - LOG_LEVEL_WARN       errors and warnings
+ * 4 - LOG_LEVEL_INFO       errors, warnings and infos
+ * 5 - LOG_LEVEL_DEBUG      errors, warnings, infos, debugs
+ * 6 - LOG_LEVEL_TRACE      all
+ */
+
+class Logging
+{
+public:
+  /**
+   * default Constructor
+   */
+  Logging()
+#ifndef DISABLE_LOGGING
+    : _level(LOG_LEVEL_SILENT),
+    _showLevel(true),
+    _logOutput(NULL)
+#endif
+  {
+
+  }
+
+  /**
+   * Initializing, must be called as first. Note that if you use
+   * this variant of Init, you need to initialize the baud rate
+   * yourself, if printer happens to be a serial port.
+   * 
+   * \param level - logging levels <= this will be logged.
+   * \param printer - place that logging output will be sent to.
+   * \return void
+   *
+   */
+  void begin(int level, Print *logOutput, bool showLevel = true)
+  {
+#ifndef DISABLE_LOGGING
+    setLevel(level);
+    setShowLevel(showLevel);
+    _logOutput = logOutput;
+#ifdef ENABLE_BINARY_LOGGING
+    _ring.begin();
+    _dropped = 0;
+#endif
+#else
+	(void) level;
+	(void) logOutput;
+	(void) showLevel;
+#endif
+  }
+
+  /**
+   * Set the log level.
+   * 
+   * \param level - The new log level.
+   * \return void
+   */
+  void setLevel(int level)
+  {
+#ifndef DISABLE_LOGGING
+    _level = constrain(level, LOG_LEVEL_SILENT, LOG_LEVEL_TRACE);
+#else
+	(void) level;
+#endif
+  }
+
+  /**
+   * Get the log level.
+   *
+   * \return The current log level.
+   */
+  int getLevel() const
+  {
+#ifndef DISABLE_LOGGING
+    return _level;
+#else
+    return 0;
+#endif
+  }
+
+  /**
+   * Set whether to show the log level.
+   * 
+   * \param showLevel - true if the log level should be shown for each log
+   *                    false otherwise.
+   * \return void
+   */
+  void setShowLevel(bool showLevel)
+  {
+#ifndef DISABLE_LOGGING
+    _showLevel = showLevel;
+#else
+	(void) showLevel;
+#endif
+  }
+
+  /**
+   * Get whether the log level is shown during logging
+   * 
+   * \return true if the log level is be shown for each log
+   *         false otherwise.
+   */
+  bool getShowLevel() const
+  {
+#ifndef DISABLE_LOGGING
+    return _showLevel;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * Sets a function to be called before each log command.
+   * 
+   * \param f - The function to be called
+   * \return void
+   */
+  void setPrefix(printfunction f)
+  {
+#ifndef DISABLE_LOGGING
+    _prefix = f;
+#else
+	(void) f;
+#endif
+  }
+
+  /**
+   * Sets a function to be called after each log command.
+   * 
+   * \param f - The function to be called
+   * \return void
+   */
+  void setSuffix(printfunction f)
+  {
+#ifndef DISABLE_LOGGING
+    _suffix = f;
+#else
+	(void) f;
+#endif
+  }
+
+  /**
+   * Send buffered binary records, if any. Only whole records are sent and
+   * only as long as they fit in the output buffer, so this never blocks.
+   * Call it when there is nothing better to do.
+   *
+   * \return void
+   */
+  void loop()
+  {
+#ifdef ENABLE_BINARY_LOGGING
+    if (_logOutput != NULL)
+    {
+      int room = _logOutput->availableForWrite();
+      while (!_ring.empty() && _ring.peek(1) + 3 <= room)
+      {
+        const byte n = _ring.peek(1) + 3;
+        for (byte i = 0; i < n; ++i)
+        {
+          _logOutput->write(_ring.get());
+        }
+        room -= n;
+      }
+      pushDropped();
+    }
+#endif
+  }
+
+  /**
+   * Output a fatal error message. Output message contains
+   * F: followed by original message
+   * Fatal error messages are printed out at
+   * loglevels >= LOG_LEVEL_FATAL
+   * 
+   * \param msg format string to output
+   * \param ... any number of variables
+   * \return void
+   */
+  template <class T, typename... Args> void fatal(T msg, Args... args)
+  {
+#if !defined (DISABLE_LOGGING) && (!defined (THRESHOLD_LEVEL) || THRESHOLD_LEVEL >= LOG_LEVEL_FATAL)
+    printLevel(LOG_LEVEL_FATAL, msg, args...);
+#endif
+  }
+
+  /**
+   * Output an error message. Output message contains
+   * E: followed by original message
+   * Error messages are printed out at
+   * loglevels >= LOG_LEVEL_ERROR
+   * 
+   * \param msg format string to output
+   * \param ... any number of variables
+   * \return void
+   */
+  template <class T, typename... Args> void error(T msg, Args... args){
+#if !defined (DISABLE_LOGGING) && (!defined (THRESHOLD_LEVEL) || THRESHOLD_LEVEL >= LOG_LEVEL_ERROR)
+    printLevel(LOG_LEVEL_ERROR, msg, args...);
+#else
+	(void) msg;
+	//~ (void) args;
+#endif
+  }
+
+  /**
+   * Output a warning message. Output message contains
+   * W: followed by original message
+   * Warning messages are printed out at
+   * loglevels >= LOG_LEVEL_WARN
+   * 
+   * \param msg format string to output
+   * \param ... any number of variables
+   * \return void
+   */
+  template <class T, typename... Args> void warn(T msg, Args...args)
+  {
+#if !defined (DISABLE_LOGGING) && (!defined (THRESHOLD_LEVEL) || THRESHOLD_LEVEL >= LOG_LEVEL_WARN)
+    printLevel(LOG_LEVEL_WARN, msg, args...);
+#else
+	(void) msg;
+	//~ (void) args;
+#endif
+  }
+
+  /**
+   * Output a info message. Output message contains
+   * N: followed by original message
+   * Notice messages are printed out at
+   * loglevels >= LOG_LEVEL_INFO
+   * 
+   * \param msg format string to output
+   * \param ... any number of variables
+   * \return void
+   */
+  template <class T, typename... Args> void info(T msg, Args...args)
+  {
+#if !defined (DISABLE_LOGGING) && (!defined (THRESHOLD_LEVEL) || THRESHOLD_LEVEL >= LOG_LEVEL_INFO)
+    printLevel(LOG_LEVEL_INFO, msg, args...);
+#else
+	(void) msg;
+	//~ (void) args;
+#endif
+  }
+
+  /**
+   * Output a debug message. Output message contains
+   * N: followed by original message
+   * Trace messages are printed out at
+   * loglevels >= LOG_LEVEL_DEBUG
+   * 
+   * \param msg format string to output
+   * \param ... any number of variables
+   * \return void
+  */
+  template <class T, typename... Args> void debug(T msg, Args... args)
+  {
+#if !defined (DISABLE_LOGGING) && (!defined (THRESHOLD_LEVEL) || THRESHOLD_LEVEL >= LOG_LEVEL_DEBUG)
+    printLevel(LOG_LEVEL_DEBUG, msg, args...);
+#else
+	(void) msg;
+	//~ (void) args;
+#endif
+  }
+
+  /**
+   * Output a trace message. Output message contains
+   * V: followed by original message
+   * Debug messages are printed out at
+   * loglevels >= LOG_LEVEL_TRACE
+   * 
+   * \param msg format string to output
+   * \param ... any number of variables
+   * \return void
+   */
+  template <class T, typename... Args> void trace(T msg, Args... args)
+  {
+#if !defined (DISABLE_LOGGING) && (!defined (THRESHOLD_LEVEL) || THRESHOLD_LEVEL >= LOG_LEVEL_TRACE)
+    printLevel(LOG_LEVEL_TRACE, msg, args...);
+#else
+	(void) msg;
+	//~ (void) args;
+#endif
+  }
+  
+  /**
+   * Output a message at a given level.
+   * 
+   * \param msg format string to output
+   * \param ... any number of variables
+   * \return void
+   */
+  template <class T, typename... Args> void log(DebugLevel level, T msg, Args... args)
+  {
+#if !defined (DISABLE_LOGGING) && (!defined (THRESHOLD_LEVEL) || THRESHOLD_LEVEL >= level)
+    printLevel(level, msg, args...);
+#else
+	(void) level;
+	//~ (void) args;
+#endif
+  }
+
+private:
+#ifndef ENABLE_BINARY_LOGGING
+  void print(const char *format, va_list args)
+  {
+#ifndef DISABLE_LOGGING     
+    for (; *format != 0; ++format)
+    {
+      if (*format == '%')
+      {
+        ++format;
+        printFormat(*format, &args);
+      }
+      else
+      {
+        _logOutput->print(*format);
+      }
+    }
+#else
+	(void) format;
+	//~ (void) args;
+#endif
+  }
+
+  void print(const __FlashStringHelper *format, va_list args)
+  {
+#ifndef DISABLE_LOGGING     
+    PGM_P p = reinterpret_cast<PGM_P>(format);
+    char c = pgm_read_byte(p++);
+    for(;c != 0; c = pgm_read_byte(p++))
+    {
+      if (c == '%')
+      {
+        c = pgm_read_byte(p++);
+        printFormat(c, &args);
+      }
+      else
+      {
+        _logOutput->print(c);
+      }
+    }
+#else
+	(void) format;
+	(void) args;
+#endif
+  }
+
+  void printFormat(const char format, va_list *args)
+  {
+#ifndef DISABLE_LOGGING
+    if (format == '%')
+    {
+      _logOutput->print(format);
+    }
+    else if (format == 's')
+    {
+      register char *s = (char *)va_arg(*args, int);
+      _logOutput->print(s);
+    }
+    else if (format == 'S')
+    {
+      register __FlashStringHelper *s = (__FlashStringHelper *)va_arg(*args, int);
+      _logOutput->print(s);
+    }
+    else if (format == 'd' || format == 'i')
+    {
+      _logOutput->print(va_arg(*args, int), DEC);
+    }
+    else if (format == 'D' || format == 'F')
+    {
+      _logOutput->print(va_arg(*args, double));
+    }
+    else if (format == 'x')
+    {
+      _logOutput->print(va_arg(*args, int), HEX);
+    }
+    else if (format == 'X')
+    {
+      _logOutput->print("0x");
+      _logOutput->print(va_arg(*args, int), HEX);
+    }
+    else if (format == 'b')
+    {
+      _logOutput->print(va_arg(*args, int), BIN);
+    }
+    else if (format == 'B')
+    {
+      _logOutput->print("0b");
+      _logOutput->print(va_arg(*args, int), BIN);
+    }
+    else if (format == 'l')
+    {
+      _logOutput->print(va_arg(*args, long), DEC);
+    }
+    else if (format == 'u')
+    {
+      _logOutput->print(va_arg(*args, unsigned long), DEC);
+    }
+    else if (format == 'U')
+    {
+      _logOutput->print("0x");
+      _logOutput->print(va_arg(*args, unsigned long), HEX);
+    }
+    else if (format == 'w')
+    {
+      _logOutput->print(va_arg(*args, word), DEC);
+    }
+    else if (format == 'c')
+    {
+      _logOutput->print((char) va_arg(*args, int));
+    }
+    else if(format == 't')
+    {
+      if (va_arg(*args, int) == 1)
+      {
+        _logOutput->print("T");
+      }
+      else
+      {
+        _logOutput->print("F");
+      }
+    }
+    else if (format == 'T')
+    {
+      if (va_arg(*args, int) == 1)
+      {
+        _logOutput->print(F("true"));
+      }
+      else
+      {
+        _logOutput->print(F("false"));
+      }
+    }
+#else
+	(void) format;
+	(void) args;
+#endif
+  }
+#endif
+
+#ifdef ENABLE_BINARY_LOGGING
+  /* All the work is done by writeRecord(), so that call sites only need to
+   * convert their arguments and pass a compile-time descriptor along
+   */
+  template <class T, typename... Args> void printLevel(int level, T msg, Args... args)
+  {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Too many arguments for a binary log record");
+    constexpr uint8_t desc = logDescriptor(Args()...);
+
+    if (level <= _level)
+    {
+      const LogArg packed[] = {LogArg(args)..., LogArg()};
+      record(level, msg, desc, packed);
+    }
+  }
+
+  void record(byte level, LogMessageId msg, uint8_t desc, const LogArg *args)
+  {
+    writeRecord(level | LOG_RECORD_INTERNED, msg.id, desc, NULL, args);
+  }
+
+  void record(byte level, const __FlashStringHelper *msg, uint8_t desc, const LogArg *args)
+  {
+    writeRecord(level, reinterpret_cast<uintptr_t>(msg), desc, NULL, args);
+  }
+
+  void record(byte level, const char *msg, uint8_t desc, const LogArg *args)
+  {
+    writeRecord(level, LOG_ID_RAM, desc, msg, args);
+  }
+
+  __attribute__((noinline)) void writeRecord(byte level, uint16_t id, uint8_t desc, const char *format, const LogArg *args)
+  {
+    byte rec[LOG_MAX_RECORD_LEN];
+    byte len = 0;
+    rec[len++] = level;
+    len = packBytes(rec, len, &id, sizeof(id));
+    rec[len++] = desc;
+    if (format != NULL)
+    {
+      len = packString(rec, len, format);
+    }
+
+    for (; desc != 0; desc >>= 2, ++args)
+    {
+      switch (desc & 0x03)
+      {
+      case LOG_ARG_WORD:
+        len = packBytes(rec, len, &args->w, sizeof(args->w));
+        break;
+      case LOG_ARG_DWORD:
+        len = packBytes(rec, len, &args->dw, sizeof(args->dw));
+        break;
+      case LOG_ARG_STRING:
+        len = packString(rec, len, args->s);
+        break;
+      }
+    }
+
+    push(rec, len);
+  }
+
+  static byte packBytes(byte *rec, byte len, const void *p, byte n)
+  {
+    // Arguments that do not fit are dropped, the decoder will notice
+    if (len + n <= LOG_MAX_RECORD_LEN)
+    {
+      memcpy(rec + len, p, n);
+      len += n;
+    }
+
+    return len;
+  }
+
+  static byte packString(byte *rec, byte len, const char *s)
+  {
+    byte n = strlen(s);
+    if (n > LOG_MAX_STRING_LEN)
+    {
+      n = LOG_MAX_STRING_LEN;
+    }
+
+    if (len + 1 + n <= LOG_MAX_RECORD_LEN)
+    {
+      rec[len++] = n;
+      len = packBytes(rec, len, s, n);
+    }
+
+    return len;
+  }
+
+  // Frame a record into the ring, if there is room for it
+  void push(const byte *rec, const byte len)
+  {
+    pushDropped();
+
+    if (_ring.free() > 3 + len)
+    {
+      byte sum = len;
+      _ring.put(LOG_RECORD_SOF);
+      _ring.put(len);
+      for (byte i = 0; i < len; ++i)
+      {
+        _ring.put(rec[i]);
+        sum += rec[i];
+      }
+      _ring.put(static_cast<byte>(-sum));
+    }
+    else if (_dropped < 0xFFFF)
+    {
+      ++_dropped;
+    }
+  }
+
+  // Tell the decoder how many records did not fit, as soon as there is room
+  void pushDropped()
+  {
+    if (_dropped > 0 && _ring.free() > 3 + 6)
+    {
+      const byte lost[] = {0, 0, 0, LOG_ARG_WORD, static_cast<byte>(_dropped & 0xFF), static_cast<byte>(_dropped >> 8)};
+      _dropped = 0;
+      push(lost, sizeof(lost));
+    }
+  }
+#else
+  template <class T> void printLevel(int level, T msg, ...)
+  {
+#ifndef DISABLE_LOGGING
+    if (level > _level)
+    {
+      return;
+    }
+
+    if (_prefix != NULL)
+    {
+      _prefix(_logOutput);
+    }
+
+    if (_showLevel) {
+      static const char levels[] = "FEWIDT";
+      _logOutput->print(level < 7 ? levels[level - 1] : '?');
+      _logOutput->print(": ");
+    }
+
+    va_list args;
+    va_start(args, msg);
+    print(msg, args);
+
+    if(_suffix != NULL)
+    {
+      _suffix(_logOutput);
+    }
+#endif
+  }
+#endif
+
+#ifndef DISABLE_LOGGING
+  int _level;
+  bool _showLevel;
+  Print* _logOutput;
+
+  printfunction _prefix = NULL;
+  printfunction _suffix = NULL;
+
+#ifdef ENABLE_BINARY_LOGGING
+  CircularBuffer<byte, byte, LOG_RING_SIZE> _ring;
+  word _dropped;
+#endif
+#endif
+};
+
+extern Logging Log;
+#endif
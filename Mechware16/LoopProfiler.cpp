@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file LoopProfiler.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Main loop timing profiler
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include "LoopProfiler.h"
+
+void LoopProfiler::begin () {
+#ifndef MECHWARE16_HOST
+	// Same as LatencyStats: normal mode, clk/64, no interrupts
+	TCCR1A = 0;
+	TCCR1B = _BV (CS11) | _BV (CS10);
+	TIMSK1 = 0;
+#endif
+
+	reset ();
+}
+
+void LoopProfiler::reset () {
+	for (byte i = 0; i < N_LOOP_STAGES; ++i) {
+		LoopStageStats& s = stats[i];
+		s.min = 0xFFFF;
+		s.max = 0;
+		s.total = 0;
+		s.count = 0;
+	}
+
+	resetTime = millis ();
+	begin_ = last = now ();
+}
+
+void LoopProfiler::add (const LoopStage s, const word ticks) {
+	LoopStageStats& st = stats[s];
+	if (ticks < st.min) {
+		st.min = ticks;
+	}
+	if (ticks > st.max) {
+		st.max = ticks;
+	}
+	st.total += ticks;
+	++st.count;
+}
@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file LoopProfiler.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Main loop timing profiler
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+
+//! \brief Parts of the main loop that are timed separately
+enum LoopStage: byte {
+	LOOPSTAGE_COMBOS,			//!< Checking for key combos
+	LOOPSTAGE_SCANNER_LOOP,		//!< Scanner housekeeping
+	LOOPSTAGE_SETTINGS,			//!< Committing settings
+	LOOPSTAGE_COMMS,			//!< Serial commands and log output
+	LOOPSTAGE_SCAN,				//!< Keyboard scan
+	LOOPSTAGE_HANDLE,			//!< Generating key events
+	LOOPSTAGE_LEDS,				//!< Polling and updating leds
+	LOOPSTAGE_ITERATION,		//!< Whole loop() iteration
+	N_LOOP_STAGES
+};
+
+//! \brief Timing statistics of a loop stage, in timer ticks
+struct LoopStageStats {
+	word min;
+	word max;
+	unsigned long total;
+	unsigned long count;		//!< Times the stage was run
+};
+
+/** \brief Main loop timing profiler
+ *
+ * The loop calls start() at the beginning, mark() at the end of every stage
+ * and end() at the end. Stages that are skipped in an iteration are just not
+ * marked, and their time goes to the next stage that is.
+ *
+ * Timestamps are taken from Timer 1, set up exactly as #LatencyStats does, so
+ * the two can be used together: a tick is #CYCLES_PER_TICK CPU cycles and
+ * stages lasting longer than 262 ms are not measured correctly. Single
+ * readings can be off by one tick, but since stages start at random points
+ * between ticks, means are accurate well below that.
+ *
+ * Use the PROFILE_*() macros in code, so that nothing is left when
+ * #ENABLE_LOOP_PROFILER is not defined.
+ */
+class LoopProfiler {
+public:
+	static constexpr byte CYCLES_PER_TICK = 64;
+	static constexpr byte US_PER_TICK = 4;
+
+	//! \brief Start the timer and clear all statistics
+	void begin ();
+
+	//! \brief Clear all statistics
+	void reset ();
+
+	static word now () {
+#ifdef MECHWARE16_HOST
+		return micros () / US_PER_TICK;
+#else
+		return TCNT1;
+#endif
+	}
+
+	//! \brief Beginning of a loop iteration
+	inline void start () {
+		begin_ = last = now ();
+	}
+
+	//! \brief End of stage \a s, which began at the previous mark
+	inline void mark (const LoopStage s) {
+		const word t = now ();
+		add (s, t - last);
+		last = t;
+	}
+
+	//! \brief End of a loop iteration
+	inline void end () {
+		add (LOOPSTAGE_ITERATION, now () - begin_);
+	}
+
+	const LoopStageStats& getStats (const LoopStage s) const {
+		return stats[s];
+	}
+
+	//! \brief Time since the last reset, to turn iteration counts into rates
+	unsigned long getElapsedMillis () const {
+		return millis () - resetTime;
+	}
+
+private:
+	LoopStageStats stats[N_LOOP_STAGES];
+
+	unsigned long resetTime;
+
+	word begin_;
+
+	word last;
+
+	void add (const LoopStage s, const word ticks);
+};
+
+#ifdef ENABLE_LOOP_PROFILER
+extern LoopProfiler loopProfiler;
+
+#define PROFILE_START() loopProfiler.start ()
+#define PROFILE_MARK(s) loopProfiler.mark (s)
+#define PROFILE_END() loopProfiler.end ()
+#else
+#define PROFILE_START()
+#define PROFILE_MARK(s)
+#define PROFILE_END()
+#endif
@@ -29,8 +29,3 @@ struct MatrixCoordinates {
  * Built by buildLedCoordinates().
  */
 extern MatrixCoordinates ledCoordinates[N_PHYSICAL_KEYS];
-
-/* Maps a key to the (row, col) tuple describing its position in the keyboard matrix, useful for quick lookups.
- * Built by buildKeyCoordinates().
- */
-extern MatrixCoordinates keyCoordinates[N_PHYSICAL_KEYS];
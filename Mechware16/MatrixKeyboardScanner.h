@@ -19,69 +19,19 @@
 #include "config.h"
 #include "Matrix.h"
 #include "KeyboardScanner.h"
+#include "KeymapOverrides.h"
+#ifdef USE_KEY_LAYERS
+#include "KeyLayers.h"
+#endif
+#include "MatrixPorts.h"
+#include "Debouncers.h"
+#include "AdaptiveDebouncer.h"
+#include "LatencyStats.h"
+#include "MatrixTrace.h"
 #include "Log.h"
 
 /******************************************************************************/
 
-/** \brief Abstract output port for matrix scanning (Template class)
- * 
- * This is just syntactic sugar that will allow us to use template
- * specialization.
- */
-template <byte NBITS>
-class OutputPort {	// Inheritance is not needed, we rely on template specialization
-	// Do not implement anything, so compilation will fail if this is actually instantiated (it is not supposed to be!)
-};
-
-//! \brief 8-bit output port for matrix scanning
-template <>
-class OutputPort<8>	{
-public:
-	void begin () {
-		clearAllBits ();
-	}
-	
-	void setBit (byte n) {
-		DDRB = 1 << n;	// Port B is all inputs except bit n
-		PORTB = ~DDRB;	// Disable pull-up and bring line low
-	}
-
-	void clearAllBits () {
-		DDRB  = 0x00;   // Port B all inputs...
-		PORTB = 0xFF;   // ... with pull-ups		
-	}
-};
-
-/******************************************************************************/
-
-template <byte NBITS, typename RTYPE>
-class InputPort {
-	// Same as above, not supposed to be instantiated
-};
-
-/** \brief 8-bit input port for matrix scanning
- * 
- * The port is obtained by "merging" bits of different ports of the ATmega:
- * - Bits 0-1 are bits 0-1 of port of port F
- * - Bits 2-7 are bits 2-7 of port D
- *
- */
-template <>
-class InputPort<8, byte> {
-public:
-	void begin () {
-		// All inputs with pull-ups
-		PORTD = 0xFF;
-		DDRD = 0x00;
-	}
-	
-	byte read () {
-		return PIND;
-	}
-};
-
-/******************************************************************************/
-
 /** \brief Generic key mapper
  * 
  * Translate a matrix scan into keypresses.
@@ -94,28 +44,78 @@ private:
 	 * This is a <em>pointer to a matrix</em>, beware the weird syntax!
 	 */
 	const Key (*keymap)[NUMCOLS];
+
+	//! \brief Number of the keymap in use, for #KeymapOverrides
+	byte layer = 0;
+
+#ifdef USE_KEY_LAYERS
+	KeyLayers<NUMROWS, NUMCOLS> layers;
+#endif
 	
 public:
 	typedef MatrixBase<NUMROWS, TYPECOLS> Matrix;
 
+#ifdef USE_KEY_LAYERS
+	typedef typename KeyLayers<NUMROWS, NUMCOLS>::Table LayerTable;
+#endif
+
 	/** \brief Initialize the KeyMapper
 	 *
 	 * \param[in] mtx An initial matrix read the mapper can use to select what
 	 *                configuration to start up in
 	 * \return True if successful, false otherwise
 	 */
-	virtual boolean begin (const Matrix& mtx) {
+	DISPATCH_VIRTUAL boolean begin (const Matrix& mtx) {
 		(void) mtx;
 		return true;
 	}
 
+	/** \brief Change the mapping mode
+	 *
+	 * Mappers that only support a single mode can ignore this, so a do-nothing
+	 * default implementation is provided.
+	 *
+	 * \param[in] md The new mapping mode
+	 */
+	DISPATCH_VIRTUAL void setMode (const KeyMapMode md) {
+		(void) md;
+	}
+
 	/** \brief Sets/changes the keymap
 	 * 
 	 * \param[in] _keymap The keymap to be used from now on
+	 * \param[in] _layer Number identifying the keymap in #KeymapOverrides
 	 */
-	void setKeyMap (const word _keymap[NUMROWS][NUMCOLS]) {
+	void setKeyMap (const word _keymap[NUMROWS][NUMCOLS], const byte _layer = 0) {
 		keymap = _keymap;
+		layer = _layer;
+#ifdef USE_KEY_LAYERS
+		layers.setBase (keymap, layer);
+#endif
 	}
+
+#ifdef USE_KEY_LAYERS
+	/** \brief Sets/changes the Fn layers, see #KeyLayers
+	 *
+	 * \param[in] tables Layers, lowest first
+	 * \param[in] n Number of layers
+	 * \param[in] _layer Number identifying the first layer in #KeymapOverrides
+	 */
+	void setLayers (const LayerTable *tables, const byte n, const byte _layer) {
+		layers.setLayers (tables, n, _layer);
+	}
+#endif
+
+#ifdef ENABLE_TAP_HOLD
+	/** \brief Sets/changes the dual-role keys, see #TapHold
+	 *
+	 * \param[in] table Dual-role keys, in flash
+	 * \param[in] n Number of entries in the table
+	 */
+	void setDualRoleKeys (const DualRoleKey *table, const byte n) {
+		layers.setDualRoleKeys (table, n);
+	}
+#endif
 	
 	/** \brief Map a matrix to keypresses
 	 * 
@@ -124,22 +124,41 @@ public:
 	 *                  stored
 	 * \return The number of keypresses detected
 	 */
-	virtual byte map (const Matrix& mtx, KeyBuffer& kbuf) {
+	DISPATCH_VIRTUAL byte map (const Matrix& mtx, KeyBuffer& kbuf) {
 		byte ret = 0;
 
 		if (keymap) {
+#ifdef USE_KEY_LAYERS
+			KeyState pressed;
+			for (byte row = 0; row < NUMROWS; ++row) {
+				pressed.setRow (row, ~mtx[row] & ((1 << NUMCOLS) - 1));
+			}
+			layers.update (pressed);
+#endif
+
 			/* Process all rows for key-codes */
 			for (byte row = 0; row < NUMROWS; ++row) {
 				for (TYPECOLS col = 0, mask = 1; col < NUMCOLS; ++col, mask <<= 1) {
 					if ((mtx[row] & mask) == 0) {
 						/* Key pressed! Read keyboard map */
 #ifdef ENABLE_MATRIX_DEBUG
-						Log.debug (F("Detected key pressed at row %d, col %d\n"), (int) row, (int) col);
+						Log.debug (LOG_STR ("Detected key pressed at row %d, col %d\n"), (int) row, (int) col);
 #endif
+#ifdef USE_KEY_LAYERS
+						Key key;
+						if (!layers.map (row, col, key)) {
+							// Layer key, already taken care of by layers.update()
+							continue;
+						}
+#else
+						Key key;
+						if (!keymapOverrides.lookup (layer, row, col, key)) {
 #ifdef KEYMAPS_IN_FLASH
-						const Key key = pgm_read_word (&keymap[row][col]);
+							key = pgm_read_word (&keymap[row][col]);
 #else
-						const Key key = keymap[row][col];
+							key = keymap[row][col];
+#endif
+						}
 #endif
 						if (key != 0) {
 							if (!kbuf.full ()) {
@@ -150,15 +169,19 @@ public:
 								};
 								kbuf.append (evt);
 							} else {
-								Log.error (F("Key buffer is full\n"));
+								Log.error (LOG_STR ("Key buffer is full\n"));
 							}
 						} else {
-							Log.warn (F("Skipping unmapped key\n"));
+							Log.warn (LOG_STR ("Skipping unmapped key\n"));
 						}
 					}
 				}
 			}
 
+#ifdef ENABLE_TAP_HOLD
+			layers.appendTapped (kbuf);
+#endif
+
 			ret = kbuf.size;
 		}
 
@@ -177,98 +200,194 @@ public:
  *   outputs.
  * - The resulting matrix is finally fed to a #KeyMapper, which translates it
  *   into the actual keypresses.
+ *
+ * Rows and columns are on the default ports unless \a ROWPORT_T and
+ * \a COLPORT_T say otherwise, see PinPorts.h for ports on arbitrary pins.
+ * Likewise, readings are debounced by #DEBOUNCER unless \a DEBOUNCER_T is
+ * given, see Debouncers.h.
  */
-template<byte NUMROWS, byte NUMCOLS, typename TYPECOLS, byte DEBOUNCE_LENGTH, typename MAPPER_T>
+template<byte NUMROWS, byte NUMCOLS, typename TYPECOLS, byte DEBOUNCE_LENGTH, typename MAPPER_T,
+         typename ROWPORT_T = OutputPort<NUMROWS>, typename COLPORT_T = InputPort<NUMCOLS, TYPECOLS>,
+         typename DEBOUNCER_T = DEBOUNCER<NUMROWS, NUMCOLS, TYPECOLS> >
 class MatrixKeyboardScanner: public KeyboardScanner {
 private:
-	byte debounce = DEBOUNCE_LENGTH;
+	byte debounceLength = DEBOUNCE_LENGTH;
+
+	DEBOUNCER_T debouncer;
+
 
 public:
 	typedef MatrixBase<NUMROWS, TYPECOLS> Matrix;
 
 protected:
-	OutputPort<NUMROWS> outPort;			// Rows
-	InputPort<NUMCOLS, TYPECOLS> inPort;	// Columns
+	ROWPORT_T outPort;	// Rows
+	COLPORT_T inPort;	// Columns
 
 	Matrix matrix;
 
+#ifdef ENABLE_LATENCY_STATS
+	//! \brief Debounced matrix as it was when it could last be used
+	Matrix settledMatrix;
+#endif
+
 	MAPPER_T mapper;
 
+#ifdef ENABLE_MATRIX_TRACE
+	static_assert (NUMROWS <= MatrixTrace::MAX_ROWS && sizeof (TYPECOLS) == 1, "Matrix traces only support up to 8 rows of 8 columns");
+#endif
+
 	/** \brief Clear the keyboard matrix
 	 * 
 	 * All matrix points are marked as released.
 	 */
 	void clearMatrix () {
 		for (byte row = 0; row < NUMROWS; ++row) {
-			matrix[row] = 0xFF;
+			matrix[row] = static_cast<TYPECOLS> (~0);
+#ifdef ENABLE_LATENCY_STATS
+			settledMatrix[row] = matrix[row];
+#endif
 		}
 	}
 
+	//! \brief Read the columns of a single row
+	TYPECOLS readRow (const byte row) {
+		// Set a single row to ground
+		outPort.setBit (row);
+
+		// Wait for things to settle and then read column output
+		delayMicroseconds (30);
+		const TYPECOLS data = inPort.read ();
+#ifdef ENABLE_MATRIX_TRACE
+		matrixTrace.row (row, data);
+#endif
+
+		return data;
+	}
+
 public:
-	virtual boolean begin () override {
+	DISPATCH_VIRTUAL boolean begin () DISPATCH_OVERRIDE {
 		clearMatrix ();
 		outPort.begin ();
 		inPort.begin ();
 
 		// Do an initial read we can provide mapper.begin() with
+		for (byte row = 0; row < NUMROWS; ++row) {
+			matrix[row] = readRow (row);
+		}
+		outPort.clearAllBits ();
+		debouncer.begin (matrix, debounceLength);
 		while (scanMatrix () != SCAN_COMPLETE)
 			;
 
 		return mapper.begin (matrix);
 	}
 
-	virtual boolean end () override {
+	DISPATCH_VIRTUAL boolean end () DISPATCH_OVERRIDE {
 		return true;
 	}
-	
-	/* This function scans the entire keyboard, debounces the keys, and
-	 * if a key change has been found, a new report is generated, and the
-	 * function returns true to signal the transfer of the report
+
+	DISPATCH_VIRTUAL void setKeyMapMode (const KeyMapMode mode) DISPATCH_OVERRIDE {
+		mapper.setMode (mode);
+	}
+
+	/* Rows are inputs with pull-ups when idle, so just pull all columns low and
+	 * any key will pull its row down
+	 */
+	DISPATCH_VIRTUAL boolean suspend () DISPATCH_OVERRIDE {
+		outPort.clearAllBits ();
+		inPort.driveLow ();
+		return true;
+	}
+
+	DISPATCH_VIRTUAL void resume () DISPATCH_OVERRIDE {
+		inPort.begin ();
+	}
+
+	DISPATCH_VIRTUAL void setDebounce (const byte length) DISPATCH_OVERRIDE {
+		debounceLength = length > 0 ? length : 1;
+		debouncer.setLength (debounceLength);
+	}
+
+#ifdef ENABLE_ADAPTIVE_DEBOUNCE
+	DISPATCH_VIRTUAL const BounceStats *getBounceStats (const byte row, const byte col) const DISPATCH_OVERRIDE {
+		return row < NUMROWS && col < NUMCOLS ? debouncer.getStats (row, col) : NULL;
+	}
+
+	DISPATCH_VIRTUAL void resetBounceStats () DISPATCH_OVERRIDE {
+		debouncer.resetStats ();
+	}
+#endif
+
+	/* This function scans the entire keyboard and debounces the keys, then
+	 * returns whether the matrix can be used
 	 */
 	ScanStatus scanMatrix () {
-		ScanStatus scanStatus = SCAN_IN_PROGRESS;
+#ifdef ENABLE_LATENCY_STATS
+		// Some key reads pressed, but is not debounced as such yet
+		boolean pending = false;
+#endif
 
-		/* Scan all rows */
 		for (byte row = 0; row < NUMROWS; ++row) {
-			// Set a single row to ground
-			outPort.setBit (row);
-			
-			// Wait for things to settle and then read column output
-			delayMicroseconds (30);
-			TYPECOLS data = inPort.read ();
-
-			// If a change was detected, activate debounce counter
-			if (matrix[row] != data) {
-				debounce = DEBOUNCE_LENGTH; 
+			const TYPECOLS data = readRow (row);
+#ifdef ENABLE_LATENCY_STATS
+			if (debouncer.getRaw (row) & ~data) {
+				// Some column just went low
+				latencyStats.mark (LATSTAGE_DETECTED);
 			}
-
-			// Store the result
-			matrix[row] = data; 
+#endif
+			matrix[row] = debouncer.update (row, data);
+#ifdef ENABLE_LATENCY_STATS
+			if (matrix[row] & ~data) {
+				pending = true;
+			}
+#endif
 		}
 		outPort.clearAllBits ();
+#ifdef ENABLE_MATRIX_TRACE
+		matrixTrace.scanned ();
+#endif
 
-		// Count down, but avoid underflow
-		if (debounce > 1) {
-			debounce--;
-		} else {
-			// Readings are stable
+		ScanStatus scanStatus = SCAN_IN_PROGRESS;
+		if (debouncer.settled ()) {
 			scanStatus = SCAN_COMPLETE;
+#ifdef ENABLE_LATENCY_STATS
+			boolean pressed = false;
+			for (byte row = 0; row < NUMROWS; ++row) {
+				if (settledMatrix[row] & ~matrix[row]) {
+					pressed = true;
+				}
+				settledMatrix[row] = matrix[row];
+			}
+
+			if (pressed) {
+				// Some key is now pressed for good
+				latencyStats.mark (LATSTAGE_SETTLED);
+			} else if (!pending) {
+				/* Whatever went low bounced back without becoming a press,
+				 * wait for the next one
+				 */
+				latencyStats.cancel (LATSTAGE_SETTLED);
+			}
+#endif
 		}
 
 		return scanStatus;
 	}
 
-	virtual void loop () override {
+	DISPATCH_VIRTUAL void loop () DISPATCH_OVERRIDE {
 		/* The debouncing algorithm needs the matrix to be scanned as often as
 		 * possible
 		 */
 		scanMatrix ();
 	}
 	
-	virtual ScanStatus scan (KeyBuffer& buf) override {
+	DISPATCH_VIRTUAL ScanStatus scan (KeyBuffer& buf) DISPATCH_OVERRIDE {
 		ScanStatus scanStatus = scanMatrix ();
 		if (scanStatus == SCAN_COMPLETE) {
 			mapper.map (matrix, buf);
+#ifdef ENABLE_LATENCY_STATS
+			latencyStats.mark (LATSTAGE_BUFFERED);
+#endif
 		}
 
 		return scanStatus;
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file MatrixPorts.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief I/O ports for matrix scanning
+ *
+ * Ports are the only place where scanners touch the hardware. The default
+ * ones are made of pins listed as in PinPorts.h, which work on the host too
+ * (i.e. when MECHWARE16_HOST is defined), reading a simulated keyboard matrix.
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "PinPorts.h"
+
+/******************************************************************************/
+
+/** \brief Abstract output port for matrix scanning (Template class)
+ *
+ * This is just syntactic sugar that will allow us to use template
+ * specialization.
+ */
+template <byte NBITS>
+class OutputPort {	// Inheritance is not needed, we rely on template specialization
+	// Do not implement anything, so compilation will fail if this is actually instantiated (it is not supposed to be!)
+};
+
+/******************************************************************************/
+
+template <byte NBITS, typename RTYPE>
+class InputPort {
+	// Same as above, not supposed to be instantiated
+};
+
+/******************************************************************************/
+
+//! \brief 8-bit output port for matrix scanning, port B
+template <>
+class OutputPort<8>: public OutputPins<
+	AvrPin<AVRPORT_B, 0>, AvrPin<AVRPORT_B, 1>, AvrPin<AVRPORT_B, 2>, AvrPin<AVRPORT_B, 3>,
+	AvrPin<AVRPORT_B, 4>, AvrPin<AVRPORT_B, 5>, AvrPin<AVRPORT_B, 6>, AvrPin<AVRPORT_B, 7>
+> {
+};
+
+//! \brief 8-bit input port for matrix scanning, port D
+template <>
+class InputPort<8, byte>: public InputPins<byte,
+	AvrPin<AVRPORT_D, 0>, AvrPin<AVRPORT_D, 1>, AvrPin<AVRPORT_D, 2>, AvrPin<AVRPORT_D, 3>,
+	AvrPin<AVRPORT_D, 4>, AvrPin<AVRPORT_D, 5>, AvrPin<AVRPORT_D, 6>, AvrPin<AVRPORT_D, 7>
+> {
+};
+
+/******************************************************************************/
+
+#ifndef MECHWARE16_HOST
+
+/** \brief Input line of the RESTORE key of C64/VIC-20 keyboards
+ *
+ * RESTORE is not part of the matrix, it just shorts its line to ground. It is
+ * wired to PE6 (Arduino pin 7).
+ */
+class RestorePort {
+public:
+	void begin () {
+		// Input with pull-up
+		DDRE &= ~_BV (6);
+		PORTE |= _BV (6);
+	}
+
+	//! \brief True while RESTORE is pressed
+	boolean read () {
+		return (PINE & _BV (6)) == 0;
+	}
+};
+
+#endif
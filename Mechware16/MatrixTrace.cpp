@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file MatrixTrace.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Recording of raw scanner input
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include "MatrixTrace.h"
+
+//! \brief Longest record: header with a 32-bit varint, plus another varint
+static constexpr byte MAX_RECORD_LEN = 9;
+
+//! \brief Encode \a v as a varint into \a p, return its length
+static byte varint (byte *p, unsigned long v) {
+	byte len = 0;
+	do {
+		p[len++] = (v & 0x7F) | (v > 0x7F ? 0x80 : 0x00);
+		v >>= 7;
+	} while (v > 0);
+
+	return len;
+}
+
+void MatrixTrace::start (const TraceSource src, const byte keymapMode, const byte debounce) {
+	ring.begin ();
+	memset (last, 0xFF, sizeof (last));
+	pending = 0;
+	lastTick = millis ();
+	overflow = false;
+	recording = true;
+
+	byte rec[MAX_RECORD_LEN];
+	byte len = header (rec, TRACE_START, src);
+	rec[len++] = keymapMode;
+	rec[len++] = debounce;
+	put (rec, len);
+}
+
+byte MatrixTrace::read (byte *buf, const byte size) {
+	byte n = 0;
+	while (n < size && ring.available () > 0) {
+		buf[n++] = ring.get ();
+	}
+
+	return n;
+}
+
+byte MatrixTrace::header (byte *p, const TraceRecord type, const unsigned long arg) {
+	byte len = 1;
+	if (arg < TRACE_ARG_VARINT) {
+		p[0] = (type << 5) | arg;
+	} else {
+		p[0] = (type << 5) | TRACE_ARG_VARINT;
+		len += varint (p + 1, arg);
+	}
+
+	return len;
+}
+
+boolean MatrixTrace::put (const byte *rec, const byte len) {
+	// The ring always keeps a free slot
+	const boolean ret = ring.free () > len;
+	if (ret) {
+		for (byte i = 0; i < len; ++i) {
+			ring.put (rec[i]);
+		}
+	} else {
+		recording = false;
+		overflow = true;
+	}
+
+	return ret;
+}
+
+void MatrixTrace::flush () {
+	if (pending > 0) {
+		byte rec[MAX_RECORD_LEN];
+		put (rec, header (rec, TRACE_SCANS, pending));
+		pending = 0;
+	}
+}
+
+void MatrixTrace::changed (const byte r, const byte cols) {
+	// The change belongs to the scan in progress, which is not counted yet
+	flush ();
+
+	byte rec[MAX_RECORD_LEN];
+	byte len = header (rec, TRACE_ROW, r);
+	rec[len++] = cols;
+	if (put (rec, len)) {
+		last[r] = cols;
+	}
+}
+
+void MatrixTrace::tick () {
+	if (recording) {
+		const unsigned long now = millis ();
+
+		byte rec[MAX_RECORD_LEN];
+		byte len = header (rec, TRACE_TICK, now - lastTick);
+		len += varint (rec + len, pending);
+		if (put (rec, len)) {
+			pending = 0;
+			lastTick = now;
+		}
+	}
+}
+
+void MatrixTrace::value (const TraceRecord type, const byte v) {
+	if (recording) {
+		flush ();
+
+		byte rec[MAX_RECORD_LEN];
+		put (rec, header (rec, type, v));
+	}
+}
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file MatrixTrace.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Recording of raw scanner input
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+#include "CircularBuffer.h"
+
+/** \brief Types of trace records
+ *
+ * Every record starts with a byte holding the type in bits 7-5 and an argument
+ * in bits 4-0. Arguments that do not fit are stored as #TRACE_ARG_VARINT,
+ * followed by the actual value as a varint (7 bits per byte, least significant
+ * first, bit 7 set on all bytes but the last). Any other bytes follow.
+ */
+enum TraceRecord: byte {
+	TRACE_START,		//!< Arg: #TraceSource, then keymap mode and debounce length bytes
+	TRACE_ROW,			//!< Arg: row, then the columns it reads from the next scan on
+	TRACE_SCANS,		//!< Arg: number of scans done by loop() with nothing changing
+	TRACE_SAMPLE,		//!< No arg, rows and columns of a passive scanner sample follow
+	TRACE_TICK,			//!< Arg: ms since the previous tick, then the number of scans since the previous record (varint)
+	TRACE_MODE,			//!< Arg: new keymap mode
+	TRACE_DEBOUNCE,		//!< Arg: new debounce length
+	TRACE_RESTORE		//!< Arg: 1 if RESTORE was pressed, 0 if released
+};
+
+//! \brief Argument value meaning that a varint follows
+const byte TRACE_ARG_VARINT = 0x1F;
+
+//! \brief Scanner a trace was recorded from
+enum TraceSource: byte {
+	TRACESRC_C16,
+	TRACESRC_C64,
+	TRACESRC_VIC20,
+	TRACESRC_PASSIVE16
+};
+
+/** \brief Recorder of raw scanner input
+ *
+ * Traces hold what scanners read, in a form that can be fed to them again,
+ * together with the times at which their scan() method was called, so that
+ * the whole press-to-report path can be replayed off-target (see the replay
+ * tool in host/).
+ *
+ * Only changes are stored:
+ * - Matrix scanners report all the rows they read, but a #TRACE_ROW record is
+ *   only added when a row reads differently than it did in the previous scan.
+ *   The scans in between are counted.
+ * - The passive scanner reports the samples it processes, but only those that
+ *   change its matrix, or that it cannot make sense of, are kept.
+ *
+ * The main loop calls tick() after every scan(), which adds a #TRACE_TICK
+ * with the scans counted so far, the last of which is the one done by scan().
+ *
+ * Records are queued in a RAM ring, which is emptied by read() while recording
+ * goes on. If a record does not fit, recording stops, so that whatever was
+ * recorded can still be replayed.
+ */
+class MatrixTrace {
+public:
+	static constexpr byte MAX_ROWS = 8;
+
+	//! \brief Status flags, as returned by flags()
+	enum Flags: byte {
+		TRACEFLAG_RECORDING = 0x01,		//!< Recording is in progress
+		TRACEFLAG_OVERFLOW = 0x02		//!< Recording stopped because the ring was full
+	};
+
+	//! \brief Drop anything recorded and start again
+	void start (const TraceSource src, const byte keymapMode, const byte debounce);
+
+	void stop () {
+		recording = false;
+	}
+
+	byte flags () const {
+		return (recording ? TRACEFLAG_RECORDING : 0) | (overflow ? TRACEFLAG_OVERFLOW : 0);
+	}
+
+	//! \brief Take up to \a size bytes out of the ring, return how many
+	byte read (byte *buf, const byte size);
+
+	//! \brief A matrix scanner read \a cols from \a row
+	inline void row (const byte r, const byte cols) {
+		if (recording && cols != last[r]) {
+			changed (r, cols);
+		}
+	}
+
+	//! \brief A matrix scanner read all of its rows
+	inline void scanned () {
+		if (recording) {
+			if (pending == 0xFFFF) {
+				// Do not wrap around
+				flush ();
+			}
+			++pending;
+		}
+	}
+
+	//! \brief The passive scanner processed a sample
+	void sample (const byte rows, const byte cols) {
+		if (recording) {
+			const byte rec[] = {TRACE_SAMPLE << 5, rows, cols};
+			put (rec, sizeof (rec));
+		}
+	}
+
+	//! \brief The scanner's scan() method was called
+	void tick ();
+
+	void mode (const byte m) {
+		value (TRACE_MODE, m);
+	}
+
+	void debounce (const byte length) {
+		value (TRACE_DEBOUNCE, length);
+	}
+
+	void restore (const boolean pressed) {
+		value (TRACE_RESTORE, pressed);
+	}
+
+private:
+	CircularBuffer<byte, word, MATRIX_TRACE_SIZE> ring;
+
+	//! \brief Last columns read from each row
+	byte last[MAX_ROWS];
+
+	//! \brief Scans not recorded yet
+	word pending;
+
+	unsigned long lastTick;
+
+	boolean recording = false;
+
+	boolean overflow = false;
+
+	//! \brief Encode a record header into \a p, return its length
+	static byte header (byte *p, const TraceRecord type, const unsigned long arg);
+
+	//! \brief Queue a whole record, or stop recording if it does not fit
+	boolean put (const byte *rec, const byte len);
+
+	//! \brief Record any pending scans
+	void flush ();
+
+	void changed (const byte r, const byte cols);
+
+	void value (const TraceRecord type, const byte v);
+};
+
+extern MatrixTrace matrixTrace;
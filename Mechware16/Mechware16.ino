@@ -32,33 +32,159 @@ LedControl lc (PIN_MAX7221_DATA, PIN_MAX7221_CLK, PIN_MAX7221_SEL, 1 /* Number o
 
 unsigned long DELAY_TIME = 35;
 
+#if defined (KEYBOARD_C64)
+#include "KbdScannerC64.h"
+KbdScannerC64 kbdScannerMatrix;
+#elif defined (KEYBOARD_VIC20)
+#include "KbdScannerVic20.h"
+KbdScannerVic20 kbdScannerMatrix;
+#else
 #include "KbdScannerC16.h"
-KbdScannerC16 kbdScannerC16;
+KbdScannerC16 kbdScannerMatrix;
+#endif
 
 #include "KbdScannerPassive16.h"
 KbdScannerPassive16 kbdScannerPassive;
 
 /** \brief Actual keyboard scanner in use
  *
- * Make sure this is NEVER NULL!
+ * This is always one of the scanners above, so calls are dispatched with a
+ * plain test on which one it is. This lets the compiler inline them, and works
+ * with #ENABLE_STATIC_DISPATCH too. Only the C16 can be snooped, so for other
+ * keyboards the test goes away altogether.
  */
-KeyboardScanner *kbdScanner;
+class ActiveScanner {
+public:
+	enum Which: byte {
+		SCANNER_MATRIX,
+		SCANNER_PASSIVE
+	};
+
+	Which which = SCANNER_MATRIX;
+
+	boolean passive () const {
+#ifdef KEYBOARD_C16
+		return which == SCANNER_PASSIVE;
+#else
+		return false;
+#endif
+	}
+
+	boolean begin () {
+		return passive () ? kbdScannerPassive.begin () : kbdScannerMatrix.begin ();
+	}
+
+	void loop () {
+		if (passive ()) {
+			kbdScannerPassive.loop ();
+		} else {
+			kbdScannerMatrix.loop ();
+		}
+	}
+
+	KeyboardScanner::ScanStatus scan (KeyBuffer& buf) {
+		return passive () ? kbdScannerPassive.scan (buf) : kbdScannerMatrix.scan (buf);
+	}
+
+	void updateLeds (const boolean capsLock, const boolean numLock, const boolean scrollLock) {
+		if (passive ()) {
+			kbdScannerPassive.updateLeds (capsLock, numLock, scrollLock);
+		} else {
+			kbdScannerMatrix.updateLeds (capsLock, numLock, scrollLock);
+		}
+	}
+
+	void setKeyMapMode (const KeyMapMode mode) {
+#ifdef ENABLE_MATRIX_TRACE
+		matrixTrace.mode (mode);
+#endif
+		if (passive ()) {
+			kbdScannerPassive.setKeyMapMode (mode);
+		} else {
+			kbdScannerMatrix.setKeyMapMode (mode);
+		}
+	}
+
+	void setDebounce (const byte length) {
+#ifdef ENABLE_MATRIX_TRACE
+		matrixTrace.debounce (length);
+#endif
+		if (passive ()) {
+			kbdScannerPassive.setDebounce (length);
+		} else {
+			kbdScannerMatrix.setDebounce (length);
+		}
+	}
+
+	boolean suspend () {
+		return passive () ? kbdScannerPassive.suspend () : kbdScannerMatrix.suspend ();
+	}
+
+	void resume () {
+		if (passive ()) {
+			kbdScannerPassive.resume ();
+		} else {
+			kbdScannerMatrix.resume ();
+		}
+	}
+
+#ifdef ENABLE_MATRIX_TRACE
+	TraceSource traceSource () const {
+#if defined (KEYBOARD_C64)
+		return TRACESRC_C64;
+#elif defined (KEYBOARD_VIC20)
+		return TRACESRC_VIC20;
+#else
+		return passive () ? TRACESRC_PASSIVE16 : TRACESRC_C16;
+#endif
+	}
+#endif
+
+#ifdef ENABLE_ADAPTIVE_DEBOUNCE
+	const BounceStats *getBounceStats (const byte row, const byte col) const {
+		return passive () ? kbdScannerPassive.getBounceStats (row, col) : kbdScannerMatrix.getBounceStats (row, col);
+	}
+
+	void resetBounceStats () {
+		if (passive ()) {
+			kbdScannerPassive.resetBounceStats ();
+		} else {
+			kbdScannerMatrix.resetBounceStats ();
+		}
+	}
+#endif
+};
+
+ActiveScanner kbdScanner;
 
 #include "UsbKeyboard.h"
 UsbKeyboard usbKeyboard;
 
+#include "StatusLed.h"
+StatusLed statusLed;
+
+//! \brief True if the keyboard scanner failed to initialize
+boolean scannerError = false;
+
 #include "AnimationChasing.h"
 AnimationChasing animationChasing;
 
 #include "AnimationScrollingColumn.h"
 AnimationScrollingColumn animationScrollingColumn;
 
-constexpr byte N_ANIMATIONS = 2;
+#include "AnimationBytecode.h"
+#include "AnimationPrograms.h"
+AnimationBytecode animationBytecode;
 
-Animation *animations[N_ANIMATIONS] = {
-	&animationChasing,
-	&animationScrollingColumn
-};
+//! \brief Number of animations implemented as classes, see beginAnimation()
+constexpr byte N_ANIMATION_CLASSES = 2;
+
+/** \brief Total number of startup animations
+ *
+ * Animations implemented as classes come first, followed by the bytecode
+ * programs in AnimationPrograms.h.
+ */
+constexpr byte N_ANIMATIONS = N_ANIMATION_CLASSES + N_ANIMATION_PROGRAMS;
 
 #include "C16Key.h"
 #include "logo.h"
@@ -75,7 +201,7 @@ enum class Mode: byte {
 constexpr byte MIN_BRIGHTNESS = 0;
 constexpr byte MAX_BRIGHTNESS = 15;
 
-//! \name Configuration values saved in EEPROM
+//! \name Configuration values of the active profile, saved in EEPROM
 //! @{
 Mode mode = Mode::PRESSED_OFF;
 
@@ -91,10 +217,47 @@ byte brightness = MAX_BRIGHTNESS;
 #include "Log.h"
 Logging Log;
 
+#include "SettingsStore.h"
+SettingsStore settingsStore;
+
+#include "KeymapOverrides.h"
+KeymapOverrides keymapOverrides;
+
+#ifdef ENABLE_SERIAL_COMMANDS
+#include "SerialCommands.h"
+SerialCommands serialCommands;
+#endif
+
+#include "KeyboardHandler.h"
+KeyboardHandler<MATRIX_ROWS, MATRIX_COLS> keyboardHandler;
+
+#ifdef ENABLE_LATENCY_STATS
+#include "LatencyStats.h"
+LatencyStats latencyStats;
+#endif
+
+#include "LoopProfiler.h"
+#ifdef ENABLE_LOOP_PROFILER
+LoopProfiler loopProfiler;
+#endif
+
+#ifdef ENABLE_MATRIX_TRACE
+#include "MatrixTrace.h"
+MatrixTrace matrixTrace;
+#endif
+
+#ifdef ENABLE_USB_SUSPEND
+#include "UsbSuspend.h"
+UsbSuspend usbSuspend;
+#endif
+
+//! \name Where settings were saved by earlier versions, only read to migrate them
+//! @{
 #include <EEPROM.h>
 constexpr word EEP_ANIMATION = 0x100;
 constexpr word EEP_MODE = 0x101;
 constexpr word EEP_BRIGHTNESS = 0x102;
+//! @}
 
 #include <avr/pgmspace.h>
 
@@ -105,18 +268,6 @@ constexpr word EEP_BRIGHTNESS = 0x102;
  */
 MatrixCoordinates ledCoordinates[N_PHYSICAL_KEYS];
 
-/* Maps a key to the (row, col) tuple describing its position in the keyboard matrix, useful for quick lookups.
- * Built by buildKeyCoordinates().
- */
-MatrixCoordinates keyCoordinates[N_PHYSICAL_KEYS];
-
-/** \brief Keyboard matrix status
- *
- * Basically contains the mapped SB keycode when a key is pressed, 0 otherwise (which is KEY_RESERVED so it should be
- * OK).
- */
-Key matrix[MATRIX_ROWS][MATRIX_COLS];
-
 constexpr C16Key keymap[MATRIX_ROWS][MATRIX_COLS] PROGMEM = {
 	{C16Key::DEL,  C16Key::RETURN,   C16Key::POUND,     C16Key::HELP,  C16Key::F1,     C16Key::F2,    C16Key::F3,    C16Key::AT},
 	{C16Key::_3,   C16Key::W,        C16Key::A,         C16Key::_4,    C16Key::Z,      C16Key::S,     C16Key::E,     C16Key::SHIFT},
@@ -128,6 +279,58 @@ constexpr C16Key keymap[MATRIX_ROWS][MATRIX_COLS] PROGMEM = {
 	{C16Key::_1,   C16Key::CLEAR,    C16Key::CTRL,      C16Key::_2,    C16Key::SPACE,  C16Key::CMD,   C16Key::Q,     C16Key::RUNSTOP}
 };
 
+#if defined (KEYBOARD_C64)
+/* Keys of the C64 matrix, named after the C16 key with the same legend, so
+ * that combos use the same keys on all keyboards. F1/F3/F5/F7 stand for
+ * F1/F2/F3/HELP, the left arrow for ESC and CLR/HOME for CLEAR. Keys the C16
+ * does not have are NONE.
+ */
+constexpr C16Key comboKeymap[MATRIX_ROWS][MATRIX_COLS] = {
+	{C16Key::DEL,   C16Key::RETURN,   C16Key::RIGHT,     C16Key::HELP,  C16Key::F1,     C16Key::F2,    C16Key::F3,    C16Key::DOWN},
+	{C16Key::_3,    C16Key::W,        C16Key::A,         C16Key::_4,    C16Key::Z,      C16Key::S,     C16Key::E,     C16Key::SHIFT},
+	{C16Key::_5,    C16Key::R,        C16Key::D,         C16Key::_6,    C16Key::C,      C16Key::F,     C16Key::T,     C16Key::X},
+	{C16Key::_7,    C16Key::Y,        C16Key::G,         C16Key::_8,    C16Key::B,      C16Key::H,     C16Key::U,     C16Key::V},
+	{C16Key::_9,    C16Key::I,        C16Key::J,         C16Key::_0,    C16Key::M,      C16Key::K,     C16Key::O,     C16Key::N},
+	{C16Key::PLUS,  C16Key::P,        C16Key::L,         C16Key::MINUS, C16Key::PERIOD, C16Key::COLON, C16Key::AT,    C16Key::COMMA},
+	{C16Key::POUND, C16Key::ASTERISK, C16Key::SEMICOLON, C16Key::CLEAR, C16Key::NONE,   C16Key::EQUAL, C16Key::NONE,  C16Key::SLASH},
+	{C16Key::_1,    C16Key::ESC,      C16Key::CTRL,      C16Key::_2,    C16Key::SPACE,  C16Key::CMD,   C16Key::Q,     C16Key::RUNSTOP}
+};
+#elif defined (KEYBOARD_VIC20)
+//! \brief Same as for the C64, with the VIC-20 matrix
+constexpr C16Key comboKeymap[MATRIX_ROWS][MATRIX_COLS] = {
+	{C16Key::_1,      C16Key::_3,    C16Key::_5, C16Key::_7, C16Key::_9, C16Key::PLUS,   C16Key::POUND,     C16Key::DEL},
+	{C16Key::ESC,     C16Key::W,     C16Key::R,  C16Key::Y,  C16Key::I,  C16Key::P,      C16Key::ASTERISK,  C16Key::RETURN},
+	{C16Key::CTRL,    C16Key::A,     C16Key::D,  C16Key::G,  C16Key::J,  C16Key::L,      C16Key::SEMICOLON, C16Key::RIGHT},
+	{C16Key::RUNSTOP, C16Key::SHIFT, C16Key::X,  C16Key::V,  C16Key::N,  C16Key::COMMA,  C16Key::SLASH,     C16Key::DOWN},
+	{C16Key::SPACE,   C16Key::Z,     C16Key::C,  C16Key::B,  C16Key::M,  C16Key::PERIOD, C16Key::NONE,      C16Key::F1},
+	{C16Key::CMD,     C16Key::S,     C16Key::F,  C16Key::H,  C16Key::K,  C16Key::COLON,  C16Key::EQUAL,     C16Key::F2},
+	{C16Key::Q,       C16Key::E,     C16Key::T,  C16Key::U,  C16Key::O,  C16Key::AT,     C16Key::NONE,      C16Key::F3},
+	{C16Key::_2,      C16Key::_4,    C16Key::_6, C16Key::_8, C16Key::_0, C16Key::MINUS,  C16Key::CLEAR,     C16Key::HELP}
+};
+#else
+constexpr const C16Key (&comboKeymap)[MATRIX_ROWS][MATRIX_COLS] = keymap;
+#endif
+
+//! \brief #KeyState bit index of a key, only meant to be evaluated at compile time, through #KEYMASK()
+constexpr byte keyIndex (const C16Key k, const byte i = 0) {
+	return i >= MATRIX_ROWS * MATRIX_COLS ? 0xFF :
+		comboKeymap[i / MATRIX_COLS][i % MATRIX_COLS] == k ? i : keyIndex (k, i + 1);
+}
+
+template <byte INDEX>
+struct KeyIndex {
+	static_assert (INDEX < MATRIX_ROWS * MATRIX_COLS, "Key is not in the keymap");
+	static constexpr byte value = INDEX;
+};
+
+/** \brief #KeyState containing only the given key, e.g. KEYMASK (SHIFT)
+ *
+ * The position of the key is looked up at compile time, so the keymap is never
+ * read from flash. On the C64 and VIC-20 the key is found by its legend, see
+ * #comboKeymap.
+ */
+#define KEYMASK(k) (KeyState::at (KeyIndex<keyIndex (C16Key::k)>::value))
+
 // Only useful for debugging
 //~ constexpr char KEY_NAMES[MATRIX_ROWS][MATRIX_COLS][4] = {
 	//~ {"DEL", "RET", "£",   "HLP", "F1",  "F2", "F3", "@"},
@@ -168,45 +371,20 @@ boolean buildLedCoordinates () {
 	return found;
 }
 
-// Populates the keyCoordinates array
-boolean buildKeyCoordinates () {
-	bool found;
-	
-	for (byte i = 0; i < N_PHYSICAL_KEYS; ++i) {
-		found = false;
-		for (byte row = 0; row < MATRIX_ROWS && !found; ++row) {
-			for (byte col = 0; col < MATRIX_COLS && !found; ++col) {
-				if (pgm_read_byte (&keymap[row][col]) == i) {
-					keyCoordinates[i].row = row;
-					keyCoordinates[i].col = col;
-					found = true;
-				}
-			}
-		}
-
-		if (!found) {
-			break;
-		}
-	}
-
-	return found;
+// Turns the led of the key at the given matrix position on or off, see buildLedCoordinates() for the coordinates
+void setKeyLed (const byte row, const byte col, const boolean on) {
+	lc.setLed (0, col, (row + 1) % 8, on);
 }
 
 // Called when a keypress is detected
 void onKeyPressed (const byte row, const byte col) {
 	switch (mode) {
-		case Mode::PRESSED_ON: {
-			const byte k = pgm_read_byte (&keymap[row][col]);
-			const MatrixCoordinates& pos = ledCoordinates[k];
-			lc.setLed (0, pos.row, pos.col, true);
+		case Mode::PRESSED_ON:
+			setKeyLed (row, col, true);
 			break;
-		}
-		case Mode::PRESSED_OFF: {
-			const byte k = pgm_read_byte (&keymap[row][col]);
-			const MatrixCoordinates& pos = ledCoordinates[k];
-			lc.setLed (0, pos.row, pos.col, false);
+		case Mode::PRESSED_OFF:
+			setKeyLed (row, col, false);
 			break;
-		}
 		case Mode::ALWAYS_ON:
 		case Mode::ALWAYS_OFF:
 			// Nothing to do
@@ -217,18 +395,12 @@ void onKeyPressed (const byte row, const byte col) {
 // Called when a keyrelease is detected
 void onKeyReleased (const byte row, const byte col) {
 	switch (mode) {
-		case Mode::PRESSED_ON: {
-			const byte k = pgm_read_byte (&keymap[row][col]);
-			const MatrixCoordinates& pos = ledCoordinates[k];
-			lc.setLed (0, pos.row, pos.col, false);
+		case Mode::PRESSED_ON:
+			setKeyLed (row, col, false);
 			break;
-		}
-		case Mode::PRESSED_OFF: {
-			const byte k = pgm_read_byte (&keymap[row][col]);
-			const MatrixCoordinates& pos = ledCoordinates[k];
-			lc.setLed (0, pos.row, pos.col, true);
+		case Mode::PRESSED_OFF:
+			setKeyLed (row, col, true);
 			break;
-		}
 		case Mode::ALWAYS_ON:
 		case Mode::ALWAYS_OFF:
 			// Nothing to do
@@ -236,15 +408,6 @@ void onKeyReleased (const byte row, const byte col) {
 	}
 }
 
-boolean isPressed (const C16Key k) {
-	if (static_cast<byte> (k) > N_PHYSICAL_KEYS) {
-		return false;
-	} else {
-		const MatrixCoordinates pos = keyCoordinates[static_cast<byte> (k)];
-		return matrix[pos.row][pos.col] != 0;
-	}
-}
-
 void updateLighting () {
 	// Update the LED pattern according to the chosen mode
 	switch (mode) {
@@ -257,9 +420,7 @@ void updateLighting () {
 		case Mode::PRESSED_OFF:
 			for (byte r = 0; r < MATRIX_ROWS; ++r) {
 				for (byte c = 0; c < MATRIX_COLS; ++c) {
-					const byte k = pgm_read_byte (&keymap[r][c]);
-					const MatrixCoordinates& pos = ledCoordinates[k];
-					lc.setLed (0, pos.row, pos.col, matrix[r][c] != 0 ? false : true);
+					setKeyLed (r, c, !keyboardHandler.getPressed ().isPressed (r, c));
 				}
 			}
 			break;
@@ -272,31 +433,146 @@ void updateLighting () {
 		case Mode::PRESSED_ON:
 			for (byte r = 0; r < MATRIX_ROWS; ++r) {
 				for (byte c = 0; c < MATRIX_COLS; ++c) {
-					const byte k = pgm_read_byte (&keymap[r][c]);
-					const MatrixCoordinates& pos = ledCoordinates[k];
-					lc.setLed (0, pos.row, pos.col, matrix[r][c] != 0 ? true : false);
+					setKeyLed (r, c, keyboardHandler.getPressed ().isPressed (r, c));
 				}
 			}
 			break;
 	}
 }
 
+// Starts the animation with the given ID, which must be < N_ANIMATIONS
+void beginAnimation (const byte id) {
+	switch (id) {
+		case 0:
+			animationChasing.begin (lc);
+			break;
+		case 1:
+			animationScrollingColumn.begin (lc);
+			break;
+		default: {
+			const byte *prog = reinterpret_cast<const byte *> (pgm_read_ptr (&animationPrograms[id - N_ANIMATION_CLASSES]));
+			animationBytecode.load (prog);
+			animationBytecode.begin (lc);
+			break;
+		}
+	}
+}
+
+// Advances the animation started by beginAnimation(), returns false when it is over
+boolean stepAnimation (const byte id) {
+	switch (id) {
+		case 0:
+			return animationChasing.step ();
+		case 1:
+			return animationScrollingColumn.step ();
+		default:
+			return animationBytecode.step ();
+	}
+}
+
+/* Shows the state of things on the status LED: green for the active scanner,
+ * blue for the passive one, breathing if Caps Lock is on. Blinks red if
+ * something went wrong.
+ */
+void updateStatusLed (const boolean capsLock) {
+	if (scannerError) {
+		statusLed.set (0xFF, 0x00, 0x00, StatusLed::PATTERN_BLINK);
+	} else {
+		const StatusLed::Pattern pattern = capsLock ? StatusLed::PATTERN_BREATHE : StatusLed::PATTERN_SOLID;
+		if (kbdScanner.passive ()) {
+			statusLed.set (0x00, 0x00, 0xFF, pattern);
+		} else {
+			statusLed.set (0x00, 0xFF, 0x00, pattern);
+		}
+	}
+}
+
+/* Initializes all profiles with default values, then migrates the settings saved by earlier versions (if any) to the
+ * first one
+ */
+void initSettings () {
+	Settings& s = settingsStore.get ();
+	s.version = SETTINGS_VERSION;
+	s.activeProfile = 0;
+	for (byte i = 0; i < N_PROFILES; ++i) {
+		Profile& p = s.profiles[i];
+		p.mode = static_cast<byte> (Mode::PRESSED_OFF);
+		p.animation = 0;
+		p.brightness = MAX_BRIGHTNESS;
+		p.keymapMode = KEYMAP_SYMBOLIC;
+		p.debounce = DEFAULT_DEBOUNCE;
+	}
+
+	Profile& p = s.profiles[0];
+	byte b = EEPROM.read (EEP_ANIMATION);
+	if (b < N_ANIMATIONS) {
+		p.animation = b;
+	}
+	b = EEPROM.read (EEP_MODE);
+	if (b <= static_cast<byte> (Mode::PRESSED_OFF)) {
+		p.mode = b;
+	}
+	b = EEPROM.read (EEP_BRIGHTNESS);
+	if (b <= MAX_BRIGHTNESS) {
+		p.brightness = b;
+	}
+}
+
+// Copies the current configuration to the active profile, which will be saved eventually
+void saveSettings () {
+	Profile& p = settingsStore.getProfile ();
+	p.animation = animationId;
+	p.mode = static_cast<byte> (mode);
+	p.brightness = brightness;
+	settingsStore.changed ();
+}
+
+// Switches to another profile, applying all of its settings at once
+void onSetProfile (const byte newProfile) {
+	Settings& s = settingsStore.get ();
+	if (newProfile != s.activeProfile && newProfile < N_PROFILES) {
+		Log.debug (LOG_STR ("Switching to profile %d\n"), static_cast<int> (newProfile));
+
+		s.activeProfile = newProfile;
+		const Profile& p = settingsStore.getProfile ();
+		animationId = p.animation;
+		brightness = p.brightness;
+		lc.setIntensity (0, brightness);
+		mode = static_cast<Mode> (p.mode);
+		updateLighting ();
+		kbdScanner.setKeyMapMode (static_cast<KeyMapMode> (p.keymapMode));
+		kbdScanner.setDebounce (p.debounce);
+		settingsStore.changed ();
+	}
+}
+
+void onSetKeyMapMode (const KeyMapMode newMode) {
+	Profile& p = settingsStore.getProfile ();
+	if (newMode != p.keymapMode) {
+		Log.debug (LOG_STR ("Setting keymap mode %d\n"), static_cast<int> (newMode));
+
+		p.keymapMode = newMode;
+		kbdScanner.setKeyMapMode (newMode);
+		settingsStore.changed ();
+	}
+}
+
 void onSetMode (const Mode newMode) {
 	if (newMode != mode) {
-		Log.debug (F("Setting mode %d\n"), static_cast<int> (newMode));
+		Log.debug (LOG_STR ("Setting mode %d\n"), static_cast<int> (newMode));
 		
 		mode = newMode;
-		EEPROM.write (EEP_MODE, static_cast<byte> (mode));
+		saveSettings ();
 		updateLighting ();
 	}
 }
 
 void onSetAnimation (const int newAnimation) {
-	if (newAnimation != animationId) {
-		Log.debug (F("Setting animation %d\n"), static_cast<int> (newAnimation));
+	if (newAnimation != animationId && newAnimation < N_ANIMATIONS) {
+		Log.debug (LOG_STR ("Setting animation %d\n"), static_cast<int> (newAnimation));
 		
 		animationId = newAnimation;
-		EEPROM.write (EEP_ANIMATION, static_cast<byte> (animationId));
+		saveSettings ();
 	}
 }
 
@@ -304,12 +580,303 @@ void onSetBrightness (const int8_t diff) {
 	int newBrightness = brightness + diff;
 	if (newBrightness >= MIN_BRIGHTNESS && newBrightness <= MAX_BRIGHTNESS) {
 		brightness = static_cast<byte> (newBrightness);
-		EEPROM.write (EEP_BRIGHTNESS, static_cast<byte> (brightness));
+		saveSettings ();
 		lc.setIntensity (0, brightness);
-		Log.debug (F("Brightness set to %d\n"), static_cast<int> (brightness));
+		Log.debug (LOG_STR ("Brightness set to %d\n"), static_cast<int> (brightness));
 	}
 }
 
+#include "ComboMatcher.h"
+
+//! \brief What combos do, see #combos
+enum ComboAction: byte {
+	COMBO_SET_MODE,				//!< Arg: #Mode
+	COMBO_SET_PROFILE,			//!< Arg: profile
+	COMBO_SET_ANIMATION,		//!< Arg: animation
+	COMBO_SET_KEYMAP_MODE,		//!< Arg: #KeyMapMode
+	COMBO_CHANGE_BRIGHTNESS		//!< Arg: difference, as int8_t
+};
+
+//! \brief All combos start with C= + CTRL
+#define COMBO_KEYS(k) (KEYMASK (CMD) | KEYMASK (CTRL) | (k))
+
+/* Combos for changing settings from the keyboard. Entries with more keys must come first, see ComboMatcher.
+ * TODO: C= + CTRL + RUN/STOP to reset
+ */
+const Combo combos[] PROGMEM = {
+	{COMBO_KEYS (KEYMASK (F1)),						COMBO_SET_MODE,				static_cast<byte> (Mode::ALWAYS_OFF),	COMBO_ON_PRESS},
+	{COMBO_KEYS (KEYMASK (F2)),						COMBO_SET_MODE,				static_cast<byte> (Mode::ALWAYS_ON),	COMBO_ON_PRESS},
+	{COMBO_KEYS (KEYMASK (F3)),						COMBO_SET_MODE,				static_cast<byte> (Mode::PRESSED_ON),	COMBO_ON_PRESS},
+	{COMBO_KEYS (KEYMASK (HELP)),					COMBO_SET_MODE,				static_cast<byte> (Mode::PRESSED_OFF),	COMBO_ON_PRESS},
+	{COMBO_KEYS (KEYMASK (SHIFT) | KEYMASK (_1)),	COMBO_SET_PROFILE,			0,										COMBO_ON_PRESS},
+	{COMBO_KEYS (KEYMASK (SHIFT) | KEYMASK (_2)),	COMBO_SET_PROFILE,			1,										COMBO_ON_PRESS},
+	{COMBO_KEYS (KEYMASK (SHIFT) | KEYMASK (_3)),	COMBO_SET_PROFILE,			2,										COMBO_ON_PRESS},
+	{COMBO_KEYS (KEYMASK (SHIFT) | KEYMASK (_4)),	COMBO_SET_PROFILE,			3,										COMBO_ON_PRESS},
+	{COMBO_KEYS (KEYMASK (_1)),						COMBO_SET_ANIMATION,		0,										COMBO_ON_PRESS},
+	{COMBO_KEYS (KEYMASK (_2)),						COMBO_SET_ANIMATION,		1,										COMBO_ON_PRESS},
+	{COMBO_KEYS (KEYMASK (_3)),						COMBO_SET_ANIMATION,		2,										COMBO_ON_PRESS},
+	{COMBO_KEYS (KEYMASK (_4)),						COMBO_SET_ANIMATION,		3,										COMBO_ON_PRESS},
+	{COMBO_KEYS (KEYMASK (_5)),						COMBO_SET_ANIMATION,		4,										COMBO_ON_PRESS},
+	{COMBO_KEYS (KEYMASK (P)),						COMBO_SET_KEYMAP_MODE,		KEYMAP_POSITIONAL,						COMBO_ON_PRESS},
+	{COMBO_KEYS (KEYMASK (S)),						COMBO_SET_KEYMAP_MODE,		KEYMAP_SYMBOLIC,						COMBO_ON_PRESS},
+	{COMBO_KEYS (KEYMASK (PLUS)),					COMBO_CHANGE_BRIGHTNESS,	static_cast<byte> (+1),					COMBO_REPEAT},
+	{COMBO_KEYS (KEYMASK (MINUS)),					COMBO_CHANGE_BRIGHTNESS,	static_cast<byte> (-1),					COMBO_REPEAT}
+};
+
+ComboMatcher comboMatcher;
+
+// Called when a combo triggers
+void onCombo (const byte action, const byte arg) {
+	switch (static_cast<ComboAction> (action)) {
+		case COMBO_SET_MODE:
+			onSetMode (static_cast<Mode> (arg));
+			break;
+		case COMBO_SET_PROFILE:
+			onSetProfile (arg);
+			break;
+		case COMBO_SET_ANIMATION:
+			onSetAnimation (arg);
+			break;
+		case COMBO_SET_KEYMAP_MODE:
+			onSetKeyMapMode (static_cast<KeyMapMode> (arg));
+			break;
+		case COMBO_CHANGE_BRIGHTNESS:
+			onSetBrightness (static_cast<int8_t> (arg));
+			break;
+	}
+}
+
+#ifdef ENABLE_SERIAL_COMMANDS
+// Changes a setting of a profile, applying it right away if that's the active one
+SerialStatus setProfileField (const byte prof, const byte field, const byte value) {
+	SerialStatus ret = SERSTATUS_OK;
+	Settings& s = settingsStore.get ();
+
+	if (field == SETTING_ACTIVE_PROFILE) {
+		if (value < N_PROFILES) {
+			onSetProfile (value);
+		} else {
+			ret = SERSTATUS_BAD_ARGS;
+		}
+	} else if (prof >= N_PROFILES) {
+		ret = SERSTATUS_BAD_ARGS;
+	} else {
+		const boolean active = prof == s.activeProfile;
+		Profile& p = s.profiles[prof];
+		switch (field) {
+			case SETTING_MODE:
+				if (value > static_cast<byte> (Mode::PRESSED_OFF)) {
+					ret = SERSTATUS_BAD_ARGS;
+				} else if (active) {
+					onSetMode (static_cast<Mode> (value));
+				} else {
+					p.mode = value;
+				}
+				break;
+			case SETTING_ANIMATION:
+				if (value >= N_ANIMATIONS) {
+					ret = SERSTATUS_BAD_ARGS;
+				} else if (active) {
+					onSetAnimation (value);
+				} else {
+					p.animation = value;
+				}
+				break;
+			case SETTING_BRIGHTNESS:
+				if (value > MAX_BRIGHTNESS) {
+					ret = SERSTATUS_BAD_ARGS;
+				} else if (active) {
+					onSetBrightness (value - brightness);
+				} else {
+					p.brightness = value;
+				}
+				break;
+			case SETTING_KEYMAP_MODE:
+				if (value > KEYMAP_SYMBOLIC) {
+					ret = SERSTATUS_BAD_ARGS;
+				} else if (active) {
+					onSetKeyMapMode (static_cast<KeyMapMode> (value));
+				} else {
+					p.keymapMode = value;
+				}
+				break;
+			case SETTING_DEBOUNCE:
+				if (value == 0) {
+					ret = SERSTATUS_BAD_ARGS;
+				} else {
+					p.debounce = value;
+					if (active) {
+						kbdScanner.setDebounce (value);
+					}
+				}
+				break;
+			default:
+				ret = SERSTATUS_BAD_ARGS;
+				break;
+		}
+
+		if (ret == SERSTATUS_OK) {
+			settingsStore.changed ();
+		}
+	}
+
+	return ret;
+}
+
+// Handles commands received on the serial port, see SerialCommands.h for the details
+SerialStatus onSerialCommand (const byte cmd, const byte *args, const byte nargs, byte *reply, byte& nreply) {
+	SerialStatus ret = SERSTATUS_OK;
+
+	switch (cmd) {
+		case SERCMD_PING:
+			reply[0] = MECH16_VERSION_MAJOR;
+			reply[1] = MECH16_VERSION_MINOR;
+			reply[2] = MECH16_VERSION_PATCH;
+			nreply = 3;
+			break;
+		case SERCMD_GET_PROFILE:
+			if (nargs != 1 || args[0] >= N_PROFILES) {
+				ret = SERSTATUS_BAD_ARGS;
+			} else {
+				const Settings& s = settingsStore.get ();
+				const Profile& p = s.profiles[args[0]];
+				reply[0] = s.activeProfile;
+				reply[1] = p.mode;
+				reply[2] = p.animation;
+				reply[3] = p.brightness;
+				reply[4] = p.keymapMode;
+				reply[5] = p.debounce;
+				nreply = 6;
+			}
+			break;
+		case SERCMD_SET_SETTING:
+			if (nargs != 3) {
+				ret = SERSTATUS_BAD_ARGS;
+			} else {
+				ret = setProfileField (args[0], args[1], args[2]);
+			}
+			break;
+		case SERCMD_DUMP_MATRIX:
+			for (byte r = 0; r < MATRIX_ROWS; ++r) {
+				reply[r] = keyboardHandler.getPressed ().row (r);
+			}
+			nreply = MATRIX_ROWS;
+			break;
+		case SERCMD_GET_COUNTERS:
+			memcpy (reply, &keyboardHandler.counters, sizeof (keyboardHandler.counters));
+			nreply = sizeof (keyboardHandler.counters);
+			break;
+#ifdef ENABLE_LATENCY_STATS
+		case SERCMD_GET_LATENCY:
+			if (nargs != 2 || args[0] >= N_LATENCY_INTERVALS || args[1] >= LatencyStats::N_BUCKETS) {
+				ret = SERSTATUS_BAD_ARGS;
+			} else {
+				const word *hist = latencyStats.getHistogram (static_cast<LatencyInterval> (args[0]));
+				const byte n = min (LatencyStats::N_BUCKETS - args[1], 8);
+				memcpy (reply, hist + args[1], n * sizeof (word));
+				nreply = n * sizeof (word);
+			}
+			break;
+#endif
+#ifdef ENABLE_ADAPTIVE_DEBOUNCE
+		case SERCMD_GET_BOUNCE: {
+			const BounceStats *stats = nargs == 2 ? kbdScanner.getBounceStats (args[0], args[1]) : NULL;
+			if (stats == NULL) {
+				ret = SERSTATUS_BAD_ARGS;
+			} else {
+				reply[0] = stats -> transitions & 0xFF;
+				reply[1] = stats -> transitions >> 8;
+				reply[2] = stats -> edges & 0xFF;
+				reply[3] = stats -> edges >> 8;
+				reply[4] = stats -> maxSettle;
+				reply[5] = stats -> chatter;
+				reply[6] = stats -> window;
+				nreply = 7;
+			}
+			break;
+		}
+#endif
+#ifdef ENABLE_LOOP_PROFILER
+		case SERCMD_GET_LOOP_STATS:
+			if (nargs != 1 || args[0] >= N_LOOP_STAGES) {
+				ret = SERSTATUS_BAD_ARGS;
+			} else {
+				const LoopStageStats& stats = loopProfiler.getStats (static_cast<LoopStage> (args[0]));
+				const unsigned long elapsed = loopProfiler.getElapsedMillis ();
+				memcpy (reply, &stats, sizeof (stats));
+				memcpy (reply + sizeof (stats), &elapsed, sizeof (elapsed));
+				nreply = sizeof (stats) + sizeof (elapsed);
+			}
+			break;
+#endif
+#ifdef ENABLE_MATRIX_TRACE
+		case SERCMD_GET_TRACE:
+			reply[0] = matrixTrace.flags ();
+			nreply = 1 + matrixTrace.read (reply + 1, MAX_SERCMD_LEN - 3);
+			break;
+#endif
+		case SERCMD_ACTION:
+			if (nargs != 1) {
+				ret = SERSTATUS_BAD_ARGS;
+			} else if (args[0] == SERACTION_RELEASE_ALL) {
+				KeyBuffer kBuf;
+				kBuf.begin ();
+				keyboardHandler.handle (kBuf);
+			} else if (args[0] == SERACTION_SAVE_SETTINGS) {
+				settingsStore.flush ();
+#ifdef ENABLE_LATENCY_STATS
+			} else if (args[0] == SERACTION_RESET_LATENCY) {
+				latencyStats.reset ();
+#endif
+#ifdef ENABLE_ADAPTIVE_DEBOUNCE
+			} else if (args[0] == SERACTION_RESET_BOUNCE) {
+				kbdScanner.resetBounceStats ();
+#endif
+#ifdef ENABLE_LOOP_PROFILER
+			} else if (args[0] == SERACTION_RESET_LOOP_STATS) {
+				loopProfiler.reset ();
+#endif
+#ifdef ENABLE_MATRIX_TRACE
+			} else if (args[0] == SERACTION_TRACE_START) {
+				const Profile& p = settingsStore.getProfile ();
+				matrixTrace.start (kbdScanner.traceSource (), p.keymapMode, p.debounce);
+			} else if (args[0] == SERACTION_TRACE_STOP) {
+				matrixTrace.stop ();
+#endif
+			} else {
+				ret = SERSTATUS_BAD_ARGS;
+			}
+			break;
+		case SERCMD_KEYMAP_EDIT:
+			keymapOverrides.edit ();
+			break;
+		case SERCMD_KEYMAP_ADD:
+			if (nargs != 5 || !keymapOverrides.add (args[0], args[1], args[2], args[3] | (args[4] << 8))) {
+				ret = SERSTATUS_BAD_ARGS;
+			}
+			break;
+		case SERCMD_KEYMAP_APPLY:
+			// Only reply once the layout has been written to EEPROM
+			switch (keymapOverrides.apply ()) {
+				case KeymapOverrides::APPLY_IN_PROGRESS:
+					ret = SERSTATUS_IN_PROGRESS;
+					break;
+				case KeymapOverrides::APPLY_FAILED:
+					ret = SERSTATUS_BAD_ARGS;
+					break;
+				case KeymapOverrides::APPLY_DONE:
+					break;
+			}
+			break;
+		default:
+			ret = SERSTATUS_UNKNOWN_COMMAND;
+			break;
+	}
+
+	return ret;
+}
+#endif
+
 void setup () {
 #if !defined (DISABLE_LOGGING) || defined (ENABLE_SERIAL_COMMANDS)
 	Serial.begin (115200);
@@ -326,223 +893,269 @@ void setup () {
 
 	Log.setShowLevel (false);
 	Log.info (PSTR_TO_F (logo));
-	Log.info (F("---------------------------------------- Version " MECH16_VERSION_STR " ---------\n"));
+	Log.info (LOG_STR ("---------------------------------------- Version %d.%d.%d ---------\n"), MECH16_VERSION_MAJOR, MECH16_VERSION_MINOR, MECH16_VERSION_PATCH);
 	Log.setShowLevel (true);
 
-	Log.info (F("Built on %s %s\n"), __DATE__, __TIME__);
+	Log.info (LOG_STR ("Built on %s %s\n"), __DATE__, __TIME__);
 	
+	// Load settings, all at once
+	if (!settingsStore.begin ()) {
+		Log.info (LOG_STR ("No valid settings found, using defaults\n"));
+		initSettings ();
+	}
+	const Profile& profile = settingsStore.getProfile ();
+
 	// Wake up and configure the MAX72XX ASAP, since it might show a random pattern at startup
 	lc.shutdown (0, false);
 	lc.clearDisplay (0);
-	brightness = EEPROM.read (EEP_BRIGHTNESS);
-	if (brightness > MAX_BRIGHTNESS) {
-		brightness = MAX_BRIGHTNESS;
-	}
+	brightness = profile.brightness;
 	lc.setIntensity (0, brightness);
 
-	// R/G/B LED pins: configure as OUTPUTs and turn on
-	pinMode (PIN_LED_R, OUTPUT);
-	digitalWrite (PIN_LED_R, HIGH);
-	pinMode (PIN_LED_G, OUTPUT);
-	digitalWrite (PIN_LED_G, HIGH);
-	pinMode (PIN_LED_B, OUTPUT);
-	digitalWrite (PIN_LED_B, HIGH);
+	// R/G/B status LED: white while we start up
+	statusLed.begin (PIN_LED_R, PIN_LED_G, PIN_LED_B);
+	statusLed.set (0xFF, 0xFF, 0xFF);
 
 	// Build the required coordinates array
-	if (!buildLedCoordinates () || !buildKeyCoordinates ()) {
-		Log.error (F("Unable to build the LED coordinates array, this indicates a mistake in the code\n"));
-
-		// Hang with fast blinking
-		while (true) {
-			digitalWrite (PIN_LED_R, HIGH);
-			delay (222);
-			digitalWrite (PIN_LED_R, LOW);
-			delay (222);
-		}
+	if (!buildLedCoordinates ()) {
+		Log.error (LOG_STR ("Unable to build the LED coordinates array, this indicates a mistake in the code\n"));
+
+		// Hang with fast blinking, which is done in the background by the status LED
+		statusLed.set (0xFF, 0x00, 0x00, StatusLed::PATTERN_BLINK);
+		while (true)
+			;
 	}
 
 	// Start with normal keyboard scanner...
-	kbdScanner = &kbdScannerC16;
+	kbdScanner.which = ActiveScanner::SCANNER_MATRIX;
 	DDRB  = 0x00;   // Output port: all inputs...
 	PORTB = 0xFF;   // ... with pull-ups
 	DDRD = 0x00;	// Input port too, just in case some key is being held at startup
 	PORTD = 0xFF;
 
 	// ... and while we play the power-up animation...
-	animationId = EEPROM.read (EEP_ANIMATION);
+	animationId = profile.animation;
 	if (animationId >= N_ANIMATIONS) {
-		// Default animation
+		// Saved by a firmware with more animations, use default
 		animationId = 0;
 	}
 
-	Log.debug (F("Playing intro animation %d\n"), static_cast<int> (animationId));
-	Animation& animation = *animations[animationId];
-	animation.begin (lc);
+	Log.debug (LOG_STR ("Playing intro animation %d\n"), static_cast<int> (animationId));
+	beginAnimation (animationId);
+#ifdef KEYBOARD_C16
 	unsigned long start = millis ();
-	while (animation.step ()) {
+#endif
+	while (stepAnimation (animationId)) {
+#ifdef KEYBOARD_C16
 		// ... check if we have activity on PINB (our wannabe-output port) ...
 		if (PINB != 0xFF) {
 			// ... and, if we do, switch to the passive scanner
-			Log.info (F("Using PASSIVE scanner\n"));
-			kbdScanner = &kbdScannerPassive;
+			Log.info (LOG_STR ("Using PASSIVE scanner\n"));
+			kbdScanner.which = ActiveScanner::SCANNER_PASSIVE;
 		}
+#endif
 	}
 
+#ifdef KEYBOARD_C16
 	// If animation takes less than 200 ms, wait for another bit, just in case
-	while ((kbdScanner != &kbdScannerPassive) && (millis () - start < 200UL)) {
+	while ((kbdScanner.which != ActiveScanner::SCANNER_PASSIVE) && (millis () - start < 200UL)) {
 		if (PINB != 0xFF) {
 			// Detected activity on the wannabe-output port, switch to the passive scanner
-			Log.info (F("Using PASSIVE scanner\n"));
-			kbdScanner = &kbdScannerPassive;
+			Log.info (LOG_STR ("Using PASSIVE scanner\n"));
+			kbdScanner.which = ActiveScanner::SCANNER_PASSIVE;
 			break;
 		}
 	}
-	Log.debug (F("Animation done\n"));
+#endif
+	Log.debug (LOG_STR ("Animation done\n"));
 
 	// Prepare the initial LED pattern according to the saved mode
-	byte b = EEPROM.read (EEP_MODE);
-	if (b <= static_cast<byte> (Mode::PRESSED_OFF)) {
-		mode = static_cast<Mode> (b);
-	} else {
-		// Default mode
-		mode = Mode::PRESSED_OFF;
-	}
+	mode = static_cast<Mode> (profile.mode);
 	updateLighting ();
 
-	if (kbdScanner -> begin ()) {
-		// Clear matrix
-		for (byte r = 0; r < MATRIX_ROWS; ++r) {
-			for (byte c = 0; c < MATRIX_COLS; ++c) {
-				matrix[r][c] = 0;
-			}
+#ifdef ENABLE_LATENCY_STATS
+	latencyStats.begin ();
+#endif
+#ifdef ENABLE_LOOP_PROFILER
+	loopProfiler.begin ();
+#endif
+
+	if (keymapOverrides.begin ()) {
+		Log.info (LOG_STR ("Loaded %d keymap overrides\n"), static_cast<int> (keymapOverrides.size ()));
+	}
+
+	kbdScanner.setKeyMapMode (static_cast<KeyMapMode> (profile.keymapMode));
+	kbdScanner.setDebounce (profile.debounce);
+	keyboardHandler.begin (usbKeyboard, onKeyPressed, onKeyReleased);
+	comboMatcher.begin (combos, sizeof (combos) / sizeof (combos[0]), onCombo);
+	if (!kbdScanner.begin ()) {
+		Log.error (LOG_STR ("Failed to initialize keyboard scanner\n"));
+		scannerError = true;
+	}
+
+	usbKeyboard.begin ();
+	updateStatusLed (false);
+
+#ifdef ENABLE_SERIAL_COMMANDS
+	serialCommands.begin (Serial, onSerialCommand);
+#endif
+}
+
+#ifdef ENABLE_USB_SUSPEND
+/* Wait for a key press, with the scanner not touching the matrix meanwhile.
+ * Passive scanners still see it being scanned by the computer, so keep asking
+ * them, just less often.
+ */
+boolean waitKeyPress (const boolean canSleep) {
+	if (canSleep) {
+		usbSuspend.sleep ();
+
+		// Make sure it was not just noise
+		if (usbSuspend.keyPressed ()) {
+			delayMicroseconds (50);
+			return usbSuspend.keyPressed ();
 		}
 	} else {
-		Log.error (F("Failed to initialize keyboard scanner\n"));
+		static unsigned long lastScanTime = 0;
+
+		usbSuspend.idle ();
+		kbdScanner.loop ();
+		if (millis () - lastScanTime >= SUSPENDED_SCAN_INTERVAL_MS) {
+			lastScanTime = millis ();
+
+			KeyBuffer kBuf;
+			kBuf.begin ();
+			return kbdScanner.scan (kBuf) == KeyboardScanner::SCAN_COMPLETE && kBuf.size > 0;
+		}
 	}
 
-	usbKeyboard.begin ();
+	return false;
 }
 
-void loop () {
-	static C16Key lastCombo = C16Key::NONE;
-	
-	// Check combos
-	if (isPressed (C16Key::CMD) && isPressed (C16Key::CTRL)) {
-		if (lastCombo == C16Key::NONE || !isPressed (lastCombo)) {		// Poor way to avoid key repetitions
-			if (isPressed (C16Key::F1)) {
-				onSetMode (Mode::ALWAYS_OFF);
-			} else if (isPressed (C16Key::F2)) {
-				onSetMode (Mode::ALWAYS_ON);
-			} else if (isPressed (C16Key::F3)) {
-				onSetMode (Mode::PRESSED_ON);
-			} else if (isPressed (C16Key::HELP)) {
-				onSetMode (Mode::PRESSED_OFF);
-			} else if (isPressed (C16Key::_1)) {
-				onSetAnimation (0);						
-			} else if (isPressed (C16Key::_2)) {
-				onSetAnimation (1);
-			} else if (isPressed (C16Key::PLUS)) {
-				onSetBrightness (+1);
-				lastCombo = C16Key::PLUS;
-			} else if (isPressed (C16Key::MINUS)) {
-				onSetBrightness (-1);
-				lastCombo = C16Key::MINUS;
-			} else if (isPressed (C16Key::RUNSTOP)) {
-				// TODO: RESET
+/* Stay here for as long as the host keeps the bus suspended, with the lighting
+ * off and the MCU asleep as much as possible
+ */
+void suspend () {
+	Log.info (LOG_STR ("USB suspended\n"));
+
+	// Do not keep pending settings in RAM, power might go away
+	settingsStore.flush ();
+	do {
+		settingsStore.loop ();
+	} while (settingsStore.busy ());
+
+	// The MAX7221 keeps its registers while shut down
+	lc.shutdown (0, true);
+	statusLed.sleep ();
+	usbSuspend.enter ();
+	const boolean canSleep = kbdScanner.suspend ();
+
+	boolean lightsOn = false;
+	while (usbSuspend.isSuspended ()) {
+		if (waitKeyPress (canSleep)) {
+			if (usbSuspend.wakeupHost ()) {
+				Log.info (LOG_STR ("Waking up host\n"));
+
+				// Give immediate feedback, the host might take a while
+				lc.shutdown (0, false);
+				statusLed.wake ();
+				lightsOn = true;
+
+				const unsigned long start = millis ();
+				while (usbSuspend.isSuspended () && millis () - start < USB_WAKEUP_TIMEOUT_MS) {
+					usbSuspend.idle ();
+				}
+
+				if (usbSuspend.isSuspended ()) {
+					// Host did not come back, go to sleep again
+					Log.warn (LOG_STR ("Host did not wake up\n"));
+					lc.shutdown (0, true);
+					statusLed.sleep ();
+					lightsOn = false;
+				}
 			} else {
-				lastCombo = C16Key::NONE;
+				// Remote wakeup not allowed, do not keep waking up until the key is released
+				while (usbSuspend.isSuspended () && (canSleep ? usbSuspend.keyPressed () : waitKeyPress (false))) {
+					usbSuspend.idle ();
+				}
 			}
 		}
 	}
 
+	kbdScanner.resume ();
+	usbSuspend.leave ();
+	if (!lightsOn) {
+		lc.shutdown (0, false);
+		statusLed.wake ();
+	}
+
+	Log.info (LOG_STR ("USB resumed\n"));
+}
+#endif
+
+void loop () {
 	static unsigned long lastKeyboardScanTime = 0;
-	
+
+#ifdef ENABLE_USB_SUSPEND
+	/* Returns when the host is back. This is done before profiling starts, so
+	 * that the time spent asleep is not taken for any stage
+	 */
+	if (usbSuspend.isSuspended ()) {
+		suspend ();
+
+		// Scan keys right away
+		lastKeyboardScanTime = millis () - KEYBOARD_SCAN_INTERVAL_MS;
+	}
+#endif
+
+	PROFILE_START ();
+
+	// Check combos
+	comboMatcher.update (keyboardHandler.getPressed ());
+	PROFILE_MARK (LOOPSTAGE_COMBOS);
+
 	// Let the scanner do its own housekeeping as often as possible
-	kbdScanner -> loop ();
+	kbdScanner.loop ();
+	PROFILE_MARK (LOOPSTAGE_SCANNER_LOOP);
+
+	// Commit settings if they were changed a while ago
+	settingsStore.loop ();
+	PROFILE_MARK (LOOPSTAGE_SETTINGS);
+
+#ifdef ENABLE_SERIAL_COMMANDS
+	serialCommands.loop ();
+#endif
+
+	// Send any buffered binary log records
+	Log.loop ();
+	PROFILE_MARK (LOOPSTAGE_COMMS);
 
 	// Once in a while, do the scanning
 	if (millis () - lastKeyboardScanTime >= KEYBOARD_SCAN_INTERVAL_MS) {
 		KeyBuffer kBuf;
 		kBuf.begin ();
-		KeyboardScanner::ScanStatus scanStatus = kbdScanner -> scan (kBuf);
+		KeyboardScanner::ScanStatus scanStatus = kbdScanner.scan (kBuf);
+#ifdef ENABLE_MATRIX_TRACE
+		matrixTrace.tick ();
+#endif
+		PROFILE_MARK (LOOPSTAGE_SCAN);
 		if (scanStatus == KeyboardScanner::SCAN_COMPLETE) {
-			handleKeyboard (kBuf);
+			++keyboardHandler.counters.scans;
+			keyboardHandler.handle (kBuf);
+			PROFILE_MARK (LOOPSTAGE_HANDLE);
 		}
 
 		// Update leds - Note that this needs a patched Keyboard library
 		byte leds = usbKeyboard.getLeds ();
-		kbdScanner -> updateLeds (
+		kbdScanner.updateLeds (
 			leds & USBLED_CAPS_LOCK,
 			leds & USBLED_NUM_LOCK,
 			leds & USBLED_SCROLL_LOCK
 		);
+		updateStatusLed (leds & USBLED_CAPS_LOCK);
+		PROFILE_MARK (LOOPSTAGE_LEDS);
 			
 		lastKeyboardScanTime = millis ();
 	}
-}
-
-/** \brief Updates matrix and generates key press/release events
- *
- * \param newBuf Keys currently being pressed
- */
-void handleKeyboard (const KeyBuffer& newBuf) {
-	//~ if (newBuf.size > 0) {
-		//~ debug (F("Handling new buffer: "));
-		//~ for (byte i = 0; i < newBuf.size; ++i) {
-			//~ debug (newBuf[i] & 0xFF, HEX);
-			//~ debug (' ');
-		//~ }
-		//~ debugln (' ');
-	//~ }
-
-	// Check for keys that were just released
-	for (byte r = 0; r < MATRIX_ROWS; ++r) {
-		for (byte c = 0; c < MATRIX_COLS; ++c) {
-			Key& usbKeycode = matrix[r][c];
-			if (newBuf.find (usbKeycode, eventKeyCompare) < 0) {
-				// Key released
-				Log.trace (F("USB Key released: %X\n"), (int) usbKeycode);
-				onKeyReleased (r, c);			// Call this now, before we alter i
-				boolean ok = usbKeyboard.release (usbKeycode);
-#ifdef PEDANTIC_PRESS_RELEASE_CHECKS
-				if (ok) {
-#endif
-					usbKeycode = 0;		// It's a reference so this works :)
-#ifdef PEDANTIC_PRESS_RELEASE_CHECKS
-				} else {
-#else
-				if (!ok) {
-#endif
-					Log.error (F("Key release failed: %X\n"), (int) usbKeycode);
-				}
-			}
-		}
-	}
-	
-	// Check for keys that were just pressed
-	for (byte i = 0; i < newBuf.size; ++i) {
-		const KeyEvent& evt = newBuf[i];
-		if (matrix[evt.row][evt.col] != evt.key) {
-			// New key pressed
-			Log.trace (F("USB Key pressed: %X\n"), (int) evt.key);
-			onKeyPressed (evt.row, evt.col);
-			boolean ok = usbKeyboard.press (evt.key);
-#ifdef PEDANTIC_PRESS_RELEASE_CHECKS
-			if (ok) {
-#endif
-				matrix[evt.row][evt.col] = evt.key;
-#ifdef PEDANTIC_PRESS_RELEASE_CHECKS
-			} else {
-#else
-			if (!ok) {
-#endif
-				/* Any failures are probably due to the internal HID Library
-				 * buffer being full
-				 */
-				Log.error (F("Key press failed: %X\n"), (int) evt.key);
-			}
-		}
-	}
 
-	usbKeyboard.commit ();
+	PROFILE_END ();
 }
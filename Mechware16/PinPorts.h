@@ -0,0 +1,347 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file PinPorts.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Matrix lines spread over any AVR pins
+ *
+ * A port is described by a list of pins, line N being the N-th one. Everything
+ * about the list is worked out at compile time: pins that sit on the same AVR
+ * port at the same distance from their line number are read or written
+ * together, with a single register access, a shift and a mask. Thus a list
+ * that is a whole AVR port in order costs exactly as much as using the port
+ * directly.
+ *
+ * When building for the host, OutputPins and InputPins come from HostPorts.h
+ * and drive the simulated matrix instead.
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+//! \brief AVR I/O ports
+enum AvrPortId: byte {
+	AVRPORT_B,
+	AVRPORT_C,
+	AVRPORT_D,
+	AVRPORT_E,
+	AVRPORT_F
+};
+
+//! \brief A pin, i.e. bit \a BIT of port \a PORT
+template <AvrPortId PORT, byte BIT>
+struct AvrPin {
+	static constexpr AvrPortId port = PORT;
+	static constexpr byte bit = BIT;
+};
+
+//! \brief Smallest unsigned type with at least \a N bits, up to 16
+template <byte N>
+struct PinBits {
+	static_assert (N <= 16, "Too many pins");
+	typedef typename PinBits<(N <= 8 ? 8 : 16)>::Type Type;
+};
+
+template <>
+struct PinBits<8> {
+	typedef byte Type;
+};
+
+template <>
+struct PinBits<16> {
+	typedef word Type;
+};
+
+#ifdef MECHWARE16_HOST
+
+#include <HostPorts.h>
+
+#else
+
+//! \brief Registers of an AVR port
+template <AvrPortId PORT>
+struct AvrPort;
+
+#define DEFINE_AVR_PORT(id, x) \
+	template <> \
+	struct AvrPort<id> { \
+		static volatile uint8_t& pin () { return PIN##x; } \
+		static volatile uint8_t& ddr () { return DDR##x; } \
+		static volatile uint8_t& port () { return PORT##x; } \
+	}
+
+#ifdef PORTB
+DEFINE_AVR_PORT (AVRPORT_B, B);
+#endif
+#ifdef PORTC
+DEFINE_AVR_PORT (AVRPORT_C, C);
+#endif
+#ifdef PORTD
+DEFINE_AVR_PORT (AVRPORT_D, D);
+#endif
+#ifdef PORTE
+DEFINE_AVR_PORT (AVRPORT_E, E);
+#endif
+#ifdef PORTF
+DEFINE_AVR_PORT (AVRPORT_F, F);
+#endif
+
+#undef DEFINE_AVR_PORT
+
+//! \brief Tag used to walk a pin list at compile time
+template <byte I>
+struct PinIndex {
+};
+
+/** \brief Compile-time facts about a list of pins
+ *
+ * Pins are grouped by AVR port and by the distance between their bit in the
+ * port and their position in the list. Each group is handled by its first pin.
+ */
+template <typename... PINS>
+struct PinList {
+	static constexpr byte N = sizeof... (PINS);
+	static_assert (N > 0 && N <= 16, "Pin lists must have 1-16 pins");
+
+	typedef typename PinBits<N>::Type Bits;
+
+	static constexpr AvrPortId ports[N] = {PINS::port...};
+	static constexpr byte bits[N] = {PINS::bit...};
+
+	//! \brief Bits of port \a p that are in the list, starting from pin \a i
+	static constexpr byte portMask (const AvrPortId p, const byte i = 0) {
+		return i >= N ? 0 : (ports[i] == p ? 1 << bits[i] : 0) | portMask (p, i + 1);
+	}
+
+	//! \brief True if no pin before \a i is on the same port as pin \a i
+	static constexpr boolean firstOfPort (const byte i, const byte j = 0) {
+		return j >= i ? true : ports[j] != ports[i] && firstOfPort (i, j + 1);
+	}
+
+	//! \brief How far a line is shifted to reach its pin
+	static constexpr int8_t delta (const byte i) {
+		return static_cast<int8_t> (bits[i]) - static_cast<int8_t> (i);
+	}
+
+	static constexpr boolean sameGroup (const byte i, const byte j) {
+		return ports[i] == ports[j] && delta (i) == delta (j);
+	}
+
+	//! \brief True if pin \a i is the first of its group
+	static constexpr boolean firstOfGroup (const byte i, const byte j = 0) {
+		return j >= i ? true : !sameGroup (i, j) && firstOfGroup (i, j + 1);
+	}
+
+	//! \brief Lines in the same group as pin \a i, starting from pin \a j
+	static constexpr word groupLines (const byte i, const byte j = 0) {
+		return j >= N ? 0 : (sameGroup (i, j) ? 1U << j : 0) | groupLines (i, j + 1);
+	}
+
+	//! \brief All the lines
+	static constexpr word allLines () {
+		return N >= 16 ? 0xFFFF : (1U << N) - 1;
+	}
+
+	//! \brief Move lines to their pins or, with negative \a d, the other way round
+	static constexpr word shift (const word v, const int8_t d) {
+		return d >= 0 ? v << d : v >> -d;
+	}
+};
+
+template <typename... PINS>
+constexpr AvrPortId PinList<PINS...>::ports[];
+
+template <typename... PINS>
+constexpr byte PinList<PINS...>::bits[];
+
+/** \brief Output port made of arbitrary pins
+ *
+ * Driven lines are low outputs, the others are inputs with pull-ups. Pins of
+ * the same AVR port that are not in the list are left alone, but if the list
+ * takes a whole port, its registers are just overwritten.
+ *
+ * \tparam PINS Pins of lines 0, 1, ... as #AvrPin
+ */
+template <typename... PINS>
+class OutputPins {
+private:
+	typedef PinList<PINS...> L;
+
+	template <AvrPortId P>
+	static void release () {
+		constexpr byte mask = L::portMask (P);
+		if (mask == 0xFF) {
+			AvrPort<P>::ddr () = 0x00;
+			AvrPort<P>::port () = 0xFF;
+		} else {
+			AvrPort<P>::ddr () &= ~mask;
+			AvrPort<P>::port () |= mask;
+		}
+	}
+
+	//! \brief Bits of port \a P to drive for \a lines, from pin \a I on
+	template <AvrPortId P, byte I>
+	static byte portBits (const typename L::Bits lines, PinIndex<I>) {
+		return (L::firstOfGroup (I) && L::ports[I] == P ? L::shift (lines & L::groupLines (I), L::delta (I)) : 0) |
+		       portBits<P> (lines, PinIndex<I + 1> ());
+	}
+
+	template <AvrPortId P>
+	static byte portBits (const typename L::Bits lines, PinIndex<L::N>) {
+		(void) lines;
+		return 0;
+	}
+
+	template <byte I>
+	static void drive (const typename L::Bits lines, PinIndex<I>) {
+		if (L::firstOfPort (I)) {
+			constexpr AvrPortId P = L::ports[I];
+			constexpr byte mask = L::portMask (P);
+			const byte low = portBits<P> (lines, PinIndex<0> ());
+			if (mask == 0xFF) {
+				AvrPort<P>::ddr () = low;
+				AvrPort<P>::port () = ~low;
+			} else {
+				AvrPort<P>::ddr () = (AvrPort<P>::ddr () & ~mask) | low;
+				AvrPort<P>::port () = (AvrPort<P>::port () | mask) & ~low;
+			}
+		}
+
+		drive (lines, PinIndex<I + 1> ());
+	}
+
+	static void drive (const typename L::Bits lines, PinIndex<L::N>) {
+		(void) lines;
+	}
+
+	template <byte I>
+	static void releaseAll (PinIndex<I>) {
+		if (L::firstOfPort (I)) {
+			release<L::ports[I]> ();
+		}
+
+		releaseAll (PinIndex<I + 1> ());
+	}
+
+	static void releaseAll (PinIndex<L::N>) {
+	}
+
+public:
+	void begin () {
+		clearAllBits ();
+	}
+
+	//! \brief Drive line \a n low, and only that
+	void setBit (const byte n) {
+		drive (static_cast<typename L::Bits> (1) << n, PinIndex<0> ());
+	}
+
+	//! \brief Stop driving all lines
+	void clearAllBits () {
+		releaseAll (PinIndex<0> ());
+	}
+};
+
+/** \brief Input port made of arbitrary pins
+ *
+ * \tparam TYPE Type of readings, must have a bit per pin. Bits beyond the last
+ *              pin always read as 1, like lines nobody pulls low.
+ * \tparam PINS Pins of lines 0, 1, ... as #AvrPin
+ */
+template <typename TYPE, typename... PINS>
+class InputPins {
+private:
+	typedef PinList<PINS...> L;
+
+	static_assert (sizeof (TYPE) * 8 >= L::N, "Type too small for pins");
+
+	//! \brief Lines found in \a v, a reading of port \a P, from pin \a I on
+	template <AvrPortId P, byte I>
+	static TYPE portLines (const byte v, PinIndex<I>) {
+		return (L::firstOfGroup (I) && L::ports[I] == P ? L::shift (v, -L::delta (I)) & L::groupLines (I) : 0) |
+		       portLines<P> (v, PinIndex<I + 1> ());
+	}
+
+	template <AvrPortId P>
+	static TYPE portLines (const byte v, PinIndex<L::N>) {
+		(void) v;
+		return 0;
+	}
+
+	// Every port is read once, so that all of its lines are sampled together
+	template <byte I>
+	static TYPE gather (PinIndex<I>) {
+		return (L::firstOfPort (I) ? portLines<L::ports[I]> (AvrPort<L::ports[I]>::pin (), PinIndex<0> ()) : 0) |
+		       gather (PinIndex<I + 1> ());
+	}
+
+	static TYPE gather (PinIndex<L::N>) {
+		return 0;
+	}
+
+	template <byte I>
+	static void pullUp (PinIndex<I>) {
+		if (L::firstOfPort (I)) {
+			constexpr AvrPortId P = L::ports[I];
+			constexpr byte mask = L::portMask (P);
+			if (mask == 0xFF) {
+				AvrPort<P>::port () = 0xFF;
+				AvrPort<P>::ddr () = 0x00;
+			} else {
+				AvrPort<P>::port () |= mask;
+				AvrPort<P>::ddr () &= ~mask;
+			}
+		}
+
+		pullUp (PinIndex<I + 1> ());
+	}
+
+	static void pullUp (PinIndex<L::N>) {
+	}
+
+	template <byte I>
+	static void pullDown (PinIndex<I>) {
+		if (L::firstOfPort (I)) {
+			constexpr AvrPortId P = L::ports[I];
+			constexpr byte mask = L::portMask (P);
+			if (mask == 0xFF) {
+				AvrPort<P>::port () = 0x00;
+				AvrPort<P>::ddr () = 0xFF;
+			} else {
+				AvrPort<P>::port () &= ~mask;
+				AvrPort<P>::ddr () |= mask;
+			}
+		}
+
+		pullDown (PinIndex<I + 1> ());
+	}
+
+	static void pullDown (PinIndex<L::N>) {
+	}
+
+public:
+	//! \brief All inputs with pull-ups
+	void begin () {
+		pullUp (PinIndex<0> ());
+	}
+
+	TYPE read () {
+		return gather (PinIndex<0> ()) | static_cast<TYPE> (~L::allLines ());
+	}
+
+	//! \brief Turn all lines into low outputs, until begin() is called again
+	void driveLow () {
+		pullDown (PinIndex<0> ());
+	}
+};
+
+#endif
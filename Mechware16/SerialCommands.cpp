@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file SerialCommands.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Binary command protocol over the serial (CDC) port
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include "SerialCommands.h"
+
+void SerialCommands::begin (Stream& s, Handler h) {
+	stream = &s;
+	handler = h;
+	state = ST_SOF;
+}
+
+void SerialCommands::loop () {
+	for (byte n = 0; n < BYTES_PER_LOOP && state != ST_PENDING && stream -> available () > 0; ++n) {
+		const byte c = stream -> read ();
+
+		switch (state) {
+			case ST_SOF:
+				// Anything but a SOF is just skipped, this is how we resync
+				if (c == SERCMD_SOF) {
+					state = ST_LEN;
+				}
+				break;
+			case ST_LEN:
+				if (c >= 1 && c <= MAX_SERCMD_LEN) {
+					len = c;
+					pos = 0;
+					sum = c;
+					state = ST_DATA;
+				} else {
+					state = ST_SOF;
+				}
+				break;
+			case ST_DATA:
+				buf[pos++] = c;
+				sum += c;
+				if (pos == len) {
+					state = ST_CHECKSUM;
+				}
+				break;
+			case ST_CHECKSUM:
+				if (static_cast<byte> (sum + c) == 0) {
+					state = ST_PENDING;
+				} else {
+					// Corrupted frame, drop it silently
+					state = ST_SOF;
+				}
+				break;
+			case ST_PENDING:
+				break;
+		}
+	}
+
+	// Only execute when the reply can be sent without blocking
+	if (state == ST_PENDING && stream -> availableForWrite () >= MAX_SERCMD_LEN + 3 && execute ()) {
+		state = ST_SOF;
+	}
+}
+
+boolean SerialCommands::execute () {
+	const byte cmd = buf[0];
+	byte reply[MAX_SERCMD_LEN];
+	byte nreply = 0;
+
+	// Reply arguments start after command and status
+	const SerialStatus status = handler (cmd, buf + 1, len - 1, reply + 2, nreply);
+	const boolean done = status != SERSTATUS_IN_PROGRESS;
+	if (done) {
+		reply[0] = cmd | SERCMD_REPLY;
+		reply[1] = status;
+
+		const byte rlen = nreply + 2;
+		byte s = rlen;
+		for (byte i = 0; i < rlen; ++i) {
+			s += reply[i];
+		}
+
+		stream -> write (SERCMD_SOF);
+		stream -> write (rlen);
+		stream -> write (reply, rlen);
+		stream -> write (static_cast<byte> (-s));
+	}
+
+	return done;
+}
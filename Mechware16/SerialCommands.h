@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file SerialCommands.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Binary command protocol over the serial (CDC) port
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+
+/** \brief Start-of-frame marker
+ *
+ * Every frame, in both directions, is made of:
+ * - #SERCMD_SOF
+ * - Length of what follows, excluding the checksum (1 to #MAX_SERCMD_LEN)
+ * - Command code (with bit 7 set in replies)
+ * - Arguments (in replies, the first one is always a #SerialStatus)
+ * - Checksum, chosen so that all bytes from the length on add up to 0
+ *
+ * Multi-byte values are little-endian.
+ */
+const byte SERCMD_SOF = 0xA5;
+
+//! \brief Bit set in the command code of replies
+const byte SERCMD_REPLY = 0x80;
+
+//! \brief Command codes
+enum SerialCommand: byte {
+	SERCMD_PING = 0x01,				//!< No args, replies with the firmware version (3 bytes)
+	SERCMD_GET_PROFILE = 0x02,		//!< Args: profile, replies with active profile and the 5 fields of the requested one
+	SERCMD_SET_SETTING = 0x03,		//!< Args: profile, #SettingField, value
+	SERCMD_DUMP_MATRIX = 0x04,		//!< No args, replies with one byte per row, bits set for pressed keys
+	SERCMD_GET_COUNTERS = 0x05,		//!< No args, replies with the counters
+	SERCMD_ACTION = 0x06,			//!< Args: #SerialAction
+	SERCMD_GET_LATENCY = 0x07,		//!< Args: #LatencyInterval, first bucket, replies with up to 8 buckets (words)
+	SERCMD_GET_BOUNCE = 0x08,		//!< Args: row, col, replies with the #BounceStats of that key
+	SERCMD_GET_LOOP_STATS = 0x09,	//!< Args: #LoopStage, replies with its #LoopStageStats and ms since they were reset (dword)
+	SERCMD_GET_TRACE = 0x0A,		//!< No args, replies with the MatrixTrace flags and the next bytes of the trace
+	SERCMD_KEYMAP_EDIT = 0x10,		//!< No args, start uploading a new keymap override layout
+	SERCMD_KEYMAP_ADD = 0x11,		//!< Args: layer, row, col, key (word)
+	SERCMD_KEYMAP_APPLY = 0x12		//!< No args, switch to the uploaded layout, replies once it has been written to EEPROM
+};
+
+//! \brief Reply status codes
+enum SerialStatus: byte {
+	SERSTATUS_OK,					//!< Command executed
+	SERSTATUS_UNKNOWN_COMMAND,		//!< Command code not recognized
+	SERSTATUS_BAD_ARGS,				//!< Wrong number of arguments or values out of range
+	SERSTATUS_BUSY,					//!< Cannot be executed right now, retry later
+	SERSTATUS_IN_PROGRESS = 0xFF	//!< Never sent: the handler is not done yet and will be called again
+};
+
+//! \brief Settings that can be changed with #SERCMD_SET_SETTING
+enum SettingField: byte {
+	SETTING_MODE,
+	SETTING_ANIMATION,
+	SETTING_BRIGHTNESS,
+	SETTING_KEYMAP_MODE,
+	SETTING_DEBOUNCE,
+	SETTING_ACTIVE_PROFILE = 0xFF	//!< Switch profile, profile argument is ignored
+};
+
+//! \brief Actions that can be triggered with #SERCMD_ACTION
+enum SerialAction: byte {
+	SERACTION_RELEASE_ALL,			//!< Release all keys
+	SERACTION_SAVE_SETTINGS,		//!< Save settings to EEPROM right away
+	SERACTION_RESET_LATENCY,		//!< Clear latency histograms
+	SERACTION_RESET_BOUNCE,			//!< Clear bounce statistics
+	SERACTION_RESET_LOOP_STATS,		//!< Clear main loop timings
+	SERACTION_TRACE_START,			//!< Start recording a new matrix trace
+	SERACTION_TRACE_STOP			//!< Stop recording the matrix trace
+};
+
+/** \brief Binary command protocol over the serial (CDC) port
+ *
+ * Frames are parsed incrementally from loop(), which never blocks and only
+ * looks at #BYTES_PER_LOOP bytes per call, so that talking to the keyboard
+ * does not add any noticeable latency to scanning. Commands are only executed
+ * when there is enough room in the output buffer for the longest reply, until
+ * then they are kept pending.
+ *
+ * Commands that take long, like writing to EEPROM, return
+ * #SERSTATUS_IN_PROGRESS from the handler, which is then called again with the
+ * same arguments on every loop() until they are done. Only then the reply is
+ * sent and the next command is read.
+ */
+class SerialCommands {
+public:
+	//! \brief Maximum number of bytes to process per loop() call
+	static constexpr byte BYTES_PER_LOOP = 16;
+
+	/** \brief Command handler
+	 *
+	 * \param[in] cmd Command code
+	 * \param[in] args Command arguments
+	 * \param[in] nargs Number of arguments
+	 * \param[out] reply Buffer for the reply arguments, with room for
+	 *                   #MAX_SERCMD_LEN - 2 bytes
+	 * \param[out] nreply Number of reply arguments, initialized to 0
+	 * \return The reply status
+	 */
+	typedef SerialStatus (*Handler) (const byte cmd, const byte *args, const byte nargs, byte *reply, byte& nreply);
+
+	void begin (Stream& s, Handler h);
+
+	//! \brief Process incoming data, call as often as possible
+	void loop ();
+
+private:
+	enum State: byte {
+		ST_SOF,
+		ST_LEN,
+		ST_DATA,
+		ST_CHECKSUM,
+		ST_PENDING		//!< Complete frame, waiting for room to reply or for the command to complete
+	};
+
+	Stream *stream;
+
+	Handler handler;
+
+	State state;
+
+	byte buf[MAX_SERCMD_LEN];
+
+	byte len;
+
+	byte pos;
+
+	byte sum;
+
+	//! \brief Run the pending command, return false if it is still in progress
+	boolean execute ();
+};
@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file SettingsStore.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Wear-leveled, non-blocking settings storage in EEPROM
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include <EEPROM.h>
+#include <util/crc16.h>
+#include "EepromWriter.h"
+#include "SettingsStore.h"
+
+word SettingsStore::crc (const Record& r) {
+	/* Start from a non-zero seed, so that an all-zeroes slot does not look
+	 * valid. An erased one (all 0xFF) has the wrong version anyway.
+	 */
+	word c = 0xFFFF;
+	const byte *p = reinterpret_cast<const byte *> (&r);
+	for (byte i = 0; i < sizeof (Record) - sizeof (r.crc); ++i) {
+		c = _crc16_update (c, p[i]);
+	}
+
+	return c;
+}
+
+boolean SettingsStore::begin () {
+	boolean found = false;
+
+	for (byte i = 0; i < N_SLOTS; ++i) {
+		Record r;
+		EEPROM.get (EEP_BASE + i * sizeof (Record), r);
+
+		/* Sequence numbers wrap around, but the ring only ever contains
+		 * consecutive ones, so comparing the difference is enough
+		 */
+		if (r.crc == crc (r) && r.settings.version == SETTINGS_VERSION &&
+		    r.settings.activeProfile < N_PROFILES &&
+		    (!found || static_cast<int8_t> (r.seq - record.seq) > 0)) {
+			record = r;
+			slot = i;
+			found = true;
+		}
+	}
+
+	if (!found) {
+		// Make the first write go to the first slot
+		record.seq = 0;
+		slot = N_SLOTS - 1;
+	}
+
+	return found;
+}
+
+void SettingsStore::changed () {
+	dirty = true;
+	lastChange = millis ();
+}
+
+void SettingsStore::flush () {
+	if (dirty) {
+		lastChange = millis () - QUIET_PERIOD_MS;
+	}
+}
+
+boolean SettingsStore::busy () const {
+	return dirty || EepromWriter::busy ();
+}
+
+void SettingsStore::loop () {
+	if (dirty && !EepromWriter::busy () && millis () - lastChange >= QUIET_PERIOD_MS) {
+		slot = (slot + 1) % N_SLOTS;
+		++record.seq;
+		record.crc = crc (record);
+
+		// Take a snapshot, so that settings can keep changing during the write
+		pending = record;
+
+		EepromWriter::write (EEP_BASE + slot * sizeof (Record), &pending, sizeof (Record));
+		dirty = false;
+	}
+}
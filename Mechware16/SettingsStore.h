@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file SettingsStore.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Wear-leveled, non-blocking settings storage in EEPROM
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+//! \brief Number of switchable profiles
+constexpr byte N_PROFILES = 4;
+
+/** \brief Layout version of #Settings
+ *
+ * Bump this whenever #Settings or #Profile change, records with a different
+ * version will not be loaded.
+ */
+constexpr byte SETTINGS_VERSION = 1;
+
+//! \brief A complete device configuration
+struct Profile {
+	byte mode;			//!< Lighting mode
+	byte animation;		//!< Startup animation
+	byte brightness;	//!< Led brightness
+	byte keymapMode;	//!< One of #KeyMapMode
+	byte debounce;		//!< Debounce length (scans)
+};
+
+//! \brief Settings that are persisted across power cycles
+struct Settings {
+	byte version;
+	byte activeProfile;
+	Profile profiles[N_PROFILES];
+};
+
+/** \brief Wear-leveled, non-blocking settings storage in EEPROM
+ *
+ * Settings live in RAM and are only written to EEPROM once they have not been
+ * changed for #QUIET_PERIOD_MS, so that holding down a combo only causes a
+ * single write.
+ *
+ * Every write goes to the next slot of a ring of #N_SLOTS records, each
+ * carrying a sequence number and a CRC. At startup all slots are read in one
+ * go and the valid record with the most recent sequence number is loaded. This
+ * spreads wear over the whole ring, and a write interrupted by a power loss
+ * just leaves the previous record as the current one, so settings are never
+ * seen half-written.
+ *
+ * Writing is done through #EepromWriter, so the main loop never waits for the
+ * ~3.4 ms each byte takes.
+ *
+ * EEPROM map (1 KB on the ATmega32U4):
+ * - 0x100-0x102: lighting settings of earlier versions, migrated to the first
+ *   profile if no valid record is found.
+ * - 0x110-0x2A0: the ring, 16 records of 25 bytes.
+ * - 0x2A0-0x368: keymap overrides, see KeymapOverrides.h.
+ */
+class SettingsStore {
+public:
+	//! \brief Address of the first slot of the ring in EEPROM
+	static constexpr word EEP_BASE = 0x110;
+
+	//! \brief Number of slots in the ring
+	static constexpr byte N_SLOTS = 16;
+
+	//! \brief Time without changes after which settings are committed (ms)
+	static constexpr unsigned long QUIET_PERIOD_MS = 2000;
+
+	/** \brief Load settings from EEPROM
+	 *
+	 * Records with the wrong CRC or #SETTINGS_VERSION are ignored.
+	 *
+	 * \return True if a valid record was found, false otherwise, in which case
+	 *         settings shall be initialized by the caller
+	 */
+	boolean begin ();
+
+	//! \brief Access the settings in RAM
+	Settings& get () {
+		return record.settings;
+	}
+
+	//! \brief Access the active profile in RAM
+	Profile& getProfile () {
+		return record.settings.profiles[record.settings.activeProfile];
+	}
+
+	/** \brief Notify that settings were changed
+	 *
+	 * They will be committed to EEPROM later on.
+	 */
+	void changed ();
+
+	//! \brief Commit pending changes as soon as possible, without waiting
+	void flush ();
+
+	/** \brief Do internal stuff
+	 *
+	 * Call as often as possible, this starts the actual write when the time
+	 * comes.
+	 */
+	void loop ();
+
+	//! \brief True if there are changes still to be written, or an EEPROM write is in progress
+	boolean busy () const;
+
+private:
+	struct Record {
+		byte seq;
+		Settings settings;
+		word crc;
+	};
+
+	Record record;
+
+	//! \brief Copy of the record being written
+	Record pending;
+
+	//! \brief Slot the current record was read from/written to
+	byte slot;
+
+	boolean dirty = false;
+
+	unsigned long lastChange;
+
+	static word crc (const Record& r);
+};
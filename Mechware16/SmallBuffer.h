@@ -50,8 +50,8 @@ public:
 		return ret;
 	}
 
-	template<typename O>
-	int8_t find (const O& o, boolean (*cmp) (const T& t, const O& o)) const {
+	template<typename O, typename Cmp>
+	int8_t find (const O& o, Cmp cmp) const {
 		int8_t ret = -1;
 	
 		for (byte i = 0; i < size; ++i) {
@@ -88,9 +88,9 @@ public:
 		return found;
 	}
 
-	template<typename O>
-	boolean remove (const O& o, boolean (*cmp) (const T& t, const O& o)) {
-		int8_t pos = find<O> (o, cmp);
+	template<typename O, typename Cmp>
+	boolean remove (const O& o, Cmp cmp) {
+		int8_t pos = find (o, cmp);
 		boolean found = pos >= 0;
 	
 		if (found) {
@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file StatusLed.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Interrupt-driven R/G/B status led
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include "StatusLed.h"
+
+//! \brief Timer interrupt frequency (Hz)
+constexpr unsigned long TIMER_FREQ = 4000UL;
+
+//! \brief Number of brightness levels, i.e. timer ticks per PWM period
+constexpr byte PWM_LEVELS = 32;
+
+struct LedChannel {
+	volatile uint8_t *port;
+	byte mask;
+};
+
+static LedChannel channels[3];
+
+// These are set by the main code and only read by the ISR
+static volatile byte color[3];
+static volatile StatusLed::Pattern pattern;
+
+// These only belong to the ISR
+static byte duty[3];
+static byte pwmCount;
+static byte phase;
+
+
+ISR (TIMER3_COMPA_vect) {
+	if (++pwmCount >= PWM_LEVELS) {
+		/* New PWM period (125 Hz): advance the pattern and work out the duty
+		 * cycles for the next one, so that all we do on the other ticks is a
+		 * few comparisons
+		 */
+		pwmCount = 0;
+		++phase;
+
+		byte scale;
+		switch (pattern) {
+			case StatusLed::PATTERN_BLINK:
+				// 256 ms on, 256 ms off
+				scale = (phase & 0x20) ? 0 : PWM_LEVELS;
+				break;
+			case StatusLed::PATTERN_BREATHE:
+				// Triangle wave over 256 periods, i.e. about 2 seconds
+				scale = (phase < 128 ? phase : 255 - phase) >> 2;
+				break;
+			case StatusLed::PATTERN_SOLID:
+			default:
+				scale = PWM_LEVELS;
+				break;
+		}
+
+		for (byte i = 0; i < 3; ++i) {
+			duty[i] = (static_cast<word> (color[i]) * scale) / PWM_LEVELS;
+		}
+	}
+
+	for (byte i = 0; i < 3; ++i) {
+		if (pwmCount < duty[i]) {
+			*channels[i].port |= channels[i].mask;
+		} else {
+			*channels[i].port &= ~channels[i].mask;
+		}
+	}
+}
+
+
+void StatusLed::begin (const byte pinR, const byte pinG, const byte pinB) {
+	const byte pins[3] = {pinR, pinG, pinB};
+
+	off ();
+	for (byte i = 0; i < 3; ++i) {
+		pinMode (pins[i], OUTPUT);
+		digitalWrite (pins[i], LOW);
+		channels[i].port = portOutputRegister (digitalPinToPort (pins[i]));
+		channels[i].mask = digitalPinToBitMask (pins[i]);
+	}
+
+	// Timer 3 in CTC mode, prescaler 8
+	noInterrupts ();
+	TCCR3A = 0;
+	TCCR3B = _BV (WGM32) | _BV (CS31);
+	OCR3A = F_CPU / 8 / TIMER_FREQ - 1;
+	TIMSK3 = _BV (OCIE3A);
+	interrupts ();
+}
+
+void StatusLed::set (const byte r, const byte g, const byte b, const Pattern pat) {
+	/* No need for atomic access: every field is a single byte and in the worst
+	 * case the ISR will use a mix of old and new values for a single period
+	 */
+	color[0] = r >> 3;
+	color[1] = g >> 3;
+	color[2] = b >> 3;
+	pattern = pat;
+}
+
+void StatusLed::sleep () {
+	TIMSK3 = 0;
+	for (byte i = 0; i < 3; ++i) {
+		*channels[i].port &= ~channels[i].mask;
+	}
+}
+
+void StatusLed::wake () {
+	TIMSK3 = _BV (OCIE3A);
+}
@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file StatusLed.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Interrupt-driven R/G/B status led
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+/** \brief Interrupt-driven R/G/B status led
+ *
+ * The three channels are driven through software PWM from the Timer 3
+ * compare-match interrupt, which runs at 4 kHz. With 32 brightness levels this
+ * gives a 125 Hz refresh rate. Blinking and breathing are computed in the ISR
+ * once per PWM period, so the main loop only needs to call set() when what
+ * must be shown changes.
+ *
+ * Note that Timer 3 is also used by tone() on the ATmega32U4, so the two
+ * cannot be used together.
+ */
+class StatusLed {
+public:
+	enum Pattern: byte {
+		PATTERN_SOLID,		//!< Steady light
+		PATTERN_BLINK,		//!< On and off, about twice per second
+		PATTERN_BREATHE		//!< Slowly fading in and out
+	};
+
+	/** \brief Configure pins and start the timer
+	 *
+	 * The led starts up turned off.
+	 *
+	 * \param[in] pinR Pin driving the red channel
+	 * \param[in] pinG Pin driving the green channel
+	 * \param[in] pinB Pin driving the blue channel
+	 */
+	void begin (const byte pinR, const byte pinG, const byte pinB);
+
+	/** \brief Change color and pattern
+	 *
+	 * \param[in] r Red intensity (0-255, only the 5 MSBs are actually used)
+	 * \param[in] g Green intensity
+	 * \param[in] b Blue intensity
+	 * \param[in] pattern Pattern to show the color with
+	 */
+	void set (const byte r, const byte g, const byte b, const Pattern pattern = PATTERN_SOLID);
+
+	//! \brief Turn led off
+	void off () {
+		set (0, 0, 0);
+	}
+
+	/** \brief Turn led off and stop the timer interrupt
+	 *
+	 * The color and pattern are kept, so that wake() shows them again.
+	 */
+	void sleep ();
+
+	//! \brief Undo sleep()
+	void wake ();
+};
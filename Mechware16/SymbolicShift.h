@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file SymbolicShift.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief SHIFT handling for symbolic mappings
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include "KeyboardScanner.h"
+#include "UsbKeyboard.h"
+
+/** \brief Remove SHIFT from a symbolically-mapped buffer if it must not reach
+ *         the host
+ *
+ * In symbolic mode SHIFT selects the shifted keymap, which already contains
+ * the shifted symbols, so SHIFT must only be reported together with keys that
+ * can take it as it is.
+ *
+ * \param[inout] kbuf Mapped keys
+ * \param[in] force Remove SHIFT regardless of the other keys
+ */
+inline void dropSymbolicShift (KeyBuffer& kbuf, const boolean force = false) {
+	if (kbuf.size > 1 && (kbuf.find (static_cast<Key> (KEY_LEFT_SHIFT), EventHasKey ()) >= 0 ||
+	                      kbuf.find (static_cast<Key> (KEY_RIGHT_SHIFT), EventHasKey ()) >= 0)) {
+		boolean remove = force;
+		for (byte i = 0; i < kbuf.size && !remove; ++i) {
+			switch (kbuf[i].key) {
+				case KEY_LEFT_SHIFT:
+				case KEY_RIGHT_SHIFT:
+				case KEY_LEFT_CTRL:
+				case KEY_LEFT_ALT:
+				case KEY_UP:
+				case KEY_DOWN:
+				case KEY_LEFT:
+				case KEY_RIGHT:
+				case KEY_HOME:
+				case KEY_TAB:
+				case KEY_ESC:
+#ifdef ENABLE_KEY_LAYERS
+				case KEY_F9 ... KEY_F12:
+				case KEY_PRINT:
+				case KEY_PAUSE:
+				case KEY_END:
+				case KEY_PAGE_UP:
+				case KEY_PAGE_DOWN:
+				case KEY_DELETE:
+#endif
+#ifdef ENABLE_TAP_HOLD
+				case KEY_LEFT_GUI:
+				case KEY_RIGHT_ALT:
+#endif
+					// These keys can be pressed with SHIFT freely
+					break;
+				case KEY_F1 ... KEY_F8:
+					/* The function keys change their meaning with shift, so
+					 * we'd better remove it
+					 */
+					remove = true;
+					break;
+				default:
+					/* Some keys require shift to be (de)synthesized, so
+					 * let's pretend it's not pressed
+					 */
+					if (!UsbKeyboard::keyNeedsShift (kbuf[i].key)) {
+						remove = true;
+					}
+					break;
+			}
+		}
+
+		if (remove) {
+			kbuf.remove (static_cast<Key> (KEY_LEFT_SHIFT), EventHasKey ());
+			kbuf.remove (static_cast<Key> (KEY_RIGHT_SHIFT), EventHasKey ());
+		}
+	}
+}
@@ -0,0 +1,213 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file TapHold.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Tap/hold decisions for dual-role keys
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "config.h"
+#include "KeyboardScanner.h"
+#include "KeyState.h"
+#include "Log.h"
+
+//! \brief What else, besides the tapping term, can make a dual-role key a hold
+enum TapHoldResolution: byte {
+	TAPHOLD_TERM,			//!< Nothing, only the tapping term decides
+	TAPHOLD_PERMISSIVE,		//!< Another key is pressed and released meanwhile
+	TAPHOLD_INTERRUPT		//!< Another key is pressed meanwhile
+};
+
+//! \brief Entry of a dual-role key table
+struct DualRoleKey {
+	Key tap;						//!< Sent when the key is tapped
+	Key hold;						//!< Used while the key is held, can be a layer key
+	TapHoldResolution resolution;
+};
+
+/** \brief Tap/hold decisions for dual-role keys
+ *
+ * A dual-role key does nothing when pressed. It becomes a \a tap if it is
+ * released within the tapping term, otherwise it becomes a \a hold as soon as
+ * the term expires or, depending on its #TapHoldResolution, another key
+ * interrupts it. Decisions are taken at every scan, against the time each key
+ * was pressed.
+ *
+ * Keys pressed while a decision is pending are held back until it is made, so
+ * that they reach the host after the modifier or the tap. Keys pressed when
+ * nothing is pending are never delayed.
+ *
+ * A tap is reported for a single scan, on the position of the dual-role key,
+ * even though that is no longer pressed. Keys that were held back and released
+ * in the meantime are reported the same way, one scan later, so that they come
+ * after the tap.
+ */
+class TapHold {
+public:
+	//! \brief Maximum number of dual-role keys being pressed at once
+	static constexpr byte MAX_PENDING = 4;
+
+	//! \brief How long a dual-role key must be held to be a hold (ms)
+	void setTerm (const word ms) {
+		term = ms;
+	}
+
+	/** \brief A dual-role key was pressed
+	 *
+	 * \param[in] row Matrix row
+	 * \param[in] col Matrix column
+	 * \param[in] resolution How to decide
+	 * \param[in] now Time of the scan (ms)
+	 */
+	void press (const byte row, const byte col, const TapHoldResolution resolution, const word now) {
+		if (nSlots < MAX_PENDING) {
+			Slot& s = slots[nSlots++];
+			s.row = row;
+			s.col = col;
+			s.resolution = resolution;
+			s.since = now;
+			s.pending = true;
+			waiting = true;
+		} else {
+			// No room to wait, just hold it
+			Log.warn (LOG_STR ("Too many dual-role keys pressed\n"));
+			holding.set (row, col, true);
+		}
+	}
+
+	/** \brief Take decisions
+	 *
+	 * Must be called at every scan, after press().
+	 *
+	 * \param[in] pressed All keys that are pressed
+	 * \param[in] dualRole Positions of dual-role keys
+	 * \param[in] now Time of the scan (ms)
+	 */
+	void update (const KeyState& pressed, const KeyState& dualRole, const word now) {
+		const KeyState others = pressed & ~dualRole;
+		if (waiting) {
+			heldBack |= others & ~lastOthers;
+		}
+		lastOthers = others;
+
+		// Held back keys released before the decision must still be reported
+		ghosts |= heldBack & ~pressed;
+		heldBack &= pressed;
+		holding &= pressed;
+
+		tapped.clear ();
+		boolean tap = false;
+		boolean stillWaiting = false;
+		for (byte i = 0; i < nSlots;) {
+			Slot& s = slots[i];
+			if (!pressed.isPressed (s.row, s.col)) {
+				if (s.pending) {
+					tapped.set (s.row, s.col, true);
+					tap = true;
+				}
+				slots[i] = slots[--nSlots];
+				continue;
+			}
+
+			if (s.pending) {
+				boolean hold = static_cast<word> (now - s.since) >= term;
+				switch (s.resolution) {
+					case TAPHOLD_INTERRUPT:
+						hold = hold || !heldBack.empty () || !ghosts.empty ();
+						break;
+					case TAPHOLD_PERMISSIVE:
+						hold = hold || !ghosts.empty ();
+						break;
+					case TAPHOLD_TERM:
+					default:
+						break;
+				}
+
+				if (hold) {
+					s.pending = false;
+					holding.set (s.row, s.col, true);
+				} else {
+					stillWaiting = true;
+				}
+			}
+
+			++i;
+		}
+
+		if (!stillWaiting && !tap) {
+			/* Let held back keys go, unless a tap is being reported right now:
+			 * they must come after it, so give them another scan
+			 */
+			tapped |= ghosts;
+			ghosts.clear ();
+			heldBack.clear ();
+		}
+
+		waiting = stillWaiting || tap;
+	}
+
+	//! \brief Check if a key must not be reported yet
+	boolean isHeldBack (const byte row, const byte col) const {
+		return heldBack.isPressed (row, col);
+	}
+
+	//! \brief Check if a dual-role key has been decided to be a hold
+	boolean isHolding (const byte row, const byte col) const {
+		return holding.isPressed (row, col);
+	}
+
+	//! \brief Dual-role keys that are holds
+	const KeyState& getHolding () const {
+		return holding;
+	}
+
+	/** \brief Keys to be reported as pressed for this scan only
+	 *
+	 * These are dual-role keys that were tapped and held back keys that were
+	 * released before they could be reported.
+	 */
+	const KeyState& getTapped () const {
+		return tapped;
+	}
+
+private:
+	struct Slot {
+		byte row;
+		byte col;
+		TapHoldResolution resolution;
+		boolean pending;
+		word since;
+	};
+
+	word term = TAP_HOLD_TERM_MS;
+
+	Slot slots[MAX_PENDING];
+
+	byte nSlots = 0;
+
+	//! \brief True while held back keys cannot be reported yet
+	boolean waiting = false;
+
+	//! \brief Keys other than dual-role ones pressed at the last update()
+	KeyState lastOthers;
+
+	KeyState heldBack;
+
+	//! \brief Keys that were held back and released
+	KeyState ghosts;
+
+	KeyState holding;
+
+	KeyState tapped;
+};
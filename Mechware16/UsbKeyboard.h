@@ -17,12 +17,20 @@
 #pragma once
 
 #include <HID-Project.h>
+#include "config.h"
 
 const uint16_t MASK_ASCIIKEY = (uint16_t) (1U << 15);
 #define A(c) ((c) | (MASK_ASCIIKEY))
 #define KEYPRESS_IS_ASCII(k) ((k) & MASK_ASCIIKEY)
 #define ASCII_EXTRACT(c) static_cast<uint8_t> ((c) & 0xFF)
 
+//! \brief What the Pound key of Commodore keyboards produces in symbolic mode
+#ifndef ENABLE_EURO_KEY
+const uint16_t POUND_SIGN = A(163);
+#else
+const uint16_t POUND_SIGN = A(164);
+#endif
+
 // Use same values as HID-Project's KeyboardLeds
 enum UsbKeyboardLeds {
 	USBLED_NUM_LOCK		= (1 << 0),
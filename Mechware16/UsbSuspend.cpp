@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file UsbSuspend.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Low-power waiting while the USB host sleeps
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include "config.h"
+
+#ifdef ENABLE_USB_SUSPEND
+
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "UsbSuspend.h"
+
+boolean UsbSuspend::isSuspended () const {
+	return USBDevice.configured () && USBDevice.isSuspended ();
+}
+
+void UsbSuspend::enter () {
+	// Nothing uses the ADC, but the Arduino core turns it on
+	adcsra = ADCSRA;
+	ADCSRA &= ~_BV (ADEN);
+}
+
+void UsbSuspend::leave () {
+	ADCSRA = adcsra;
+}
+
+boolean UsbSuspend::keyPressed () const {
+	return PINB != 0xFF;
+}
+
+void UsbSuspend::sleep () {
+	/* Wake up on any change of the rows. The ISR belongs to the passive
+	 * scanner, whatever it queues is never looked at by the others.
+	 */
+	const byte pcmsk = PCMSK0;
+	const byte pcicr = PCICR;
+	PCMSK0 = 0xFF;
+	PCIFR = _BV (PCIF0);
+	PCICR |= _BV (PCIE0);
+
+	// ... or when the host resumes, but not at every millis() tick
+	TIMSK0 &= ~_BV (TOIE0);
+
+	set_sleep_mode (SLEEP_MODE_IDLE);
+	cli ();
+	if (!keyPressed () && isSuspended ()) {
+		sleep_enable ();
+		sei ();				// Only takes effect after the next instruction
+		sleep_cpu ();
+		sleep_disable ();
+	}
+	sei ();
+
+	TIMSK0 |= _BV (TOIE0);
+	PCICR = pcicr;
+	PCMSK0 = pcmsk;
+}
+
+void UsbSuspend::idle () {
+	set_sleep_mode (SLEEP_MODE_IDLE);
+	sleep_mode ();
+}
+
+boolean UsbSuspend::wakeupHost () {
+	return USBDevice.wakeupHost ();
+}
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file UsbSuspend.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Low-power waiting while the USB host sleeps
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+/** \brief Low-power waiting while the USB host sleeps
+ *
+ * The Arduino core keeps track of USB suspend and resume, this just puts the
+ * MCU to sleep in between and asks the host to wake up when a key is pressed.
+ *
+ * The USB controller needs its clock to notice the host resuming, so the MCU
+ * can only go into idle mode. The millis() tick is stopped meanwhile, so that
+ * it does not wake the MCU up every millisecond: any other interrupt source
+ * that is not needed should be stopped as well.
+ *
+ * Keys are noticed through the pin change interrupt of port B, where the rows
+ * of the matrix are connected, once the scanner has set the matrix up through
+ * KeyboardScanner::suspend().
+ */
+class UsbSuspend {
+public:
+	//! \brief Check if the host has suspended the bus
+	boolean isSuspended () const;
+
+	//! \brief Stop what is not needed while suspended
+	void enter ();
+
+	//! \brief Undo enter()
+	void leave ();
+
+	//! \brief Check if any key is pulling its row low
+	boolean keyPressed () const;
+
+	/** \brief Sleep until a key is pressed or the host resumes
+	 *
+	 * Returns immediately if a key is already pressed.
+	 */
+	void sleep ();
+
+	//! \brief Sleep until the next interrupt, which is at most 1 ms away
+	void idle ();
+
+	/** \brief Signal remote wakeup to the host
+	 *
+	 * \return False if the host did not allow that
+	 */
+	boolean wakeupHost ();
+
+private:
+	byte adcsra;
+};
@@ -35,6 +35,29 @@
  */
 #define DISABLE_LOGGING
 
+/** \def ENABLE_BINARY_LOGGING
+ *
+ * \brief Log compact binary records instead of text
+ *
+ * Rather than formatting messages on the spot, only an ID of the format string
+ * and the raw arguments are stored in a RAM ring, which is sent to the serial
+ * port from the main loop, when there is room in the output buffer. This makes
+ * logging way cheaper, so that it does not disturb timing as much.
+ *
+ * Format strings wrapped in LOG_STR() are replaced by a hash at compile time,
+ * so they take no flash at all. This makes it affordable to leave logging
+ * enabled in regular builds.
+ *
+ * Records are turned back into text by tools/logdecode.py, which finds the
+ * format strings in the sources and in the firmware ELF file.
+ *
+ * This is a way of logging, so #DISABLE_LOGGING must be commented out too.
+ */
+//~ #define ENABLE_BINARY_LOGGING
+
+//! \brief Size of the binary logging ring (bytes)
+#define LOG_RING_SIZE 128
+
 /** \def THRESHOLD_LEVEL
  *
  * \brief Threshold log level
@@ -52,8 +75,76 @@
  */
 //~ #define ENABLE_SERIAL_COMMANDS
 
+/** \def ENABLE_LATENCY_STATS
+ *
+ * \brief Measure how long key presses take to be reported
+ *
+ * Keeps histograms of the time spent debouncing, waiting for a scan and
+ * reporting every key press, see LatencyStats.h. These take 128 bytes of RAM
+ * and Timer 1. Read them with #SERCMD_GET_LATENCY.
+ */
+//~ #define ENABLE_LATENCY_STATS
+
+/** \def ENABLE_LOOP_PROFILER
+ *
+ * \brief Time every stage of the main loop
+ *
+ * Keeps the shortest, longest and average time spent in each part of loop()
+ * and how many iterations it runs per second, see LoopProfiler.h. Shares Timer
+ * 1 with #ENABLE_LATENCY_STATS and takes about 100 bytes of RAM. Read the
+ * timings with #SERCMD_GET_LOOP_STATS.
+ */
+//~ #define ENABLE_LOOP_PROFILER
+
+/** \def ENABLE_MATRIX_TRACE
+ *
+ * \brief Record what the keyboard scanner reads
+ *
+ * Traces are started, stopped and downloaded through the serial port (see
+ * tools/mechctl.py) and can then be replayed off-target with the replay tool
+ * in host/, to reproduce issues such as stuck keys or phantom presses. See
+ * MatrixTrace.h.
+ *
+ * Traces only take a few bytes per second while no key changes, but the ring
+ * must be downloaded faster than it fills up, or recording stops.
+ */
+//~ #define ENABLE_MATRIX_TRACE
+
+//! \brief Size of the matrix trace ring (bytes)
+#define MATRIX_TRACE_SIZE 256
+
+/** \def ENABLE_STATIC_DISPATCH
+ *
+ * \brief Make scanner, mapper and animation methods non-virtual
+ *
+ * The sketch always calls them on objects of known type, so nothing needs
+ * virtual dispatch and dropping it saves the RAM taken by vtables. See
+ * Dispatch.h.
+ */
+//~ #define ENABLE_STATIC_DISPATCH
+
 //~ #define ENABLE_MATRIX_DEBUG
 
+/** \def KEYBOARD_C64
+ *
+ * \brief Drive a Commodore 64 keyboard instead of a C16/Plus4 one
+ *
+ * The keyboard is scanned by #KbdScannerC64, RESTORE must be wired to pin 7.
+ * The passive scanner is not available and per-key lighting still follows the
+ * C16 layout. Key combos are the same as on the C16, with F1/F3/F5/F7 taking
+ * the place of F1/F2/F3/HELP.
+ */
+//~ #define KEYBOARD_C64
+
+/** \def KEYBOARD_VIC20
+ *
+ * \brief Drive a Commodore VIC-20 keyboard instead of a C16/Plus4 one
+ *
+ * Same as #KEYBOARD_C64, but with the matrix wired the way the VIC-20 does,
+ * see #KbdScannerVic20.
+ */
+//~ #define KEYBOARD_VIC20
+
 /** \brief Keyboard poll/report interval (ms)
  *
  * Like #CONTROLLER_READ_INTERVAL_MS but for the keyboard ;).
@@ -80,11 +171,57 @@ const unsigned long KEYBOARD_SCAN_INTERVAL_MS = 15;
  */
 #define DEBOUNCE_FACTOR_C16 20
 
-/*! \brief Retry failed key presses/releases
+/** \brief Debounce factor for C64 and VIC-20 keyboards
+ *
+ * Like #DEBOUNCE_FACTOR_C16. These keyboards are older and their contacts are
+ * usually more worn.
+ */
+#define DEBOUNCE_FACTOR_C64 30
+
+/** \def ENABLE_ADAPTIVE_DEBOUNCE
+ *
+ * \brief Debounce every key on its own, adapting to how much it bounces
+ *
+ * Instead of waiting for the whole matrix to be stable, every key gets its own
+ * debounce window, which is adjusted according to how the key behaved in the
+ * past. Healthy keys end up with short windows and thus low latency, while
+ * worn keys that bounce a lot get filtered more.
+ *
+ * The debounce length setting becomes the longest window any key can get, so
+ * it should still be raised if keys get pressed briefly a second time.
+ *
+ * Per-key bounce statistics can be read through the serial port (see
+ * tools/mechctl.py).
+ *
+ * This takes 10 bytes of RAM per matrix position.
+ */
+//~ #define ENABLE_ADAPTIVE_DEBOUNCE
+
+//! \brief Shortest debounce window a key can get with #ENABLE_ADAPTIVE_DEBOUNCE (scans)
+#define ADAPTIVE_DEBOUNCE_MIN 3
+
+//! \brief Extra scans added to windows over the bounces seen with #ENABLE_ADAPTIVE_DEBOUNCE
+#define ADAPTIVE_DEBOUNCE_MARGIN 2
+
+/** \def DEBOUNCER
+ *
+ * \brief Debouncing strategy of matrix scanners
+ *
+ * One of the debouncers in Debouncers.h: CounterDebouncer (the default, a
+ * single counter for the whole matrix), PerKeyDebouncer, EagerDebouncer or
+ * IntegratorDebouncer. Use host/debench to find out which one suits a
+ * keyboard best. Cannot be used together with #ENABLE_ADAPTIVE_DEBOUNCE.
+ */
+//~ #define DEBOUNCER IntegratorDebouncer
+
+/*! \brief Retry failed key presses
  *
  * Enabling this can cause a mess, as if a key isn't mapped in the current
  * layout, keypresses will fail and the code will loop indefinitely. No point in
  * enabling this at the moment.
+ *
+ * Releases are never retried, since they only fail when the key is not being
+ * reported anyway.
  */
 #define PEDANTIC_PRESS_RELEASE_CHECKS
 
@@ -97,6 +234,56 @@ const unsigned long KEYBOARD_SCAN_INTERVAL_MS = 15;
  */
 //~ #define ENABLE_EURO_KEY
 
+/** \def ENABLE_KEY_LAYERS
+ *
+ * \brief Turn the HELP key into an Fn key
+ *
+ * While Fn is held, the number keys produce F1-F10, F1/F2/F3 produce
+ * F11/F12/Print Screen, the cursor keys produce Home, End, Page Up and Page
+ * Down, DEL produces Delete and RUN/STOP produces Pause. Fn + CLR/HOME locks
+ * the Fn layer on, until pressed again. See KeyLayers.h.
+ *
+ * This takes about 100 bytes of RAM per scanner.
+ */
+//~ #define ENABLE_KEY_LAYERS
+
+/** \def ENABLE_TAP_HOLD
+ *
+ * \brief Make some keys do something else when held
+ *
+ * C= produces the GUI key when tapped and works as usual when held. CLR/HOME
+ * produces Home when tapped and AltGr when held. See TapHold.h.
+ *
+ * Pressing another key while a dual-role key is down makes it a hold right
+ * away, so that typing is never held back. The price is that rolling over,
+ * e.g. pressing a letter just before releasing C=, gives C= + letter instead of
+ * GUI followed by the letter. Otherwise keys can wait for the decision up to
+ * #TAP_HOLD_TERM_MS, see #TAPHOLD_PERMISSIVE in TapHold.h.
+ */
+//~ #define ENABLE_TAP_HOLD
+
+//! \brief Dual-role keys held longer than this are holds with #ENABLE_TAP_HOLD (ms)
+#define TAP_HOLD_TERM_MS 200
+
+/** \def ENABLE_USB_SUSPEND
+ *
+ * \brief Save power while the host sleeps and wake it up with any key
+ *
+ * When the host suspends the USB bus, the lighting is turned off and the MCU
+ * sleeps until a key is pressed, then asks the host to wake up, if it allows
+ * that. See UsbSuspend.h.
+ *
+ * With the C16 scanner any key wakes the MCU up immediately, with the passive
+ * scanner the matrix is still scanned, only more slowly.
+ */
+//~ #define ENABLE_USB_SUSPEND
+
+//! \brief Matrix scan interval while suspended, when keys cannot wake the MCU up (ms)
+#define SUSPENDED_SCAN_INTERVAL_MS 50
+
+//! \brief How long to wait for the host to resume after asking it to wake up (ms)
+#define USB_WAKEUP_TIMEOUT_MS 1000
+
 #define KEYMAPS_IN_FLASH
 
 //~ #define LED_PIN LED_BUILTIN
@@ -108,6 +295,36 @@ const byte MAX_SERCMD_LEN = 32;
  * END OF SETTINGS
  ******************************************************************************/
 
+#if defined (ENABLE_BINARY_LOGGING) && defined (DISABLE_LOGGING)
+#error "Binary logging needs logging, please comment out DISABLE_LOGGING"
+#endif
+
+#if defined (KEYBOARD_C64) && defined (KEYBOARD_VIC20)
+#error "Please select a single keyboard"
+#elif !defined (KEYBOARD_C64) && !defined (KEYBOARD_VIC20)
+#define KEYBOARD_C16
+#endif
+
+//! \brief Debounce factor new profiles start with
+#ifdef KEYBOARD_C16
+#define DEFAULT_DEBOUNCE DEBOUNCE_FACTOR_C16
+#else
+#define DEFAULT_DEBOUNCE DEBOUNCE_FACTOR_C64
+#endif
+
+#if defined (ENABLE_ADAPTIVE_DEBOUNCE) && defined (DEBOUNCER)
+#error "Please select a single debouncer"
+#elif defined (ENABLE_ADAPTIVE_DEBOUNCE)
+#define DEBOUNCER AdaptiveDebouncer
+#elif !defined (DEBOUNCER)
+#define DEBOUNCER CounterDebouncer
+#endif
+
+// Layers and dual-role keys are handled by the same code
+#if defined (ENABLE_KEY_LAYERS) || defined (ENABLE_TAP_HOLD)
+#define USE_KEY_LAYERS
+#endif
+
 
 //! \name Version number stuff
 //! @{
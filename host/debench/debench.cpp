@@ -0,0 +1,717 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file debench.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Benchmark of the debouncing strategies
+ *
+ * Every debouncer in Debouncers.h, plus AdaptiveDebouncer, is plugged into a
+ * #MatrixKeyboardScanner and fed the same raw readings, which come from:
+ * - A bounce waveform generator: a few keys are pressed and released at
+ *   random, every edge being followed by bounces of random length for a random
+ *   time. Glitches, i.e. single scans reading the wrong level, can be added
+ *   too. Waveforms are picked by name (see #WAVEFORMS) and can be tuned with
+ *   -b and -g.
+ * - A matrix trace recorded on a keyboard (see MatrixTrace.h), with -t. Since
+ *   there is no telling what the user actually did, a key is taken as pressed
+ *   or released once it has read so for -r ms, starting from its first edge.
+ *
+ * For every strategy, the matrix is looked at after every scan the scanner
+ * says it can be used, and compared with what was actually done:
+ * - Latency is the time from the first edge of a press or release to the scan
+ *   that shows it. Percentiles are given in ms.
+ * - Presses that never show up are missed.
+ * - Presses that show up when no key was pressed, or more than once for the
+ *   same press, are false triggers.
+ * - CPU cost is the time the debouncer alone takes per scan, in ns, with the
+ *   "none" strategy, which does no debouncing, as a reference. Host timings
+ *   only tell how strategies compare with each other, not how long they take
+ *   on the ATmega.
+ *
+ * The same seed always produces the same waveforms.
+ *
+ * Usage: debench [-w WAVEFORM | -t TRACE] [-l LENGTH] [-p US] [-k KEYS]
+ *                [-n PRESSES] [-b MIN,MAX] [-g RATE] [-r MS] [-s SEED]
+ *   -w  Waveform to generate (default: all of them)
+ *   -t  Use a recorded trace instead
+ *   -l  Debounce length, in scans (default: #DEBOUNCE_FACTOR_C16)
+ *   -p  Time between scans of generated waveforms, and of traces after their
+ *       last tick, in us (default: 300)
+ *   -k  Number of keys being typed on at the same time (default: 4)
+ *   -n  Presses per key (default: 250)
+ *   -b  Shortest and longest bounce time, in us
+ *   -g  Glitches per key per second
+ *   -r  How long a trace must read the same for a key to change (default: 10)
+ *   -s  Seed for the random waveforms (default: 1)
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "MatrixKeyboardScanner.h"
+#include "Debouncers.h"
+#include "AdaptiveDebouncer.h"
+#include <HostMatrix.h>
+#include <TraceReader.h>
+
+static const byte ROWS = 8;
+static const byte COLS = 8;
+
+static const double BENCH_SECONDS = 0.2;
+
+//! \brief How long keys are held and left alone when generating waveforms (us)
+static const unsigned long HOLD_MIN = 40000;
+static const unsigned long HOLD_MAX = 200000;
+static const unsigned long GAP_MIN = 60000;
+static const unsigned long GAP_MAX = 600000;
+
+/******************************************************************************/
+
+//! \brief Parameters of a bounce waveform generator
+struct Waveform {
+	const char *name;
+	unsigned long bounceMin;	//!< Shortest time from the first to the last bounce (us)
+	unsigned long bounceMax;	//!< Longest time from the first to the last bounce (us)
+	unsigned long pulseMin;		//!< Shortest bounce (us)
+	unsigned long pulseMax;		//!< Longest bounce (us)
+	double glitchRate;			//!< Glitches per key per second
+};
+
+static const Waveform WAVEFORMS[] = {
+	{"clean",	0,		200,	20,		100,	0.0},
+	{"bouncy",	500,	5000,	50,		800,	0.0},
+	{"worn",	2000,	15000,	100,	3000,	0.0},
+	{"noisy",	500,	5000,	50,		800,	0.5}
+};
+
+static const byte N_WAVEFORMS = sizeof (WAVEFORMS) / sizeof (WAVEFORMS[0]);
+
+//! \brief A key changing state, as done by the user
+struct Transition {
+	unsigned long us;
+	boolean pressed;
+};
+
+//! \brief Raw readings of a scan, a bit per key, 0 if pressed
+struct Scan {
+	unsigned long us;
+	byte rows[ROWS];
+};
+
+//! \brief Raw readings to be fed to the scanners, along with what they mean
+struct Recording {
+	std::vector<Scan> scans;
+
+	//! \brief Transitions of every key, in order
+	std::vector<Transition> truth[ROWS][COLS];
+
+	unsigned long presses;
+};
+
+//! \brief What a strategy did with a recording
+struct Result {
+	std::vector<unsigned long> pressLatency;
+	std::vector<unsigned long> releaseLatency;
+	unsigned long missed;
+	unsigned long falseTriggers;
+	double nsPerScan;
+};
+
+/******************************************************************************/
+
+//! \brief Small, fast and, above all, the same everywhere
+static uint32_t rng;
+
+static uint32_t rnd () {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+//! \brief Random number in [\a lo, \a hi]
+static unsigned long rnd (const unsigned long lo, const unsigned long hi) {
+	return lo + rnd () % (hi - lo + 1);
+}
+
+static double rndUnit () {
+	return rnd () / 4294967296.0;
+}
+
+/******************************************************************************/
+
+//! \brief Raw level of a generated key, as it bounces
+class BouncingKey {
+public:
+	BouncingKey (const Waveform& wf, const std::vector<Transition>& t): wave (wf), truth (t), next (0),
+		pressed (false), level (false), bounceEnd (0), nextToggle (0) {
+	}
+
+	//! \brief Level at time \a us, true if pressed. Must be called at increasing times.
+	boolean at (const unsigned long us, const unsigned long period) {
+		while (next < truth.size () && truth[next].us <= us) {
+			// First contact, then bounces until bounceEnd
+			const unsigned long t = truth[next].us;
+			pressed = truth[next].pressed;
+			level = pressed;
+			bounceEnd = t + rnd (wave.bounceMin, wave.bounceMax);
+			nextToggle = t + rnd (wave.pulseMin, wave.pulseMax);
+			++next;
+		}
+
+		while (nextToggle < bounceEnd && nextToggle <= us) {
+			level = !level;
+			nextToggle += rnd (wave.pulseMin, wave.pulseMax);
+		}
+
+		if (us >= bounceEnd) {
+			level = pressed;
+		}
+
+		boolean ret = level;
+		if (wave.glitchRate > 0 && rndUnit () < wave.glitchRate * period / 1e6) {
+			ret = !ret;
+		}
+
+		return ret;
+	}
+
+private:
+	const Waveform& wave;
+
+	const std::vector<Transition>& truth;
+
+	size_t next;
+
+	boolean pressed;
+
+	boolean level;
+
+	unsigned long bounceEnd;
+
+	unsigned long nextToggle;
+};
+
+static void generate (Recording& rec, const Waveform& wave, const byte nKeys, const unsigned long pressesPerKey,
+                      const unsigned long period) {
+	// Keys are typed on independently, at random places in the matrix
+	byte keyRow[ROWS * COLS];
+	byte keyCol[ROWS * COLS];
+	boolean used[ROWS][COLS] = {{false}};
+	unsigned long end = 0;
+	for (byte k = 0; k < nKeys; ++k) {
+		byte r, c;
+		do {
+			r = rnd () % ROWS;
+			c = rnd () % COLS;
+		} while (used[r][c]);
+		used[r][c] = true;
+		keyRow[k] = r;
+		keyCol[k] = c;
+
+		std::vector<Transition>& truth = rec.truth[r][c];
+		unsigned long t = 0;
+		for (unsigned long i = 0; i < pressesPerKey; ++i) {
+			t += rnd (GAP_MIN, GAP_MAX);
+			truth.push_back (Transition {t, true});
+			t += rnd (HOLD_MIN, HOLD_MAX);
+			truth.push_back (Transition {t, false});
+		}
+		end = std::max (end, t + GAP_MIN);
+		rec.presses += pressesPerKey;
+	}
+
+	std::vector<BouncingKey> keys;
+	for (byte k = 0; k < nKeys; ++k) {
+		keys.push_back (BouncingKey (wave, rec.truth[keyRow[k]][keyCol[k]]));
+	}
+
+	for (unsigned long t = 0; t <= end; t += period) {
+		Scan s;
+		s.us = t;
+		memset (s.rows, 0xFF, sizeof (s.rows));
+		for (byte k = 0; k < nKeys; ++k) {
+			if (keys[k].at (t, period)) {
+				s.rows[keyRow[k]] &= ~(1 << keyCol[k]);
+			}
+		}
+		rec.scans.push_back (s);
+	}
+}
+
+/******************************************************************************/
+
+//! \brief Give evenly spread times to the scans from \a first on, the last one being at \a us
+static void spread (Recording& rec, const size_t first, const unsigned long from, const unsigned long us) {
+	const size_t n = rec.scans.size () - first;
+	for (size_t i = 0; i < n; ++i) {
+		rec.scans[first + i].us = from + (us - from) * (i + 1) / n;
+	}
+}
+
+static void addScans (Recording& rec, const byte rows[ROWS], const unsigned long n) {
+	Scan s;
+	s.us = 0;
+	memcpy (s.rows, rows, sizeof (s.rows));
+	rec.scans.insert (rec.scans.end (), n, s);
+}
+
+/** \brief Turn a trace into scans
+ *
+ * Only the times of scans done by scan() are known, the others are spread
+ * evenly in between. Scans after the last of those are taken as \a period
+ * apart.
+ *
+ * \return The error found in the trace, or nullptr
+ */
+static const char *load (Recording& rec, const std::vector<byte>& trace, const unsigned long period) {
+	TraceReader r (trace);
+	unsigned long arg;
+	if (r.header (arg) != TRACE_START || arg == TRACESRC_PASSIVE16) {
+		return "not a matrix scanner trace";
+	}
+	r.next ();	// Keymap mode
+	r.next ();	// Debounce length
+
+	byte rows[ROWS];
+	memset (rows, 0xFF, sizeof (rows));
+	unsigned long tickUs = 0;
+	size_t untimed = 0;
+
+	while (!r.atEnd () && !r.getError ()) {
+		switch (r.header (arg)) {
+			case TRACE_ROW: {
+				const byte cols = r.next ();
+				if (arg >= ROWS) {
+					r.fail ("bad row record");
+				} else {
+					rows[arg] = cols;
+				}
+				break;
+			}
+			case TRACE_SCANS:
+				addScans (rec, rows, arg);
+				break;
+			case TRACE_TICK: {
+				addScans (rec, rows, r.varint ());
+				const unsigned long us = tickUs + arg * 1000UL;
+				spread (rec, untimed, tickUs, us);
+				tickUs = us;
+				untimed = rec.scans.size ();
+				break;
+			}
+			case TRACE_MODE:
+			case TRACE_DEBOUNCE:
+			case TRACE_RESTORE:
+				// Nothing to do with debouncing
+				break;
+			default:
+				r.fail ("unexpected record");
+				break;
+		}
+	}
+
+	spread (rec, untimed, tickUs, tickUs + (rec.scans.size () - untimed) * period);
+
+	return r.getError ();
+}
+
+/** \brief Work out what the user did from the raw readings
+ *
+ * A key changes state once it has read the other level for \a stableUs,
+ * the change being dated at the first edge after the previous change.
+ */
+static void guessTruth (Recording& rec, const unsigned long stableUs) {
+	for (byte r = 0; r < ROWS; ++r) {
+		for (byte c = 0; c < COLS; ++c) {
+			boolean state = false;		// What the user did last
+			boolean level = false;		// Current raw level
+			unsigned long levelSince = 0;
+			boolean changing = false;
+			unsigned long firstEdge = 0;
+
+			for (size_t i = 0; i < rec.scans.size (); ++i) {
+				const Scan& s = rec.scans[i];
+				const boolean l = !(s.rows[r] & (1 << c));
+				if (l != level) {
+					level = l;
+					levelSince = s.us;
+					if (!changing && level != state) {
+						changing = true;
+						firstEdge = s.us;
+					}
+				}
+
+				if (changing && s.us - levelSince >= stableUs) {
+					if (level != state) {
+						state = level;
+						rec.truth[r][c].push_back (Transition {firstEdge, state});
+						if (state) {
+							++rec.presses;
+						}
+					}
+					// Otherwise it was just noise
+					changing = false;
+				}
+			}
+		}
+	}
+}
+
+/******************************************************************************/
+
+//! \brief No debouncing at all, as a reference
+template <byte NUMROWS, byte NUMCOLS, typename TYPECOLS>
+class NullDebouncer: public NoBounceStats {
+public:
+	typedef MatrixBase<NUMROWS, TYPECOLS> Matrix;
+
+	void begin (const Matrix& initial, const byte len) {
+		(void) len;
+		for (byte row = 0; row < NUMROWS; ++row) {
+			raw[row] = initial[row];
+		}
+	}
+
+	void setLength (const byte len) {
+		(void) len;
+	}
+
+	TYPECOLS update (const byte row, const TYPECOLS data) {
+		raw[row] = data;
+		return data;
+	}
+
+	TYPECOLS getRaw (const byte row) const {
+		return raw[row];
+	}
+
+	boolean settled () {
+		return true;
+	}
+
+private:
+	Matrix raw;
+};
+
+//! \brief Matrix scanner whose innards can be reached by the benchmark
+template <template <byte, byte, typename> class DEBOUNCER_T>
+class BenchScanner: public MatrixKeyboardScanner<ROWS, COLS, byte, DEBOUNCE_FACTOR_C16, KeyMapper<ROWS, COLS, byte>,
+                                                 OutputPort<ROWS>, InputPort<COLS, byte>, DEBOUNCER_T<ROWS, COLS, byte> > {
+public:
+	typedef typename BenchScanner::Matrix Matrix;
+
+	KeyboardScanner::ScanStatus step () {
+		return this->scanMatrix ();
+	}
+
+	const Matrix& getMatrix () const {
+		return this->matrix;
+	}
+};
+
+static void present (const Scan& s) {
+	hostSetMicros (s.us);
+	for (byte r = 0; r < ROWS; ++r) {
+		hostMatrix.setRow (r, s.rows[r]);
+	}
+}
+
+//! \brief Follows a key, comparing what the scanner shows with what the user did
+class KeyCheck {
+public:
+	KeyCheck (): truth (nullptr), next (0), detected (true) {
+	}
+
+	void begin (const std::vector<Transition>& t) {
+		truth = &t;
+		next = 0;
+		detected = true;
+	}
+
+	//! \brief The scanner shows the key as \a pressed since \a us
+	void edge (const unsigned long us, const boolean pressed, Result& res) {
+		advance (us, res);
+
+		const boolean wanted = next > 0 && (*truth)[next - 1].pressed;
+		if (pressed == wanted && !detected) {
+			const unsigned long latency = us - (*truth)[next - 1].us;
+			(pressed ? res.pressLatency : res.releaseLatency).push_back (latency);
+			detected = true;
+		} else if (pressed) {
+			++res.falseTriggers;
+		}
+	}
+
+	//! \brief Account for all transitions up to \a us
+	void advance (const unsigned long us, Result& res) {
+		while (next < truth->size () && (*truth)[next].us <= us) {
+			if (!detected && (*truth)[next - 1].pressed) {
+				++res.missed;
+			}
+			detected = false;
+			++next;
+		}
+	}
+
+private:
+	const std::vector<Transition> *truth;
+
+	//! \brief First transition still to come
+	size_t next;
+
+	//! \brief Whether the last transition showed up already
+	boolean detected;
+};
+
+template <template <byte, byte, typename> class DEBOUNCER_T>
+static void run (const Recording& rec, const byte length, Result& res) {
+	static BenchScanner<DEBOUNCER_T> scanner;
+
+	hostMatrix.clear ();
+	hostSetMicros (0);
+	scanner.setDebounce (length);
+	scanner.begin ();
+
+	static KeyCheck checks[ROWS][COLS];
+	for (byte r = 0; r < ROWS; ++r) {
+		for (byte c = 0; c < COLS; ++c) {
+			checks[r][c].begin (rec.truth[r][c]);
+		}
+	}
+
+	byte shown[ROWS];
+	memset (shown, 0xFF, sizeof (shown));
+	for (size_t i = 0; i < rec.scans.size (); ++i) {
+		const Scan& s = rec.scans[i];
+		present (s);
+		if (scanner.step () == KeyboardScanner::SCAN_COMPLETE) {
+			const typename BenchScanner<DEBOUNCER_T>::Matrix& mtx = scanner.getMatrix ();
+			for (byte r = 0; r < ROWS; ++r) {
+				const byte changed = mtx[r] ^ shown[r];
+				for (byte c = 0; changed >> c; ++c) {
+					if (changed & (1 << c)) {
+						checks[r][c].edge (s.us, !(mtx[r] & (1 << c)), res);
+					}
+				}
+				shown[r] = mtx[r];
+			}
+		}
+	}
+
+	const unsigned long end = rec.scans.empty () ? 0 : rec.scans.back ().us;
+	for (byte r = 0; r < ROWS; ++r) {
+		for (byte c = 0; c < COLS; ++c) {
+			checks[r][c].advance (end, res);
+		}
+	}
+
+	// Now time the debouncer alone, as fast as possible
+	typedef std::chrono::steady_clock Clock;
+	typedef DEBOUNCER_T<ROWS, COLS, byte> Debouncer;
+	static Debouncer debouncer;
+	typename Debouncer::Matrix initial;
+	memset (initial, 0xFF, sizeof (initial));
+	debouncer.begin (initial, length);
+
+	unsigned long n = 0;
+	byte sink = 0;
+	const Clock::time_point start = Clock::now ();
+	double elapsed;
+	do {
+		for (size_t i = 0; i < rec.scans.size (); ++i) {
+			for (byte r = 0; r < ROWS; ++r) {
+				sink ^= debouncer.update (r, rec.scans[i].rows[r]);
+			}
+			sink ^= debouncer.settled ();
+		}
+		n += rec.scans.size ();
+		elapsed = std::chrono::duration<double> (Clock::now () - start).count ();
+	} while (elapsed < BENCH_SECONDS && n > 0);
+
+	// Make sure nothing gets optimized away
+	res.nsPerScan = n > 0 ? elapsed * 1e9 / n + (sink & 0) : 0;
+}
+
+/******************************************************************************/
+
+//! \brief Latency percentile \a p, in ms
+static double percentile (const std::vector<unsigned long>& sorted, const double p) {
+	double ret = 0;
+	if (!sorted.empty ()) {
+		size_t i = static_cast<size_t> (p * sorted.size ());
+		if (i >= sorted.size ()) {
+			i = sorted.size () - 1;
+		}
+		ret = sorted[i] / 1000.0;
+	}
+
+	return ret;
+}
+
+template <template <byte, byte, typename> class DEBOUNCER_T>
+static void report (const char *name, const Recording& rec, const byte length) {
+	Result res;
+	res.missed = 0;
+	res.falseTriggers = 0;
+	run<DEBOUNCER_T> (rec, length, res);
+
+	std::sort (res.pressLatency.begin (), res.pressLatency.end ());
+	std::sort (res.releaseLatency.begin (), res.releaseLatency.end ());
+	printf ("%-11s %7.2f %7.2f %7.2f %7.2f  %7.2f %7.2f  %7lu %7lu %8.2f  %7.1f\n", name,
+	        percentile (res.pressLatency, 0.5), percentile (res.pressLatency, 0.9),
+	        percentile (res.pressLatency, 0.99), percentile (res.pressLatency, 1.0),
+	        percentile (res.releaseLatency, 0.5), percentile (res.releaseLatency, 0.99),
+	        res.missed, res.falseTriggers, rec.presses > 0 ? res.falseTriggers * 1000.0 / rec.presses : 0.0,
+	        res.nsPerScan);
+}
+
+static void reportAll (const Recording& rec, const byte length) {
+	printf ("%lu presses, %lu scans, debounce length %u\n", rec.presses,
+	        static_cast<unsigned long> (rec.scans.size ()), length);
+	printf ("            ---- press latency (ms) ----  - release (ms) -   missed   false   false/  ns/scan\n");
+	printf ("strategy        p50     p90     p99     max      p50     p99                      1000\n");
+	report<NullDebouncer> ("none", rec, length);
+	report<CounterDebouncer> ("counter", rec, length);
+	report<PerKeyDebouncer> ("perkey", rec, length);
+	report<EagerDebouncer> ("eager", rec, length);
+	report<IntegratorDebouncer> ("integrator", rec, length);
+	report<AdaptiveDebouncer> ("adaptive", rec, length);
+}
+
+/******************************************************************************/
+
+static void usage (const char *argv0) {
+	fprintf (stderr, "Usage: %s [-w WAVEFORM | -t TRACE] [-l LENGTH] [-p US] [-k KEYS]\n", argv0);
+	fprintf (stderr, "       %*s [-n PRESSES] [-b MIN,MAX] [-g RATE] [-r MS] [-s SEED]\n", static_cast<int> (strlen (argv0)), "");
+	fprintf (stderr, "Waveforms:");
+	for (byte i = 0; i < N_WAVEFORMS; ++i) {
+		fprintf (stderr, " %s", WAVEFORMS[i].name);
+	}
+	fprintf (stderr, "\n");
+	exit (2);
+}
+
+int main (int argc, char *argv[]) {
+	const char *waveName = nullptr;
+	const char *tracePath = nullptr;
+	unsigned long length = DEBOUNCE_FACTOR_C16;
+	unsigned long period = 300;
+	unsigned long nKeys = 4;
+	unsigned long presses = 250;
+	long bounceMin = -1;
+	long bounceMax = -1;
+	double glitchRate = -1;
+	unsigned long stableMs = 10;
+	uint32_t seed = 1;
+
+	int opt;
+	while ((opt = getopt (argc, argv, "w:t:l:p:k:n:b:g:r:s:")) != -1) {
+		switch (opt) {
+			case 'w':
+				waveName = optarg;
+				break;
+			case 't':
+				tracePath = optarg;
+				break;
+			case 'l':
+				length = strtoul (optarg, nullptr, 0);
+				break;
+			case 'p':
+				period = strtoul (optarg, nullptr, 0);
+				break;
+			case 'k':
+				nKeys = strtoul (optarg, nullptr, 0);
+				break;
+			case 'n':
+				presses = strtoul (optarg, nullptr, 0);
+				break;
+			case 'b':
+				if (sscanf (optarg, "%ld,%ld", &bounceMin, &bounceMax) != 2) {
+					usage (argv[0]);
+				}
+				break;
+			case 'g':
+				glitchRate = strtod (optarg, nullptr);
+				break;
+			case 'r':
+				stableMs = strtoul (optarg, nullptr, 0);
+				break;
+			case 's':
+				seed = strtoul (optarg, nullptr, 0);
+				break;
+			default:
+				usage (argv[0]);
+				break;
+		}
+	}
+
+	// xorshift gets stuck at 0
+	if (optind != argc || seed == 0 || (waveName && tracePath) || length == 0 || length > 0xFF || period == 0 ||
+	    nKeys == 0 || nKeys > ROWS * COLS || bounceMin > bounceMax) {
+		usage (argv[0]);
+	}
+
+	if (tracePath) {
+		std::vector<byte> trace;
+		if (!loadTrace (tracePath, trace)) {
+			fprintf (stderr, "Cannot read %s\n", tracePath);
+			return 2;
+		}
+
+		Recording rec;
+		rec.presses = 0;
+		const char *error = load (rec, trace, period);
+		if (error) {
+			fprintf (stderr, "Bad trace: %s\n", error);
+			return 2;
+		}
+		guessTruth (rec, stableMs * 1000UL);
+
+		printf ("Trace %s: ", tracePath);
+		reportAll (rec, length);
+	} else {
+		boolean found = false;
+		for (byte i = 0; i < N_WAVEFORMS; ++i) {
+			if (!waveName || strcmp (waveName, WAVEFORMS[i].name) == 0) {
+				Waveform wave = WAVEFORMS[i];
+				if (bounceMin >= 0) {
+					wave.bounceMin = bounceMin;
+					wave.bounceMax = bounceMax;
+				}
+				if (glitchRate >= 0) {
+					wave.glitchRate = glitchRate;
+				}
+
+				rng = seed;
+				Recording rec;
+				rec.presses = 0;
+				generate (rec, wave, nKeys, presses, period);
+
+				printf ("%sWaveform %s (bounces %lu-%lu us, %.2f glitches/s), %lu keys, scans every %lu us: ",
+				        found ? "\n" : "", wave.name, wave.bounceMin, wave.bounceMax, wave.glitchRate, nKeys, period);
+				reportAll (rec, length);
+				found = true;
+			}
+		}
+
+		if (!found) {
+			usage (argv[0]);
+		}
+	}
+
+	return 0;
+}
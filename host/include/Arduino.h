@@ -0,0 +1,195 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file Arduino.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Minimal Arduino core for host builds
+ *
+ * Only provides what the firmware sources built by the host library need. Time
+ * does not flow by itself: millis() and micros() return a simulated clock that
+ * is advanced by delay(), delayMicroseconds() and hostAdvanceMicros().
+ *
+ * AVR I/O registers are plain variables, so code touching them compiles and
+ * can be observed, but they have no side effects.
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t byte;
+typedef uint16_t word;
+typedef bool boolean;
+
+//! \name Program memory is just memory
+//! @{
+#define PROGMEM
+#define PSTR(s) (s)
+typedef const char *PGM_P;
+#define pgm_read_byte(p) (*reinterpret_cast<const uint8_t *> (p))
+#define pgm_read_word(p) (*reinterpret_cast<const uint16_t *> (p))
+#define pgm_read_dword(p) (*reinterpret_cast<const uint32_t *> (p))
+#define pgm_read_ptr(p) (*reinterpret_cast<const void * const *> (p))
+#define memcpy_P memcpy
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *> (s))
+//! @}
+
+//! \name Simulated time
+//! @{
+unsigned long millis ();
+unsigned long micros ();
+void delay (unsigned long ms);
+void delayMicroseconds (unsigned int us);
+
+//! \brief Move the simulated clock forward
+void hostAdvanceMicros (unsigned long us);
+
+//! \brief Set the simulated clock
+void hostSetMicros (unsigned long us);
+//! @}
+
+//! \name Interrupts are never preempted on the host
+//! @{
+#define ISR(vector) extern "C" void vector (void)
+#define noInterrupts()
+#define interrupts()
+#define cli()
+#define sei()
+//! @}
+
+//! \name AVR I/O registers
+//! @{
+extern volatile uint8_t DDRB, PORTB, PINB;
+extern volatile uint8_t DDRD, PORTD, PIND;
+extern volatile uint8_t DDRF, PORTF, PINF;
+extern volatile uint8_t PCMSK0, PCICR, PCIFR;
+
+#define PCINT0 0
+#define PCINT1 1
+#define PCINT2 2
+#define PCINT3 3
+#define PCINT4 4
+#define PCINT5 5
+#define PCINT6 6
+#define PCINT7 7
+#define PCIE0 0
+#define PCIF0 0
+#define _BV(b) (1 << (b))
+//! @}
+
+//! \name Digital I/O, no-ops
+//! @{
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+enum {A0 = 18, A1, A2, A3, A4, A5};
+
+inline void pinMode (uint8_t pin, uint8_t mode) {
+	(void) pin;
+	(void) mode;
+}
+
+inline void digitalWrite (uint8_t pin, uint8_t val) {
+	(void) pin;
+	(void) val;
+}
+
+inline int digitalRead (uint8_t pin) {
+	(void) pin;
+	return HIGH;
+}
+//! @}
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+//! \brief Output stream, all print() variants end up in write()
+class Print {
+public:
+	virtual ~Print () {}
+
+	virtual size_t write (uint8_t c) = 0;
+
+	virtual size_t write (const uint8_t *buf, size_t size);
+
+	virtual int availableForWrite () {
+		return 0;
+	}
+
+	size_t write (const char *str) {
+		return write (reinterpret_cast<const uint8_t *> (str), strlen (str));
+	}
+
+	size_t print (const __FlashStringHelper *s);
+	size_t print (const char *s);
+	size_t print (char c);
+	size_t print (int n, int base = DEC);
+	size_t print (unsigned int n, int base = DEC);
+	size_t print (long n, int base = DEC);
+	size_t print (unsigned long n, int base = DEC);
+	size_t print (double n, int digits = 2);
+
+private:
+	size_t printNumber (unsigned long n, int base);
+};
+
+class Stream: public Print {
+public:
+	virtual int available () = 0;
+	virtual int read () = 0;
+	virtual int peek () = 0;
+};
+
+//! \brief Serial port, output goes to stdout, there is never any input
+class Serial_: public Stream {
+public:
+	void begin (unsigned long baud) {
+		(void) baud;
+	}
+
+	operator bool () {
+		return true;
+	}
+
+	virtual int available () override {
+		return 0;
+	}
+
+	virtual int read () override {
+		return -1;
+	}
+
+	virtual int peek () override {
+		return -1;
+	}
+
+	virtual int availableForWrite () override {
+		return 64;
+	}
+
+	virtual size_t write (uint8_t c) override;
+
+	using Print::write;
+};
+
+extern Serial_ Serial;
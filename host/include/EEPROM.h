@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file EEPROM.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief EEPROM for host builds, backed by RAM
+ *
+ * Contents start out erased (all 0xFF), like a new chip.
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+class EEPROMClass {
+public:
+	//! \brief Same size as the ATmega32U4 EEPROM
+	static constexpr word SIZE = 1024;
+
+	//! \brief Raw contents, can be inspected or preloaded
+	byte data[SIZE];
+
+	//! \brief Number of bytes actually written so far
+	unsigned long writes;
+
+	EEPROMClass () {
+		erase ();
+	}
+
+	void erase () {
+		memset (data, 0xFF, sizeof (data));
+		writes = 0;
+	}
+
+	byte read (int idx) {
+		return data[idx % SIZE];
+	}
+
+	void write (int idx, byte val) {
+		data[idx % SIZE] = val;
+		++writes;
+	}
+
+	void update (int idx, byte val) {
+		if (read (idx) != val) {
+			write (idx, val);
+		}
+	}
+
+	word length () {
+		return SIZE;
+	}
+
+	template <typename T>
+	T& get (int idx, T& t) {
+		byte *p = reinterpret_cast<byte *> (&t);
+		for (size_t i = 0; i < sizeof (T); ++i) {
+			p[i] = read (idx + i);
+		}
+
+		return t;
+	}
+
+	template <typename T>
+	const T& put (int idx, const T& t) {
+		const byte *p = reinterpret_cast<const byte *> (&t);
+		for (size_t i = 0; i < sizeof (T); ++i) {
+			update (idx + i, p[i]);
+		}
+
+		return t;
+	}
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file HID-Project.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief HID-Project stub for host builds
+ *
+ * Provides the keycodes and a BootKeyboard that behaves like the real one
+ * (6-key rollover report, ASCII translation through a US layout), but keeps
+ * the report in memory instead of sending it over USB.
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+//! \brief USB HID keyboard usage IDs, same names as HID-Project
+enum KeyboardKeycode: uint8_t {
+	KEY_RESERVED = 0,
+	KEY_ERROR_ROLLOVER = 1,
+	KEY_POST_FAIL = 2,
+	KEY_ERROR_UNDEFINED = 3,
+	KEY_A = 4,
+	KEY_B, KEY_C, KEY_D, KEY_E, KEY_F, KEY_G, KEY_H, KEY_I, KEY_J, KEY_K, KEY_L, KEY_M,
+	KEY_N, KEY_O, KEY_P, KEY_Q, KEY_R, KEY_S, KEY_T, KEY_U, KEY_V, KEY_W, KEY_X, KEY_Y, KEY_Z,
+	KEY_1 = 30,
+	KEY_2, KEY_3, KEY_4, KEY_5, KEY_6, KEY_7, KEY_8, KEY_9, KEY_0,
+	KEY_ENTER = 40,
+	KEY_RETURN = 40,
+	KEY_ESC = 41,
+	KEY_BACKSPACE = 42,
+	KEY_TAB = 43,
+	KEY_SPACE = 44,
+	KEY_MINUS = 45,
+	KEY_EQUAL = 46,
+	KEY_LEFT_BRACE = 47,
+	KEY_RIGHT_BRACE = 48,
+	KEY_BACKSLASH = 49,
+	KEY_NON_US_NUM = 50,
+	KEY_SEMICOLON = 51,
+	KEY_QUOTE = 52,
+	KEY_TILDE = 53,
+	KEY_COMMA = 54,
+	KEY_PERIOD = 55,
+	KEY_SLASH = 56,
+	KEY_CAPS_LOCK = 57,
+	KEY_F1 = 58,
+	KEY_F2, KEY_F3, KEY_F4, KEY_F5, KEY_F6, KEY_F7, KEY_F8, KEY_F9, KEY_F10, KEY_F11, KEY_F12,
+	KEY_PRINT = 70,
+	KEY_PRINTSCREEN = 70,
+	KEY_SCROLL_LOCK = 71,
+	KEY_PAUSE = 72,
+	KEY_INSERT = 73,
+	KEY_HOME = 74,
+	KEY_PAGE_UP = 75,
+	KEY_DELETE = 76,
+	KEY_END = 77,
+	KEY_PAGE_DOWN = 78,
+	KEY_RIGHT_ARROW = 79,
+	KEY_LEFT_ARROW = 80,
+	KEY_DOWN_ARROW = 81,
+	KEY_UP_ARROW = 82,
+	KEY_RIGHT = 79,
+	KEY_LEFT = 80,
+	KEY_DOWN = 81,
+	KEY_UP = 82,
+	KEY_NUM_LOCK = 83,
+	KEYPAD_DIVIDE = 84,
+	KEYPAD_MULTIPLY = 85,
+	KEYPAD_SUBTRACT = 86,
+	KEYPAD_ADD = 87,
+	KEYPAD_ENTER = 88,
+	KEYPAD_1 = 89,
+	KEYPAD_2, KEYPAD_3, KEYPAD_4, KEYPAD_5, KEYPAD_6, KEYPAD_7, KEYPAD_8, KEYPAD_9, KEYPAD_0,
+	KEYPAD_DOT = 99,
+	KEY_NON_US = 100,
+	KEY_APPLICATION = 101,
+	KEY_MENU = 101,
+	KEY_F13 = 104,
+	KEY_F14, KEY_F15, KEY_F16, KEY_F17, KEY_F18, KEY_F19, KEY_F20, KEY_F21, KEY_F22, KEY_F23, KEY_F24,
+
+	KEY_LEFT_CTRL = 0xE0,
+	KEY_LEFT_SHIFT = 0xE1,
+	KEY_LEFT_ALT = 0xE2,
+	KEY_LEFT_GUI = 0xE3,
+	KEY_RIGHT_CTRL = 0xE4,
+	KEY_RIGHT_SHIFT = 0xE5,
+	KEY_RIGHT_ALT = 0xE6,
+	KEY_RIGHT_GUI = 0xE7
+};
+
+//! \brief Modifiers in the high byte of #_asciimap entries
+enum KeyboardMods: uint16_t {
+	MOD_LEFT_CTRL = (1 << 8),
+	MOD_LEFT_SHIFT = (1 << 9),
+	MOD_LEFT_ALT = (1 << 10),
+	MOD_LEFT_GUI = (1 << 11),
+	MOD_RIGHT_CTRL = (1 << 12),
+	MOD_RIGHT_SHIFT = (1 << 13),
+	MOD_RIGHT_ALT = (1 << 14),
+	MOD_RIGHT_GUI = static_cast<uint16_t> (1 << 15)
+};
+
+//! \brief ASCII to keycode (plus modifiers) translation table, US layout
+extern const uint16_t _asciimap[128];
+
+//! \brief Boot keyboard report
+struct HID_BootKeyboardReport {
+	uint8_t modifiers;
+	uint8_t reserved;
+	uint8_t keycodes[6];
+};
+
+class BootKeyboard_ {
+public:
+	//! \brief Called with every report sent
+	typedef void (*SendCallback) (const HID_BootKeyboardReport& report);
+
+	//! \brief Report being built, sent by send()
+	HID_BootKeyboardReport report;
+
+	//! \brief Number of reports sent so far
+	unsigned long sends;
+
+	//! \brief Led status, as the host would set it
+	uint8_t leds;
+
+	SendCallback onSend;
+
+	BootKeyboard_ ();
+
+	void begin ();
+
+	size_t add (KeyboardKeycode k);
+
+	size_t add (uint8_t c);
+
+	size_t remove (KeyboardKeycode k);
+
+	size_t remove (uint8_t c);
+
+	size_t releaseAll ();
+
+	int send ();
+
+	uint8_t getLeds () {
+		return leds;
+	}
+
+	uint8_t getProtocol () {
+		return 1;
+	}
+};
+
+extern BootKeyboard_ BootKeyboard;
@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file HostMatrix.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Simulated keyboard matrix for host builds
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+/** \brief Simulated keyboard matrix
+ *
+ * Stands in for the physical keyboard: keys are pressed and released by the
+ * program driving the simulation, while the scanners see them through the
+ * host ports (active scanner) or through simulated TED polls (passive
+ * scanner).
+ *
+ * Like on the real thing, a column reads low when any of the rows being driven
+ * low has a key pressed on it.
+ */
+class HostMatrix {
+public:
+	static constexpr byte ROWS = 8;
+
+	//! \brief Release all keys
+	void clear () {
+		memset (keys, 0x00, sizeof (keys));
+		restore = false;
+	}
+
+	void press (const byte row, const byte col) {
+		keys[row] |= 1 << col;
+	}
+
+	void release (const byte row, const byte col) {
+		keys[row] &= ~(1 << col);
+	}
+
+	boolean isPressed (const byte row, const byte col) const {
+		return keys[row] & (1 << col);
+	}
+
+	//! \brief Press and release keys so that \a row reads as \a cols when driven
+	void setRow (const byte row, const byte cols) {
+		keys[row] = ~cols;
+	}
+
+	//! \brief Press or release RESTORE, which is outside the matrix
+	void setRestore (const boolean pressed) {
+		restore = pressed;
+	}
+
+	boolean isRestorePressed () const {
+		return restore;
+	}
+
+	//! \brief Set which rows are driven low, one bit per row
+	void drive (const byte rows) {
+		driven = rows;
+	}
+
+	//! \brief Read the columns, given the rows being driven low
+	byte read () const {
+		return columns (driven);
+	}
+
+	//! \brief Columns as seen when \a rows are driven low
+	byte columns (const byte rows) const;
+
+	/** \brief Simulate the C16/Plus4 KERNAL polling the keyboard
+	 *
+	 * Rows and columns are presented on PINB and PIND and the pin-change
+	 * interrupt is invoked for every step of the poll, just as KbdScannerPassive16
+	 * would see them.
+	 */
+	void tedPoll ();
+
+private:
+	//! \brief One bit per pressed key
+	byte keys[ROWS] = {0};
+
+	byte driven = 0;
+
+	boolean restore = false;
+};
+
+extern HostMatrix hostMatrix;
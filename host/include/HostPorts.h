@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file HostPorts.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Matrix scanning ports for host builds
+ *
+ * Included by PinPorts.h in place of the AVR port templates.
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include "HostMatrix.h"
+
+/** \brief Output port made of the listed pins, drives the rows of #hostMatrix
+ *
+ * Pins do not matter here, line N is just row N of the simulated matrix.
+ */
+template <typename... PINS>
+class OutputPins {
+	static_assert (sizeof... (PINS) <= 8, "Simulated matrix has 8 rows");
+
+public:
+	void begin () {
+		clearAllBits ();
+	}
+
+	void setBit (byte n) {
+		hostMatrix.drive (1 << n);
+	}
+
+	void clearAllBits () {
+		hostMatrix.drive (0x00);
+	}
+};
+
+//! \brief Input port made of the listed pins, reads the columns of #hostMatrix
+template <typename TYPE, typename... PINS>
+class InputPins {
+	static_assert (sizeof... (PINS) <= 8, "Simulated matrix has 8 columns");
+
+public:
+	void begin () {
+	}
+
+	TYPE read () {
+		// Missing columns read as released, like on the real thing
+		return hostMatrix.read () | static_cast<TYPE> (~((1U << sizeof... (PINS)) - 1));
+	}
+
+	void driveLow () {
+		// Nobody sleeps on the host
+	}
+};
+
+//! \brief RESTORE line, reads the RESTORE key of #hostMatrix
+class RestorePort {
+public:
+	void begin () {
+	}
+
+	boolean read () {
+		return hostMatrix.isRestorePressed ();
+	}
+};
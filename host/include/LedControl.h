@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file LedControl.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief LedControl stub for host builds
+ *
+ * Keeps the state of the (single) MAX72xx in memory, so that it can be
+ * inspected, and counts how many times it was updated.
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+class LedControl {
+public:
+	//! \brief One byte per row, as written to the chip
+	byte status[8];
+
+	boolean isShutdown;
+
+	byte intensity;
+
+	//! \brief Number of register writes, each one is an SPI transfer on the real thing
+	unsigned long transfers;
+
+	LedControl (int dataPin, int clkPin, int csPin, int numDevices = 1) {
+		(void) dataPin;
+		(void) clkPin;
+		(void) csPin;
+		(void) numDevices;
+
+		memset (status, 0x00, sizeof (status));
+		isShutdown = true;
+		intensity = 0;
+		transfers = 0;
+	}
+
+	int getDeviceCount () {
+		return 1;
+	}
+
+	void shutdown (int addr, bool status) {
+		(void) addr;
+		isShutdown = status;
+		++transfers;
+	}
+
+	void setScanLimit (int addr, int limit) {
+		(void) addr;
+		(void) limit;
+		++transfers;
+	}
+
+	void setIntensity (int addr, int value) {
+		(void) addr;
+		intensity = value;
+		++transfers;
+	}
+
+	void clearDisplay (int addr) {
+		(void) addr;
+		memset (status, 0x00, sizeof (status));
+		transfers += 8;
+	}
+
+	void setLed (int addr, int row, int col, boolean state) {
+		(void) addr;
+		const byte mask = 0x80 >> col;
+		if (state) {
+			status[row] |= mask;
+		} else {
+			status[row] &= ~mask;
+		}
+		++transfers;
+	}
+
+	void setRow (int addr, int row, byte value) {
+		(void) addr;
+		status[row] = value;
+		++transfers;
+	}
+
+	void setColumn (int addr, int col, byte value) {
+		(void) addr;
+		for (byte row = 0; row < 8; ++row) {
+			setLed (addr, row, col, (value >> (7 - row)) & 0x01);
+		}
+	}
+};
@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file TraceReader.h
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Parsing of matrix traces, see MatrixTrace.h
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <vector>
+
+#include "MatrixTrace.h"
+
+//! \brief Walks through the records of a trace
+class TraceReader {
+public:
+	explicit TraceReader (const std::vector<byte>& t): data (t), pos (0), error (nullptr) {
+	}
+
+	boolean atEnd () const {
+		return pos >= data.size ();
+	}
+
+	const char *getError () const {
+		return error;
+	}
+
+	size_t getPos () const {
+		return pos;
+	}
+
+	byte next () {
+		byte b = 0;
+		if (atEnd ()) {
+			fail ("truncated record");
+		} else {
+			b = data[pos++];
+		}
+
+		return b;
+	}
+
+	unsigned long varint () {
+		unsigned long v = 0;
+		byte b;
+		byte shift = 0;
+		do {
+			b = next ();
+			v |= static_cast<unsigned long> (b & 0x7F) << shift;
+			shift += 7;
+		} while ((b & 0x80) && !error);
+
+		return v;
+	}
+
+	//! \brief Read a record header, return its type and put its argument in \a arg
+	TraceRecord header (unsigned long& arg) {
+		const byte h = next ();
+		arg = h & TRACE_ARG_VARINT;
+		if (arg == TRACE_ARG_VARINT) {
+			arg = varint ();
+		}
+
+		return static_cast<TraceRecord> (h >> 5);
+	}
+
+	void fail (const char *what) {
+		if (!error) {
+			error = what;
+		}
+	}
+
+private:
+	const std::vector<byte>& data;
+
+	size_t pos;
+
+	const char *error;
+};
+
+//! \brief Read a whole file into \a data, return false if it cannot be read
+inline boolean loadTrace (const char *path, std::vector<byte>& data) {
+	FILE *f = fopen (path, "rb");
+	if (f) {
+		int c;
+		while ((c = fgetc (f)) != EOF) {
+			data.push_back (c);
+		}
+		fclose (f);
+	}
+
+	return f != nullptr;
+}
@@ -0,0 +1,388 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file mapfuzz.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Randomized checker and benchmark for KeyMapperC16 and KeyboardHandler
+ *
+ * Random sequences of matrices are fed through the mapper and the keyboard
+ * handler, just like the scanner does after debouncing. Sequences include
+ * SHIFT going up and down while other keys are held, more keys held than fit
+ * in a #KeyBuffer and regular releases of all keys. After every matrix the
+ * following must hold:
+ * - The mapper never puts more than #KEYBUF_SIZE keys in the buffer, and no
+ *   more than that many keys are being reported.
+ * - A key is only reported as pressed when it is not pressed already, and
+ *   only reported as released when it is pressed, so that every press gets a
+ *   matching release.
+ * - Once all keys are released, no key is pressed, either according to the
+ *   handler or in the HID report. With #ENABLE_TAP_HOLD, taps and held back
+ *   keys are still reported for a couple of matrices after that.
+ *
+ * The first failure is printed along with the last matrices that led to it and
+ * the program exits with an error. The same seed always produces the same
+ * sequence.
+ *
+ * Finally, the speed of the mapper alone and of the mapper and handler
+ * together is measured, in matrices per second.
+ *
+ * Usage: mapfuzz [-p] [-n STEPS] [-s SEED]
+ *   -p  Use positional mapping (default: symbolic)
+ *   -n  Number of matrices to check (default: 1000000)
+ *   -s  Seed for the random sequence (default: 1)
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+
+#include "KbdScannerC16.h"
+#include "KeyboardHandler.h"
+#include "UsbKeyboard.h"
+
+typedef KeyMapperC16::Matrix Matrix;
+
+static const byte ROWS = C16_MATRIX_ROWS;
+static const byte COLS = C16_MATRIX_COLS;
+
+//! \brief Where SHIFT is in the C16 matrix
+static const byte SHIFT_ROW = 1;
+static const byte SHIFT_COL = 7;
+
+//! \brief How many matrices to show when something goes wrong
+static const byte HISTORY_LEN = 16;
+
+/** \brief Matrices with all keys released after which nothing must be reported
+ *
+ * With #ENABLE_TAP_HOLD, a tap is reported when its key is released and keys
+ * held back behind it one matrix later, so they are released one matrix after
+ * that.
+ */
+#ifdef ENABLE_TAP_HOLD
+static const byte SETTLE_STEPS = 3;
+#else
+static const byte SETTLE_STEPS = 1;
+#endif
+
+//! \brief Number of different matrices used for benchmarking
+static const unsigned int BENCH_MATRICES = 4096;
+
+static const double BENCH_SECONDS = 1.0;
+
+/******************************************************************************/
+
+static KeyMapperC16 mapper;
+
+static UsbKeyboard usbKeyboard;
+
+static KeyboardHandler<ROWS, COLS> handler;
+
+//! \brief Keys the handler reported as pressed, one bit per matrix position
+static byte down[ROWS];
+
+static unsigned long step;
+
+//! \brief Consecutive matrices with all keys released
+static byte releasedSteps;
+
+static const char *failure;
+
+//! \brief Last matrices, for failure reports
+static Matrix history[HISTORY_LEN];
+
+/******************************************************************************/
+
+//! \brief Small, fast and, above all, the same everywhere
+static uint32_t rng;
+
+static uint32_t rnd () {
+	rng ^= rng << 13;
+	rng ^= rng >> 17;
+	rng ^= rng << 5;
+	return rng;
+}
+
+static byte rnd (const byte n) {
+	return rnd () % n;
+}
+
+static void fail (const char *what) {
+	if (!failure) {
+		failure = what;
+	}
+}
+
+static byte popcount (const byte b) {
+	return __builtin_popcount (b);
+}
+
+static byte heldKeys (const Matrix& mtx) {
+	byte n = 0;
+	for (byte r = 0; r < ROWS; ++r) {
+		n += popcount (~mtx[r]);
+	}
+
+	return n;
+}
+
+static void onKeyPressed (const byte row, const byte col) {
+	if (down[row] & (1 << col)) {
+		fail ("key pressed twice without being released");
+	}
+	down[row] |= 1 << col;
+}
+
+static void onKeyReleased (const byte row, const byte col) {
+	if (!(down[row] & (1 << col))) {
+		fail ("key released without being pressed");
+	}
+	down[row] &= ~(1 << col);
+}
+
+/******************************************************************************/
+
+static void check (const Matrix& mtx, const KeyBuffer& kbuf) {
+	if (kbuf.size > KEYBUF_SIZE) {
+		fail ("too many keys in the key buffer");
+	}
+
+	const byte nTracked = handler.getPressed ().count ();
+	byte nDown = 0, nReported = 0;
+	for (byte r = 0; r < ROWS; ++r) {
+		nDown += popcount (down[r]);
+	}
+	for (byte i = 0; i < sizeof (BootKeyboard.report.keycodes); ++i) {
+		if (BootKeyboard.report.keycodes[i] != KEY_RESERVED) {
+			++nReported;
+		}
+	}
+
+	if (nDown > KEYBUF_SIZE || nTracked > KEYBUF_SIZE) {
+		fail ("more than KEYBUF_SIZE keys pressed");
+	}
+
+	if (heldKeys (mtx) > 0) {
+		releasedSteps = 0;
+	} else if (releasedSteps < SETTLE_STEPS) {
+		++releasedSteps;
+	}
+
+	if (releasedSteps >= SETTLE_STEPS) {
+		if (nDown > 0) {
+			fail ("press without a matching release");
+		} else if (nTracked > 0) {
+			fail ("key stuck in the handler after releasing all keys");
+		} else if (nReported > 0 || BootKeyboard.report.modifiers != 0) {
+			fail ("key stuck in the HID report after releasing all keys");
+		}
+	}
+}
+
+static void dump (const Matrix& mtx) {
+	for (byte r = 0; r < ROWS; ++r) {
+		const byte held = ~mtx[r];
+		for (byte c = 0; c < COLS; ++c) {
+			if (held & (1 << c)) {
+				printf (" %u,%u", r, c);
+			}
+		}
+	}
+	printf ("\n");
+}
+
+static void report (const uint32_t seed) {
+	printf ("FAILED at step %lu (seed %u): %s\n", step, seed, failure);
+	printf ("Last matrices (held keys as ROW,COL):\n");
+	const unsigned long first = step + 1 > HISTORY_LEN ? step + 1 - HISTORY_LEN : 0;
+	for (unsigned long i = first; i <= step; ++i) {
+		printf ("  %8lu:", i);
+		dump (history[i % HISTORY_LEN]);
+	}
+
+	printf ("HID report: modifiers 0x%02X, keys", BootKeyboard.report.modifiers);
+	for (byte i = 0; i < sizeof (BootKeyboard.report.keycodes); ++i) {
+		printf (" 0x%02X", BootKeyboard.report.keycodes[i]);
+	}
+	printf ("\n");
+}
+
+/******************************************************************************/
+
+static void pressRandom (Matrix& mtx) {
+	const byte r = rnd (ROWS);
+	mtx[r] &= ~(1 << rnd (COLS));
+}
+
+//! \brief Next matrix of the sequence, mostly small changes to the current one
+static void mutate (Matrix& mtx) {
+	const byte what = rnd (100);
+
+	if (what < 5) {
+		// Release everything
+		memset (mtx, 0xFF, sizeof (Matrix));
+	} else if (what < 20) {
+		// SHIFT goes up or down while other keys are held
+		mtx[SHIFT_ROW] ^= 1 << SHIFT_COL;
+	} else if (what < 25) {
+		// Way more keys than fit in the buffer
+		for (byte i = rnd (8); i < 12; ++i) {
+			pressRandom (mtx);
+		}
+	} else {
+		// Toggle a key or two, favoring releases when many keys are held
+		for (byte i = rnd (2); i < 2; ++i) {
+			const byte r = rnd (ROWS);
+			const byte c = rnd (COLS);
+			if (heldKeys (mtx) < 4 || (mtx[r] & (1 << c)) == 0) {
+				mtx[r] ^= 1 << c;
+			}
+		}
+	}
+}
+
+static void begin (const boolean positional) {
+	Matrix released;
+	memset (released, 0xFF, sizeof (released));
+
+	mapper.setMode (positional ? KEYMAP_POSITIONAL : KEYMAP_SYMBOLIC);
+	mapper.begin (released);
+	BootKeyboard.begin ();
+	handler.begin (usbKeyboard, onKeyPressed, onKeyReleased);
+	memset (down, 0x00, sizeof (down));
+}
+
+static boolean fuzz (const unsigned long steps, const uint32_t seed) {
+	Matrix mtx;
+	memset (mtx, 0xFF, sizeof (mtx));
+	KeyBuffer kbuf;
+
+	rng = seed;
+	for (step = 0; step < steps && !failure; ++step) {
+		mutate (mtx);
+		memcpy (history[step % HISTORY_LEN], mtx, sizeof (Matrix));
+
+		kbuf.begin ();
+		mapper.map (mtx, kbuf);
+		handler.handle (kbuf);
+		check (mtx, kbuf);
+
+		// Timing matters to dual-role keys
+		delay (KEYBOARD_SCAN_INTERVAL_MS);
+	}
+
+	if (failure) {
+		--step;
+		report (seed);
+	}
+
+	return !failure;
+}
+
+/******************************************************************************/
+
+static Matrix benchMatrices[BENCH_MATRICES];
+
+//! \brief Runs \a body on the benchmark matrices for a while, returns matrices/s
+template <typename F>
+static double measure (F body) {
+	typedef std::chrono::steady_clock Clock;
+
+	unsigned long n = 0;
+	const Clock::time_point start = Clock::now ();
+	double elapsed;
+	do {
+		for (unsigned int i = 0; i < BENCH_MATRICES; ++i) {
+			body (benchMatrices[i]);
+		}
+		n += BENCH_MATRICES;
+		elapsed = std::chrono::duration<double> (Clock::now () - start).count ();
+	} while (elapsed < BENCH_SECONDS);
+
+	return n / elapsed;
+}
+
+static void bench () {
+	// Same kind of matrices the fuzzer uses, in the same proportions
+	Matrix mtx;
+	memset (mtx, 0xFF, sizeof (mtx));
+	for (unsigned int i = 0; i < BENCH_MATRICES; ++i) {
+		mutate (mtx);
+		memcpy (benchMatrices[i], mtx, sizeof (Matrix));
+	}
+
+	KeyBuffer kbuf;
+	unsigned long keys = 0;
+	const double mapRate = measure ([&] (const Matrix& m) {
+		kbuf.begin ();
+		keys += mapper.map (m, kbuf);
+	});
+
+	const double handleRate = measure ([&] (const Matrix& m) {
+		kbuf.begin ();
+		keys += mapper.map (m, kbuf);
+		handler.handle (kbuf);
+	});
+
+	printf ("map:          %12.0f matrices/s\n", mapRate);
+	printf ("map + handle: %12.0f matrices/s\n", handleRate);
+	if (keys == 0) {
+		// Make sure nothing gets optimized away
+		printf ("No keys were mapped\n");
+	}
+}
+
+/******************************************************************************/
+
+static void usage (const char *argv0) {
+	fprintf (stderr, "Usage: %s [-p] [-n STEPS] [-s SEED]\n", argv0);
+	exit (2);
+}
+
+int main (int argc, char *argv[]) {
+	boolean positional = false;
+	unsigned long steps = 1000000;
+	uint32_t seed = 1;
+
+	int opt;
+	while ((opt = getopt (argc, argv, "pn:s:")) != -1) {
+		switch (opt) {
+			case 'p':
+				positional = true;
+				break;
+			case 'n':
+				steps = strtoul (optarg, nullptr, 0);
+				break;
+			case 's':
+				seed = strtoul (optarg, nullptr, 0);
+				break;
+			default:
+				usage (argv[0]);
+				break;
+		}
+	}
+
+	if (optind != argc || seed == 0) {
+		// xorshift gets stuck at 0
+		usage (argv[0]);
+	}
+
+	begin (positional);
+	if (!fuzz (steps, seed)) {
+		return 1;
+	}
+	printf ("%lu matrices checked, %lu reports sent\n", steps, BootKeyboard.sends);
+
+	begin (positional);
+	bench ();
+
+	return 0;
+}
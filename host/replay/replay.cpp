@@ -0,0 +1,416 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file replay.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Replays matrix traces and checks the USB reports they produce
+ *
+ * Traces recorded by a firmware built with #ENABLE_MATRIX_TRACE (see
+ * MatrixTrace.h and the "trace" command of tools/mechctl.py) are fed to the
+ * same scanner that recorded them: rows are presented through the simulated
+ * matrix, passive scanner samples through its pin-change ISR, and scan() is
+ * called at the recorded times, with the result going through the keyboard
+ * handler just like in the sketch's loop(). The handler must be built with the
+ * same options as the firmware, or results will differ.
+ *
+ * Every USB report sent is added to a timeline, one line per report: time
+ * since the start of the trace (ms), modifiers and the six keycodes, in hex.
+ * The timeline is printed, written to a file with -w, or compared with a
+ * golden one with -g, in which case the first difference is shown and the
+ * program exits with an error.
+ *
+ * Goldens start with a line listing the options the handler was built with
+ * that change the reports (debouncer, key layers, tap/hold...). Goldens made
+ * with other options are not compared and the program exits with code 77,
+ * which ctest takes as a skipped test.
+ *
+ * With -b, the trace is also replayed over and over for a while, to measure
+ * how many scans per second the scanner, mapper and handler can go through.
+ *
+ * The traces in traces/ were made by scanning random presses and bounces of
+ * the simulated matrix, with the default options, and are replayed by ctest.
+ *
+ * Usage: replay [-b] [-g GOLDEN | -w GOLDEN] TRACE
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "KbdScannerC16.h"
+#include "KbdScannerC64.h"
+#include "KbdScannerVic20.h"
+#include "KbdScannerPassive16.h"
+#include "KeyboardHandler.h"
+#include "UsbKeyboard.h"
+#include "MatrixTrace.h"
+#include <HostMatrix.h>
+#include <TraceReader.h>
+
+// Pin-change ISR of the passive scanner
+extern "C" void PCINT0_vect (void);
+
+static const double BENCH_SECONDS = 1.0;
+
+//! \brief Exit code for goldens made with different options, see checkGolden()
+static const int EXIT_SKIPPED = 77;
+
+/* Options that change the reports a trace produces, these are written at the
+ * top of goldens
+ */
+static const char OPTIONS[] = "# options: DEBOUNCER=" STR (DEBOUNCER)
+#ifdef ENABLE_ADAPTIVE_DEBOUNCE
+	" ADAPTIVE_DEBOUNCE_MIN=" STR (ADAPTIVE_DEBOUNCE_MIN)
+	" ADAPTIVE_DEBOUNCE_MARGIN=" STR (ADAPTIVE_DEBOUNCE_MARGIN)
+#endif
+#ifdef PEDANTIC_PRESS_RELEASE_CHECKS
+	" PEDANTIC_PRESS_RELEASE_CHECKS"
+#endif
+#ifdef ENABLE_EURO_KEY
+	" ENABLE_EURO_KEY"
+#endif
+#ifdef ENABLE_KEY_LAYERS
+	" ENABLE_KEY_LAYERS"
+#endif
+#ifdef ENABLE_TAP_HOLD
+	" ENABLE_TAP_HOLD TAP_HOLD_TERM_MS=" STR (TAP_HOLD_TERM_MS)
+#endif
+	;
+
+/******************************************************************************/
+
+static KbdScannerC16 scannerC16;
+
+static KbdScannerC64 scannerC64;
+
+static KbdScannerVic20 scannerVic20;
+
+static KbdScannerPassive16 scannerPassive;
+
+static UsbKeyboard usbKeyboard;
+
+static KeyboardHandler<C16_MATRIX_ROWS, C16_MATRIX_COLS> handler;
+
+static std::vector<byte> trace;
+
+static std::vector<std::string> timeline;
+
+//! \brief Time of the current tick, since the start of the trace
+static unsigned long traceMillis;
+
+static unsigned long scans;
+
+/******************************************************************************/
+
+static void onKeyPressed (const byte row, const byte col) {
+	(void) row;
+	(void) col;
+}
+
+static void onKeyReleased (const byte row, const byte col) {
+	(void) row;
+	(void) col;
+}
+
+static void onSend (const HID_BootKeyboardReport& report) {
+	char line[64];
+	snprintf (line, sizeof (line), "%8lu  %02X  %02X %02X %02X %02X %02X %02X", traceMillis, report.modifiers,
+	          report.keycodes[0], report.keycodes[1], report.keycodes[2],
+	          report.keycodes[3], report.keycodes[4], report.keycodes[5]);
+	timeline.push_back (line);
+}
+
+//! \brief Do what the sketch's loop() does when the scan interval is over
+template <typename S>
+static void tick (S& scanner) {
+	hostSetMicros (traceMillis * 1000UL);
+
+	KeyBuffer kBuf;
+	kBuf.begin ();
+	if (scanner.scan (kBuf) == KeyboardScanner::SCAN_COMPLETE) {
+		++handler.counters.scans;
+		handler.handle (kBuf);
+	}
+}
+
+/** \brief Replay the trace through \a scanner
+ *
+ * \param[in] passive True if \a scanner is the passive one
+ * \return The error found in the trace, or nullptr
+ */
+template <typename S>
+static const char *replay (S& scanner, const boolean passive) {
+	TraceReader r (trace);
+	unsigned long arg;
+	r.header (arg);
+	const KeyMapMode mode = static_cast<KeyMapMode> (r.next ());
+	const byte debounce = r.next ();
+
+	// Same order as in setup()
+	hostMatrix.clear ();
+	hostSetMicros (0);
+	traceMillis = 0;
+	scans = 0;
+	timeline.clear ();
+	BootKeyboard.begin ();
+	BootKeyboard.onSend = onSend;
+	scanner.setKeyMapMode (mode);
+	scanner.setDebounce (debounce);
+	handler.begin (usbKeyboard, onKeyPressed, onKeyReleased);
+	scanner.begin ();
+
+	while (!r.atEnd () && !r.getError ()) {
+		switch (r.header (arg)) {
+			case TRACE_ROW: {
+				const byte cols = r.next ();
+				if (passive || arg >= HostMatrix::ROWS) {
+					r.fail ("bad row record");
+				} else {
+					hostMatrix.setRow (arg, cols);
+				}
+				break;
+			}
+			case TRACE_SCANS:
+				for (unsigned long i = 0; i < arg; ++i) {
+					scanner.loop ();
+				}
+				scans += arg;
+				break;
+			case TRACE_SAMPLE:
+				PINB = r.next ();
+				PIND = r.next ();
+				if (!passive) {
+					r.fail ("sample record in a matrix scanner trace");
+				} else {
+					PCINT0_vect ();
+					scanner.loop ();
+				}
+				break;
+			case TRACE_TICK: {
+				traceMillis += arg;
+
+				// The last scan was done by scan()
+				const unsigned long n = r.varint ();
+				for (unsigned long i = 1; i < n; ++i) {
+					scanner.loop ();
+				}
+				tick (scanner);
+				scans += n;
+				break;
+			}
+			case TRACE_MODE:
+				scanner.setKeyMapMode (static_cast<KeyMapMode> (arg));
+				break;
+			case TRACE_DEBOUNCE:
+				scanner.setDebounce (arg);
+				break;
+			case TRACE_RESTORE:
+				hostMatrix.setRestore (arg);
+				break;
+			default:
+				r.fail ("unexpected record");
+				break;
+		}
+	}
+
+	if (r.getError ()) {
+		fprintf (stderr, "Bad trace at offset %lu: %s\n", static_cast<unsigned long> (r.getPos ()), r.getError ());
+	}
+
+	return r.getError ();
+}
+
+static const char *replay (const TraceSource src) {
+	const char *ret = nullptr;
+
+	switch (src) {
+		case TRACESRC_C16:
+			ret = replay (scannerC16, false);
+			break;
+		case TRACESRC_C64:
+			ret = replay (scannerC64, false);
+			break;
+		case TRACESRC_VIC20:
+			ret = replay (scannerVic20, false);
+			break;
+		case TRACESRC_PASSIVE16:
+			ret = replay (scannerPassive, true);
+			break;
+		default:
+			ret = "unknown scanner";
+			fprintf (stderr, "Trace recorded from an unknown scanner (%d)\n", src);
+			break;
+	}
+
+	return ret;
+}
+
+/******************************************************************************/
+
+static boolean writeGolden (const char *path) {
+	FILE *f = fopen (path, "w");
+	if (f) {
+		fprintf (f, "%s\n", OPTIONS);
+		for (size_t i = 0; i < timeline.size (); ++i) {
+			fprintf (f, "%s\n", timeline[i].c_str ());
+		}
+		fclose (f);
+	}
+
+	return f != nullptr;
+}
+
+/** \brief Compare the timeline with the golden one
+ *
+ * Goldens made with different #OPTIONS are not compared, as reports are
+ * expected to differ.
+ *
+ * \return 0 if they match, 1 if they do not, #EXIT_SKIPPED if the options
+ *         differ, 2 on errors
+ */
+static int checkGolden (const char *path) {
+	FILE *f = fopen (path, "r");
+	if (!f) {
+		fprintf (stderr, "Cannot open %s\n", path);
+		return 2;
+	}
+
+	std::string options;
+	std::vector<std::string> golden;
+	char line[256];
+	while (fgets (line, sizeof (line), f)) {
+		line[strcspn (line, "\r\n")] = '\0';
+		if (line[0] == '#') {
+			options = line;
+		} else {
+			golden.push_back (line);
+		}
+	}
+	fclose (f);
+
+	if (options != OPTIONS) {
+		printf ("Golden made with different options, not compared\n");
+		printf ("  golden: %s\n", options.empty () ? "(none)" : options.c_str ());
+		printf ("  build:  %s\n", OPTIONS);
+		return EXIT_SKIPPED;
+	}
+
+	int ret = 0;
+	for (size_t i = 0; ret == 0 && i < golden.size () && i < timeline.size (); ++i) {
+		if (golden[i] != timeline[i]) {
+			printf ("Report %lu differs:\n", static_cast<unsigned long> (i));
+			printf ("  expected: %s\n", golden[i].c_str ());
+			printf ("  got:      %s\n", timeline[i].c_str ());
+			ret = 1;
+		}
+	}
+
+	if (ret == 0 && golden.size () != timeline.size ()) {
+		printf ("Expected %lu reports, got %lu\n", static_cast<unsigned long> (golden.size ()),
+		        static_cast<unsigned long> (timeline.size ()));
+		ret = 1;
+	}
+
+	return ret;
+}
+
+//! \brief Replay the trace for a while, return scans/s
+static double bench (const TraceSource src) {
+	typedef std::chrono::steady_clock Clock;
+
+	unsigned long n = 0;
+	const Clock::time_point start = Clock::now ();
+	double elapsed;
+	do {
+		replay (src);
+		n += scans;
+		elapsed = std::chrono::duration<double> (Clock::now () - start).count ();
+	} while (elapsed < BENCH_SECONDS);
+
+	return n / elapsed;
+}
+
+/******************************************************************************/
+
+static void usage (const char *argv0) {
+	fprintf (stderr, "Usage: %s [-b] [-g GOLDEN | -w GOLDEN] TRACE\n", argv0);
+	exit (2);
+}
+
+int main (int argc, char *argv[]) {
+	boolean benchmark = false;
+	const char *golden = nullptr;
+	boolean write = false;
+
+	int opt;
+	while ((opt = getopt (argc, argv, "bg:w:")) != -1) {
+		switch (opt) {
+			case 'b':
+				benchmark = true;
+				break;
+			case 'g':
+				golden = optarg;
+				write = false;
+				break;
+			case 'w':
+				golden = optarg;
+				write = true;
+				break;
+			default:
+				usage (argv[0]);
+				break;
+		}
+	}
+
+	if (optind != argc - 1) {
+		usage (argv[0]);
+	}
+
+	if (!loadTrace (argv[optind], trace)) {
+		fprintf (stderr, "Cannot read %s\n", argv[optind]);
+		return 2;
+	}
+
+	if (trace.empty () || (trace[0] >> 5) != TRACE_START) {
+		fprintf (stderr, "%s is not a matrix trace\n", argv[optind]);
+		return 2;
+	}
+
+	const TraceSource src = static_cast<TraceSource> (trace[0] & TRACE_ARG_VARINT);
+	if (replay (src)) {
+		return 2;
+	}
+
+	int ret = 0;
+	if (!golden) {
+		for (size_t i = 0; i < timeline.size (); ++i) {
+			printf ("%s\n", timeline[i].c_str ());
+		}
+	} else if (write) {
+		if (!writeGolden (golden)) {
+			fprintf (stderr, "Cannot write %s\n", golden);
+			ret = 2;
+		}
+	} else {
+		ret = checkGolden (golden);
+	}
+
+	fprintf (stderr, "%lu ms, %lu scans, %lu reports\n", traceMillis, scans, static_cast<unsigned long> (timeline.size ()));
+
+	if (benchmark) {
+		fprintf (stderr, "replay: %12.0f scans/s\n", bench (src));
+	}
+
+	return ret;
+}
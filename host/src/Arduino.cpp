@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file Arduino.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Minimal Arduino core for host builds
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include <stdio.h>
+#include <Arduino.h>
+
+volatile uint8_t DDRB, PORTB, PINB = 0xFF;
+volatile uint8_t DDRD, PORTD, PIND = 0xFF;
+volatile uint8_t DDRF, PORTF, PINF = 0xFF;
+volatile uint8_t PCMSK0, PCICR, PCIFR;
+
+Serial_ Serial;
+
+static unsigned long now;
+
+unsigned long millis () {
+	return now / 1000UL;
+}
+
+unsigned long micros () {
+	return now;
+}
+
+void delay (unsigned long ms) {
+	now += ms * 1000UL;
+}
+
+void delayMicroseconds (unsigned int us) {
+	now += us;
+}
+
+void hostAdvanceMicros (unsigned long us) {
+	now += us;
+}
+
+void hostSetMicros (unsigned long us) {
+	now = us;
+}
+
+size_t Print::write (const uint8_t *buf, size_t size) {
+	size_t n = 0;
+	while (size--) {
+		n += write (*buf++);
+	}
+
+	return n;
+}
+
+size_t Print::print (const __FlashStringHelper *s) {
+	return print (reinterpret_cast<const char *> (s));
+}
+
+size_t Print::print (const char *s) {
+	return write (s);
+}
+
+size_t Print::print (char c) {
+	return write (static_cast<uint8_t> (c));
+}
+
+size_t Print::print (int n, int base) {
+	return print (static_cast<long> (n), base);
+}
+
+size_t Print::print (unsigned int n, int base) {
+	return print (static_cast<unsigned long> (n), base);
+}
+
+size_t Print::print (long n, int base) {
+	size_t ret = 0;
+
+	if (base == DEC && n < 0) {
+		ret = print ('-');
+		ret += printNumber (-static_cast<unsigned long> (n), base);
+	} else {
+		ret = printNumber (static_cast<unsigned long> (n), base);
+	}
+
+	return ret;
+}
+
+size_t Print::print (unsigned long n, int base) {
+	return printNumber (n, base);
+}
+
+size_t Print::print (double n, int digits) {
+	char buf[32];
+	snprintf (buf, sizeof (buf), "%.*f", digits, n);
+	return print (buf);
+}
+
+size_t Print::printNumber (unsigned long n, int base) {
+	char buf[8 * sizeof (long) + 1];
+	char *str = &buf[sizeof (buf) - 1];
+
+	*str = '\0';
+	do {
+		const char c = n % base;
+		n /= base;
+		*--str = c < 10 ? c + '0' : c + 'A' - 10;
+	} while (n);
+
+	return write (str);
+}
+
+size_t Serial_::write (uint8_t c) {
+	return putchar (c) == EOF ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file Globals.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Globals the firmware sources expect, defined by the sketch on target
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include "Log.h"
+#include "KeymapOverrides.h"
+#include "LatencyStats.h"
+#include "MatrixTrace.h"
+
+Logging Log;
+
+KeymapOverrides keymapOverrides;
+
+#ifdef ENABLE_LATENCY_STATS
+LatencyStats latencyStats;
+#endif
+
+#ifdef ENABLE_MATRIX_TRACE
+MatrixTrace matrixTrace;
+#endif
@@ -0,0 +1,245 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file HID-Project.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief HID-Project stub for host builds
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include <HID-Project.h>
+
+BootKeyboard_ BootKeyboard;
+
+const uint16_t _asciimap[128] = {
+	KEY_RESERVED,				// 0x00
+	KEY_RESERVED,				// 0x01
+	KEY_RESERVED,				// 0x02
+	KEY_RESERVED,				// 0x03
+	KEY_RESERVED,				// 0x04
+	KEY_RESERVED,				// 0x05
+	KEY_RESERVED,				// 0x06
+	KEY_RESERVED,				// 0x07
+	KEY_BACKSPACE,				// 0x08
+	KEY_TAB,					// 0x09
+	KEY_ENTER,					// 0x0A
+	KEY_RESERVED,				// 0x0B
+	KEY_RESERVED,				// 0x0C
+	KEY_RESERVED,				// 0x0D
+	KEY_RESERVED,				// 0x0E
+	KEY_RESERVED,				// 0x0F
+	KEY_RESERVED,				// 0x10
+	KEY_RESERVED,				// 0x11
+	KEY_RESERVED,				// 0x12
+	KEY_RESERVED,				// 0x13
+	KEY_RESERVED,				// 0x14
+	KEY_RESERVED,				// 0x15
+	KEY_RESERVED,				// 0x16
+	KEY_RESERVED,				// 0x17
+	KEY_RESERVED,				// 0x18
+	KEY_RESERVED,				// 0x19
+	KEY_RESERVED,				// 0x1A
+	KEY_ESC,					// 0x1B
+	KEY_RESERVED,				// 0x1C
+	KEY_RESERVED,				// 0x1D
+	KEY_RESERVED,				// 0x1E
+	KEY_RESERVED,				// 0x1F
+	KEY_SPACE,					// ' '
+	KEY_1|MOD_LEFT_SHIFT,		// '!'
+	KEY_QUOTE|MOD_LEFT_SHIFT,	// '"'
+	KEY_3|MOD_LEFT_SHIFT,		// '#'
+	KEY_4|MOD_LEFT_SHIFT,		// '$'
+	KEY_5|MOD_LEFT_SHIFT,		// '%'
+	KEY_7|MOD_LEFT_SHIFT,		// '&'
+	KEY_QUOTE,					// '\''
+	KEY_9|MOD_LEFT_SHIFT,		// '('
+	KEY_0|MOD_LEFT_SHIFT,		// ')'
+	KEY_8|MOD_LEFT_SHIFT,		// '*'
+	KEY_EQUAL|MOD_LEFT_SHIFT,	// '+'
+	KEY_COMMA,					// ','
+	KEY_MINUS,					// '-'
+	KEY_PERIOD,				// '.'
+	KEY_SLASH,					// '/'
+	KEY_0,						// '0'
+	KEY_1,						// '1'
+	KEY_2,						// '2'
+	KEY_3,						// '3'
+	KEY_4,						// '4'
+	KEY_5,						// '5'
+	KEY_6,						// '6'
+	KEY_7,						// '7'
+	KEY_8,						// '8'
+	KEY_9,						// '9'
+	KEY_SEMICOLON|MOD_LEFT_SHIFT,	// ':'
+	KEY_SEMICOLON,				// ';'
+	KEY_COMMA|MOD_LEFT_SHIFT,	// '<'
+	KEY_EQUAL,					// '='
+	KEY_PERIOD|MOD_LEFT_SHIFT,	// '>'
+	KEY_SLASH|MOD_LEFT_SHIFT,	// '?'
+	KEY_2|MOD_LEFT_SHIFT,		// '@'
+	KEY_A|MOD_LEFT_SHIFT,		// 'A'
+	KEY_B|MOD_LEFT_SHIFT,		// 'B'
+	KEY_C|MOD_LEFT_SHIFT,		// 'C'
+	KEY_D|MOD_LEFT_SHIFT,		// 'D'
+	KEY_E|MOD_LEFT_SHIFT,		// 'E'
+	KEY_F|MOD_LEFT_SHIFT,		// 'F'
+	KEY_G|MOD_LEFT_SHIFT,		// 'G'
+	KEY_H|MOD_LEFT_SHIFT,		// 'H'
+	KEY_I|MOD_LEFT_SHIFT,		// 'I'
+	KEY_J|MOD_LEFT_SHIFT,		// 'J'
+	KEY_K|MOD_LEFT_SHIFT,		// 'K'
+	KEY_L|MOD_LEFT_SHIFT,		// 'L'
+	KEY_M|MOD_LEFT_SHIFT,		// 'M'
+	KEY_N|MOD_LEFT_SHIFT,		// 'N'
+	KEY_O|MOD_LEFT_SHIFT,		// 'O'
+	KEY_P|MOD_LEFT_SHIFT,		// 'P'
+	KEY_Q|MOD_LEFT_SHIFT,		// 'Q'
+	KEY_R|MOD_LEFT_SHIFT,		// 'R'
+	KEY_S|MOD_LEFT_SHIFT,		// 'S'
+	KEY_T|MOD_LEFT_SHIFT,		// 'T'
+	KEY_U|MOD_LEFT_SHIFT,		// 'U'
+	KEY_V|MOD_LEFT_SHIFT,		// 'V'
+	KEY_W|MOD_LEFT_SHIFT,		// 'W'
+	KEY_X|MOD_LEFT_SHIFT,		// 'X'
+	KEY_Y|MOD_LEFT_SHIFT,		// 'Y'
+	KEY_Z|MOD_LEFT_SHIFT,		// 'Z'
+	KEY_LEFT_BRACE,			// '['
+	KEY_BACKSLASH,				// '\\'
+	KEY_RIGHT_BRACE,			// ']'
+	KEY_6|MOD_LEFT_SHIFT,		// '^'
+	KEY_MINUS|MOD_LEFT_SHIFT,	// '_'
+	KEY_TILDE,					// '`'
+	KEY_A,						// 'a'
+	KEY_B,						// 'b'
+	KEY_C,						// 'c'
+	KEY_D,						// 'd'
+	KEY_E,						// 'e'
+	KEY_F,						// 'f'
+	KEY_G,						// 'g'
+	KEY_H,						// 'h'
+	KEY_I,						// 'i'
+	KEY_J,						// 'j'
+	KEY_K,						// 'k'
+	KEY_L,						// 'l'
+	KEY_M,						// 'm'
+	KEY_N,						// 'n'
+	KEY_O,						// 'o'
+	KEY_P,						// 'p'
+	KEY_Q,						// 'q'
+	KEY_R,						// 'r'
+	KEY_S,						// 's'
+	KEY_T,						// 't'
+	KEY_U,						// 'u'
+	KEY_V,						// 'v'
+	KEY_W,						// 'w'
+	KEY_X,						// 'x'
+	KEY_Y,						// 'y'
+	KEY_Z,						// 'z'
+	KEY_LEFT_BRACE|MOD_LEFT_SHIFT,	// '{'
+	KEY_BACKSLASH|MOD_LEFT_SHIFT,	// '|'
+	KEY_RIGHT_BRACE|MOD_LEFT_SHIFT,	// '}'
+	KEY_TILDE|MOD_LEFT_SHIFT,	// '~'
+	KEY_DELETE,				// 0x7F
+};
+
+BootKeyboard_::BootKeyboard_ () {
+	begin ();
+}
+
+void BootKeyboard_::begin () {
+	memset (&report, 0x00, sizeof (report));
+	sends = 0;
+	leds = 0;
+	onSend = nullptr;
+}
+
+size_t BootKeyboard_::add (KeyboardKeycode k) {
+	size_t ret = 0;
+
+	if (k >= KEY_LEFT_CTRL && k <= KEY_RIGHT_GUI) {
+		report.modifiers |= 1 << (k - KEY_LEFT_CTRL);
+		ret = 1;
+	} else {
+		// Key might already be there, otherwise take the first free slot
+		int free = -1;
+		for (byte i = 0; i < sizeof (report.keycodes) && ret == 0; ++i) {
+			if (report.keycodes[i] == k) {
+				ret = 1;
+			} else if (report.keycodes[i] == KEY_RESERVED && free < 0) {
+				free = i;
+			}
+		}
+
+		if (ret == 0 && free >= 0) {
+			report.keycodes[free] = k;
+			ret = 1;
+		}
+	}
+
+	return ret;
+}
+
+size_t BootKeyboard_::add (uint8_t c) {
+	size_t ret = 0;
+
+	const uint16_t key = c < 128 ? _asciimap[c] : KEY_RESERVED;
+	if (key != KEY_RESERVED) {
+		ret = add (static_cast<KeyboardKeycode> (key & 0xFF));
+		if (ret) {
+			report.modifiers |= key >> 8;
+		}
+	}
+
+	return ret;
+}
+
+size_t BootKeyboard_::remove (KeyboardKeycode k) {
+	size_t ret = 0;
+
+	if (k >= KEY_LEFT_CTRL && k <= KEY_RIGHT_GUI) {
+		report.modifiers &= ~(1 << (k - KEY_LEFT_CTRL));
+		ret = 1;
+	} else {
+		for (byte i = 0; i < sizeof (report.keycodes); ++i) {
+			if (report.keycodes[i] == k) {
+				report.keycodes[i] = KEY_RESERVED;
+				ret = 1;
+			}
+		}
+	}
+
+	return ret;
+}
+
+size_t BootKeyboard_::remove (uint8_t c) {
+	size_t ret = 0;
+
+	const uint16_t key = c < 128 ? _asciimap[c] : KEY_RESERVED;
+	if (key != KEY_RESERVED) {
+		ret = remove (static_cast<KeyboardKeycode> (key & 0xFF));
+		report.modifiers &= ~(key >> 8);
+	}
+
+	return ret;
+}
+
+size_t BootKeyboard_::releaseAll () {
+	memset (&report, 0x00, sizeof (report));
+	return 1;
+}
+
+int BootKeyboard_::send () {
+	++sends;
+	if (onSend) {
+		onSend (report);
+	}
+
+	return 1;
+}
@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file HostMatrix.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Simulated keyboard matrix for host builds
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include <HostMatrix.h>
+
+// Pin-change ISR of the passive scanner
+extern "C" void PCINT0_vect (void);
+
+HostMatrix hostMatrix;
+
+byte HostMatrix::columns (const byte rows) const {
+	byte cols = 0xFF;
+	for (byte row = 0; row < ROWS; ++row) {
+		if (rows & (1 << row)) {
+			cols &= ~keys[row];
+		}
+	}
+
+	return cols;
+}
+
+void HostMatrix::tedPoll () {
+	// Quick test first: all rows low, only go on if any column is low
+	PINB = 0x00;
+	PIND = columns (0xFF);
+	PCINT0_vect ();
+
+	if (PIND != 0xFF) {
+		for (byte row = 0; row < ROWS; ++row) {
+			PINB = ~(1 << row);
+			PIND = columns (1 << row);
+			PCINT0_vect ();
+		}
+	}
+
+	// Release the rows
+	PINB = 0xFF;
+	PIND = 0xFF;
+}
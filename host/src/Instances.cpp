@@ -0,0 +1,25 @@
+/**
+ * Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/**
+ * \file Instances.cpp
+ * \author SukkoPera <software@sukkology.net>
+ * \date 18 Oct 2026
+ * \brief Template instances built into the host library
+ *
+ * Please refer to the GitHub page and wiki for any information:
+ * https://github.com/SukkoPera/MechBoard16
+ */
+
+#include "KbdScannerC16.h"
+#include "KbdScannerC64.h"
+#include "KbdScannerVic20.h"
+#include "KeyboardHandler.h"
+
+template class MatrixKeyboardScanner<C16_MATRIX_ROWS, C16_MATRIX_COLS, byte, DEBOUNCE_FACTOR_C16, KeyMapperC16>;
+template class KbdScannerCbm<C64Layout>;
+template class KbdScannerCbm<Vic20Layout>;
+template class KeyboardHandler<C16_MATRIX_ROWS, C16_MATRIX_COLS>;
@@ -0,0 +1,290 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+"""Mechware16 animation encoder
+
+Compiles animation sources (*.anim) into the bytecode played by
+AnimationBytecode and writes them as a header that the sketch includes.
+
+Source syntax, one statement per line, '#' starts a comment:
+
+    group NAME KEY...   Define a named set of keys, usable wherever keys are
+    show KEY...         Light exactly the given keys
+    on KEY...           Turn on the given keys, leaving the others alone
+    off KEY...          Turn off the given keys, leaving the others alone
+    frame               Followed by 8 lines of 8 '#'/'.' chars, in led space
+    fill                All leds on
+    clear               All leds off
+    wait MS             Keep the current frame for MS milliseconds
+    loop N              Repeat up to the matching 'next' N times (max 255)
+    next                End of loop body
+
+Keys are the names of the C16Key enum, digits can be written without the
+leading underscore. The led each key drives is computed from the keymap in
+Mechware16.ino, the same way buildLedCoordinates() does, so that frames can be
+delta-encoded across show/on/off statements.
+
+Usage: animenc.py [-o AnimationPrograms.h] file.anim...
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# Keep in sync with AnimationOpcode in AnimationBytecode.h
+OP_END = 0x00
+OP_CLEAR = 0x01
+OP_FRAME = 0x02
+OP_DELTA = 0x03
+OP_RLE = 0x04
+OP_WAIT = 0x05
+OP_LOOP = 0x06
+OP_NEXT = 0x07
+OP_KEY_ON = 0x80
+OP_KEY_OFF = 0xC0
+
+SKETCH_DIR = os.path.join (os.path.dirname (os.path.abspath (__file__)), "..", "Mechware16")
+
+
+class EncoderError (Exception):
+	pass
+
+
+def loadKeys ():
+	"""Returns a dict mapping C16Key names to their values"""
+	with open (os.path.join (SKETCH_DIR, "C16Key.h")) as f:
+		src = f.read ()
+	body = re.search (r"enum class C16Key: byte \{(.*?)\};", src, re.S).group (1)
+	keys = {}
+	n = 0
+	for line in body.split ("\n"):
+		line = line.split ("//")[0].strip ().rstrip (",")
+		if not line:
+			continue
+		if "=" in line:
+			name, val = [x.strip () for x in line.split ("=")]
+			n = int (val, 0)
+		else:
+			name = line
+		keys[name] = n
+		n += 1
+	return keys
+
+
+def loadLedCoordinates (keys):
+	"""Returns a dict mapping key values to (led row, led col), as buildLedCoordinates() does"""
+	with open (os.path.join (SKETCH_DIR, "Mechware16.ino")) as f:
+		src = f.read ()
+	body = re.search (r"constexpr C16Key keymap\[MATRIX_ROWS\]\[MATRIX_COLS\] PROGMEM = \{(.*?)\n\};", src, re.S).group (1)
+	coords = {}
+	rows = re.findall (r"\{([^}]*)\}", body)
+	for row, line in enumerate (rows):
+		for col, name in enumerate (re.findall (r"C16Key::(\w+)", line)):
+			coords.setdefault (keys[name], (col, (row + 1) % 8))
+	return coords
+
+
+class Encoder:
+	def __init__ (self, keys, coords):
+		self.keys = keys
+		self.coords = coords
+
+	def parseKeys (self, names, groups, lineno):
+		ret = []
+		for name in names:
+			if name in groups:
+				ret.extend (groups[name])
+			elif name in self.keys and name != "NONE":
+				ret.append (self.keys[name])
+			elif "_" + name in self.keys:
+				ret.append (self.keys["_" + name])
+			else:
+				raise EncoderError ("line %d: unknown key '%s'" % (lineno, name))
+		return ret
+
+	def keysToFrame (self, keys):
+		frame = [0] * 8
+		for k in keys:
+			r, c = self.coords[k]
+			frame[r] |= 0x80 >> c
+		return frame
+
+	def encodeFrame (self, cur, new):
+		"""Returns the shortest opcode sequence turning frame cur (None if unknown) into new"""
+		if cur == new:
+			return []
+
+		candidates = [[OP_FRAME] + new]
+
+		if not any (new):
+			candidates.append ([OP_CLEAR])
+
+		rle = [OP_RLE]
+		r = 0
+		while r < 8:
+			n = 1
+			while r + n < 8 and new[r + n] == new[r]:
+				n += 1
+			rle += [n, new[r]]
+			r += n
+		candidates.append (rle)
+
+		if cur is not None:
+			mask = 0
+			delta = []
+			for r in range (8):
+				if cur[r] != new[r]:
+					mask |= 1 << r
+					delta.append (cur[r] ^ new[r])
+			candidates.append ([OP_DELTA, mask] + delta)
+
+		return min (candidates, key = len)
+
+	def compile (self, lines):
+		out = []
+		groups = {}
+		loops = []
+		frame = None		# Led state, None if not known at compile time
+		it = iter (enumerate (lines, 1))
+		for lineno, line in it:
+			tokens = line.split ("#")[0].split ()
+			if not tokens:
+				continue
+			cmd, args = tokens[0], tokens[1:]
+			if cmd == "group":
+				if not args:
+					raise EncoderError ("line %d: group needs a name" % lineno)
+				groups[args[0]] = self.parseKeys (args[1:], groups, lineno)
+			elif cmd == "show":
+				new = self.keysToFrame (self.parseKeys (args, groups, lineno))
+				out += self.encodeFrame (frame, new)
+				frame = new
+			elif cmd in ("on", "off"):
+				keys = self.parseKeys (args, groups, lineno)
+				if frame is not None:
+					# Use a frame if that's shorter than single key ops
+					new = list (frame)
+					for k in keys:
+						r, c = self.coords[k]
+						if cmd == "on":
+							new[r] |= 0x80 >> c
+						else:
+							new[r] &= ~(0x80 >> c) & 0xFF
+					enc = self.encodeFrame (frame, new)
+					if len (enc) < len (keys):
+						out += enc
+						frame = new
+						continue
+					frame = new
+				for k in keys:
+					out.append ((OP_KEY_ON if cmd == "on" else OP_KEY_OFF) | k)
+			elif cmd == "frame":
+				new = []
+				for _ in range (8):
+					lineno, row = next (it)
+					row = row.strip ()
+					if len (row) != 8 or any (c not in "#." for c in row):
+						raise EncoderError ("line %d: bad frame row '%s'" % (lineno, row))
+					new.append (sum (0x80 >> i for i, c in enumerate (row) if c == "#"))
+				out += self.encodeFrame (frame, new)
+				frame = new
+			elif cmd == "fill":
+				out += self.encodeFrame (frame, [0xFF] * 8)
+				frame = [0xFF] * 8
+			elif cmd == "clear":
+				out += self.encodeFrame (frame, [0x00] * 8)
+				frame = [0x00] * 8
+			elif cmd == "wait":
+				ms = int (args[0], 0)
+				while ms > 0:
+					out += [OP_WAIT, min (ms, 255)]
+					ms -= 255
+			elif cmd == "loop":
+				n = int (args[0], 0)
+				if not 1 <= n <= 255:
+					raise EncoderError ("line %d: loop count must be 1-255" % lineno)
+				loops.append (lineno)
+				if len (loops) > 2:
+					raise EncoderError ("line %d: loops can only be nested twice" % lineno)
+				out += [OP_LOOP, n]
+				frame = None		# Body will be entered with different states
+			elif cmd == "next":
+				if not loops:
+					raise EncoderError ("line %d: next without loop" % lineno)
+				loops.pop ()
+				out.append (OP_NEXT)
+				frame = None
+			else:
+				raise EncoderError ("line %d: unknown statement '%s'" % (lineno, cmd))
+
+		if loops:
+			raise EncoderError ("line %d: unterminated loop" % loops[-1])
+
+		out.append (OP_END)
+		return out
+
+
+def main ():
+	parser = argparse.ArgumentParser (description = "Mechware16 animation encoder")
+	parser.add_argument ("-o", "--output", help = "Output file (default: stdout)")
+	parser.add_argument ("sources", nargs = "+", help = "Animation sources")
+	args = parser.parse_args ()
+
+	keys = loadKeys ()
+	enc = Encoder (keys, loadLedCoordinates (keys))
+
+	programs = []
+	for path in args.sources:
+		name = os.path.splitext (os.path.basename (path))[0]
+		ident = "animProgram" + "".join (p.capitalize () for p in re.split (r"[^A-Za-z0-9]+", name) if p)
+		with open (path) as f:
+			try:
+				programs.append ((ident, path, enc.compile (f.read ().split ("\n"))))
+			except EncoderError as ex:
+				sys.exit ("%s: %s" % (path, ex))
+
+	total = sum (len (p) for _, _, p in programs)
+	lines = [
+		"/**",
+		" * \\file AnimationPrograms.h",
+		" * \\brief Bytecode animation programs",
+		" *",
+		" * GENERATED by tools/animenc.py, DO NOT EDIT! Modify the sources in",
+		" * tools/animations/ and regenerate this file instead, with:",
+		" *   %s" % " ".join (["tools/animenc.py", "-o", "Mechware16/AnimationPrograms.h"] + [os.path.relpath (p) for p in args.sources]),
+		" *",
+		" * %d programs, %d bytes total." % (len (programs), total),
+		" */",
+		"",
+		"#pragma once",
+		"",
+		"#include <avr/pgmspace.h>",
+		"",
+	]
+	for ident, path, prog in programs:
+		lines.append ("// %s, %d bytes" % (os.path.basename (path), len (prog)))
+		lines.append ("const byte %s[] PROGMEM = {" % ident)
+		for i in range (0, len (prog), 16):
+			lines.append ("\t" + ", ".join ("0x%02X" % b for b in prog[i:i + 16]) + ("," if i + 16 < len (prog) else ""))
+		lines.append ("};")
+		lines.append ("")
+	lines.append ("constexpr byte N_ANIMATION_PROGRAMS = %d;" % len (programs))
+	lines.append ("")
+	lines.append ("const byte * const animationPrograms[N_ANIMATION_PROGRAMS] PROGMEM = {")
+	lines.append (",\n".join ("\t" + ident for ident, _, _ in programs))
+	lines.append ("};")
+
+	text = "\n".join (lines) + "\n"
+	if args.output:
+		with open (args.output, "w") as f:
+			f.write (text)
+	else:
+		sys.stdout.write (text)
+
+
+if __name__ == "__main__":
+	main ()
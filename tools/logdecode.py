@@ -0,0 +1,275 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+"""Mechware16 binary log decoder
+
+Turns the records sent by a firmware built with ENABLE_BINARY_LOGGING back
+into text. The record format is described in Log.h.
+
+Format strings wrapped in LOG_STR() are not in the firmware, so they are found
+by scanning the sources the firmware was built from, which default to the
+Mechware16 directory next to this one. Any other format strings are read from
+the firmware ELF file.
+
+Usage:
+    logdecode.py [-s SRCDIR] FIRMWARE.elf [PORT|FILE]
+
+Records are read from stdin if no port or file is given. Reading from a serial
+port requires pyserial.
+"""
+
+import os
+import re
+import stat
+import struct
+import sys
+
+SOF = 0x5A
+INTERNED = 0x80
+ID_RAM = 0xFFFF
+LEVELS = "FEWIDT"
+
+# Argument descriptor entries
+ARG_WORD = 1
+ARG_DWORD = 2
+ARG_STRING = 3
+
+SOURCE_EXTENSIONS = (".ino", ".cpp", ".h")
+
+# ELF section type and flag we care about
+SHT_PROGBITS = 1
+SHF_ALLOC = 2
+
+# AVR data memory is mapped from here on in ELF files
+AVR_DATA_BASE = 0x800000
+
+
+class Firmware:
+	"""Flash contents, as found in an ELF file"""
+
+	def __init__ (self, filename):
+		with open (filename, "rb") as f:
+			data = f.read ()
+		if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+			raise ValueError ("%s is not a 32-bit little-endian ELF file" % filename)
+
+		shoff, = struct.unpack_from ("<I", data, 0x20)
+		shentsize, shnum = struct.unpack_from ("<HH", data, 0x2E)
+		self.sections = []
+		for i in range (shnum):
+			_, shtype, flags, addr, offset, size = struct.unpack_from ("<IIIIII", data, shoff + i * shentsize)
+			if shtype == SHT_PROGBITS and flags & SHF_ALLOC and addr < AVR_DATA_BASE:
+				self.sections.append ((addr, data[offset:offset + size]))
+
+	def string (self, addr):
+		for base, contents in self.sections:
+			if base <= addr < base + len (contents):
+				end = contents.find (b"\0", addr - base)
+				return contents[addr - base:end].decode ("ascii", "replace")
+		return "<unknown string at 0x%04x>" % addr
+
+
+def logHash (s):
+	"""Same as logHash() in Log.h"""
+	h = 2166136261
+	for c in s.encode ("latin-1"):
+		h = ((h ^ c) * 16777619) & 0xFFFFFFFF
+	return (h >> 16) ^ (h & 0xFFFF)
+
+
+LOG_STR = re.compile (r'LOG_STR\s*\(((?:\s*"(?:[^"\\\n]|\\.)*")+)\s*\)')
+LITERAL = re.compile (r'"((?:[^"\\\n]|\\.)*)"')
+ESCAPE = re.compile (r'\\(x[0-9a-fA-F]+|[0-7]{1,3}|.)')
+ESCAPES = {"n": "\n", "t": "\t", "r": "\r", "a": "\a", "b": "\b", "f": "\f", "v": "\v"}
+
+
+def unescape (literal):
+	def replace (m):
+		e = m.group (1)
+		if e[0] == "x":
+			return chr (int (e[1:], 16))
+		elif e[0] in "01234567":
+			return chr (int (e, 8))
+		return ESCAPES.get (e, e)
+	return ESCAPE.sub (replace, literal)
+
+
+def internedStrings (srcdir):
+	"""Maps the hash of every LOG_STR() string found in the sources to it"""
+	table = {}
+	for name in sorted (os.listdir (srcdir)):
+		if not name.endswith (SOURCE_EXTENSIONS):
+			continue
+		with open (os.path.join (srcdir, name), encoding = "utf-8", errors = "replace") as f:
+			for m in LOG_STR.finditer (f.read ()):
+				fmt = "".join (unescape (lit) for lit in LITERAL.findall (m.group (1)))
+				h = logHash (fmt)
+				if table.get (h, fmt) != fmt:
+					print ("Warning: %r and %r have the same hash" % (table[h], fmt), file = sys.stderr)
+				table[h] = fmt
+	return table
+
+
+class Args:
+	"""Unpacks arguments as stored by Logging::packArg()"""
+
+	def __init__ (self, data):
+		self.data = data
+		self.pos = 0
+
+	def take (self, fmt):
+		size = struct.calcsize (fmt)
+		if self.pos + size > len (self.data):
+			raise IndexError
+		value, = struct.unpack_from (fmt, self.data, self.pos)
+		self.pos += size
+		return value
+
+	def string (self):
+		n = self.take ("<B")
+		if self.pos + n > len (self.data):
+			raise IndexError
+		s = self.data[self.pos:self.pos + n].decode ("ascii", "replace")
+		self.pos += n
+		return s
+
+
+def formatMessage (fw, fmt, args):
+	"""Same as Logging::printFormat(), with arguments taken from a record"""
+	out = []
+	i = 0
+	while i < len (fmt):
+		c = fmt[i]
+		i += 1
+		if c != "%" or i >= len (fmt):
+			out.append (c)
+			continue
+
+		spec = fmt[i]
+		i += 1
+		try:
+			if spec == "%":
+				out.append ("%")
+			elif spec == "s":
+				out.append (args.string ())
+			elif spec == "S":
+				out.append (fw.string (args.take ("<H")))
+			elif spec in "di":
+				out.append (str (args.take ("<h")))
+			elif spec in "DF":
+				out.append ("%.2f" % args.take ("<f"))
+			elif spec == "x":
+				out.append ("%X" % args.take ("<H"))
+			elif spec == "X":
+				out.append ("0x%X" % args.take ("<H"))
+			elif spec == "b":
+				out.append ("{:b}".format (args.take ("<H")))
+			elif spec == "B":
+				out.append ("0b{:b}".format (args.take ("<H")))
+			elif spec == "l":
+				out.append (str (args.take ("<i")))
+			elif spec == "u":
+				out.append (str (args.take ("<I")))
+			elif spec == "U":
+				out.append ("0x%X" % args.take ("<I"))
+			elif spec == "w":
+				out.append (str (args.take ("<H")))
+			elif spec == "c":
+				out.append (chr (args.take ("<h") & 0xFF))
+			elif spec == "t":
+				out.append ("T" if args.take ("<h") == 1 else "F")
+			elif spec == "T":
+				out.append ("true" if args.take ("<h") == 1 else "false")
+		except IndexError:
+			# Arguments that did not fit in the record
+			out.append ("?")
+
+	return "".join (out)
+
+
+def rawArgs (desc, args):
+	"""Arguments of a message whose format string is unknown, as described by desc"""
+	out = []
+	try:
+		while desc != 0:
+			t = desc & 0x03
+			if t == ARG_WORD:
+				out.append ("0x%04X" % args.take ("<H"))
+			elif t == ARG_DWORD:
+				out.append ("0x%08X" % args.take ("<I"))
+			elif t == ARG_STRING:
+				out.append (repr (args.string ()))
+			desc >>= 2
+	except IndexError:
+		out.append ("?")
+	return " ".join (out)
+
+
+def decode (fw, interned, body):
+	level = body[0] & ~INTERNED
+	msgid, desc = struct.unpack_from ("<HB", body, 1)
+	args = Args (body[4:])
+	if level == 0 and msgid == 0:
+		return "*** %d records dropped" % args.take ("<H")
+
+	lvl = LEVELS[level - 1] if 1 <= level <= len (LEVELS) else "?"
+	if body[0] & INTERNED:
+		if msgid not in interned:
+			return "%s: <unknown message 0x%04X> %s" % (lvl, msgid, rawArgs (desc, args))
+		fmt = interned[msgid]
+	elif msgid == ID_RAM:
+		fmt = args.string ()
+	else:
+		fmt = fw.string (msgid)
+	return "%s: %s" % (lvl, formatMessage (fw, fmt, args).rstrip ("\n"))
+
+
+def records (read):
+	"""Yields the body of every valid record, skipping anything else"""
+	while True:
+		c = read (1)
+		if not c:
+			return
+		if c[0] != SOF:
+			continue
+		n = read (1)
+		if not n or n[0] < 4:
+			continue
+		body = read (n[0])
+		chk = read (1)
+		if len (body) == n[0] and chk and (n[0] + sum (body) + chk[0]) & 0xFF == 0:
+			yield body
+
+
+def main ():
+	argv = sys.argv[1:]
+	srcdir = os.path.join (os.path.dirname (os.path.abspath (__file__)), "..", "Mechware16")
+	if len (argv) >= 2 and argv[0] == "-s":
+		srcdir = argv[1]
+		argv = argv[2:]
+	if len (argv) not in (1, 2):
+		sys.exit (__doc__)
+
+	fw = Firmware (argv[0])
+	interned = internedStrings (srcdir)
+	if len (argv) == 2 and stat.S_ISCHR (os.stat (argv[1]).st_mode):
+		import serial
+		port = serial.Serial (argv[1], 115200)
+		read = port.read
+	elif len (argv) == 2:
+		read = open (argv[1], "rb").read
+	else:
+		read = sys.stdin.buffer.read
+
+	for body in records (read):
+		print (decode (fw, interned, body), flush = True)
+
+
+if __name__ == "__main__":
+	try:
+		main ()
+	except KeyboardInterrupt:
+		pass
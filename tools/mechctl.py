@@ -0,0 +1,247 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024-2025 SukkoPera <software@sukkology.net>
+#
+# SPDX-License-Identifier: GPL-3.0-or-later
+#
+"""Mechware16 control tool
+
+Talks to a keyboard running a firmware built with ENABLE_SERIAL_COMMANDS,
+using the protocol described in SerialCommands.h. Requires pyserial.
+
+Usage:
+    mechctl.py PORT ping
+    mechctl.py PORT profile N
+    mechctl.py PORT set PROFILE FIELD VALUE     (FIELD: mode, animation, brightness, keymap, debounce, active)
+    mechctl.py PORT matrix
+    mechctl.py PORT counters
+    mechctl.py PORT latency [reset]
+    mechctl.py PORT bounce [reset]
+    mechctl.py PORT loop [reset]
+    mechctl.py PORT release-all
+    mechctl.py PORT save
+    mechctl.py PORT keymap FILE
+    mechctl.py PORT trace FILE [SECONDS]
+
+Keymap files contain one override per line, as "LAYER ROW COL KEY", where KEY
+is a USB keycode (e.g. 0x29) or a quoted character for ASCII keys (e.g. 'a').
+Layers are numbered by the mapper, for KeyMapperC16 they are 0 (positional),
+1 (symbolic), 2 (symbolic, shifted) and 3 (Fn, with ENABLE_KEY_LAYERS). The
+C64 and VIC-20 mappers have the same first three, plus 3 (RESTORE held). Lines
+starting with '#' are comments. An empty file removes all overrides.
+
+Latency histograms need a firmware built with ENABLE_LATENCY_STATS. Bucket N
+counts key presses that took between 2^N and 2^(N+1) timer ticks of 4 us.
+
+Bounce statistics need a firmware built with ENABLE_ADAPTIVE_DEBOUNCE and are
+only listed for keys that were used. Times are in scans: "settle" is the
+longest time a key took from its first to its last edge, "window" is the
+debounce window it is currently using. "Chatter" counts the times a key
+bounced again after being considered stable.
+
+Loop timings need a firmware built with ENABLE_LOOP_PROFILER. They show how
+many times each stage of the main loop ran since the last reset and how long it
+took, in us and CPU cycles.
+
+Traces need a firmware built with ENABLE_MATRIX_TRACE. Recording goes on for
+the given time, or until Ctrl-C is pressed, and the trace is saved to FILE, to
+be replayed with the replay tool in host/.
+"""
+
+import struct
+import sys
+import time
+
+import serial
+
+SOF = 0xA5
+REPLY = 0x80
+
+# Keep in sync with SerialCommands.h
+CMD_PING = 0x01
+CMD_GET_PROFILE = 0x02
+CMD_SET_SETTING = 0x03
+CMD_DUMP_MATRIX = 0x04
+CMD_GET_COUNTERS = 0x05
+CMD_ACTION = 0x06
+CMD_GET_LATENCY = 0x07
+CMD_GET_BOUNCE = 0x08
+CMD_GET_LOOP_STATS = 0x09
+CMD_GET_TRACE = 0x0A
+CMD_KEYMAP_EDIT = 0x10
+CMD_KEYMAP_ADD = 0x11
+CMD_KEYMAP_APPLY = 0x12
+
+STATUS_OK = 0
+STATUS_BUSY = 3
+STATUS_NAMES = ["OK", "Unknown command", "Bad arguments", "Busy"]
+
+FIELDS = {"mode": 0, "animation": 1, "brightness": 2, "keymap": 3, "debounce": 4, "active": 0xFF}
+
+MATRIX_ROWS = 8
+MATRIX_COLS = 8
+
+MASK_ASCIIKEY = 1 << 15
+
+LATENCY_INTERVALS = ["debounce", "schedule", "report", "total"]
+LATENCY_BUCKETS = 16
+US_PER_TICK = 4
+CYCLES_PER_TICK = 64
+
+LOOP_STAGES = ["combos", "scanner", "settings", "comms", "scan", "handle", "leds", "iteration"]
+
+TRACE_RECORDING = 0x01
+TRACE_OVERFLOW = 0x02
+
+
+class CommandError (Exception):
+	pass
+
+
+class Keyboard:
+	def __init__ (self, port):
+		self.ser = serial.Serial (port, 115200, timeout = 1)
+
+	def command (self, cmd, args = b"", retries = 20):
+		body = bytes ([cmd]) + bytes (args)
+		frame = bytes ([len (body)]) + body
+		frame = bytes ([SOF]) + frame + bytes ([-sum (frame) & 0xFF])
+		for _ in range (retries):
+			self.ser.write (frame)
+			status, data = self.readReply (cmd)
+			if status != STATUS_BUSY:
+				break
+			time.sleep (0.1)
+		if status != STATUS_OK:
+			raise CommandError (STATUS_NAMES[status] if status < len (STATUS_NAMES) else "Error %d" % status)
+		return data
+
+	def readReply (self, cmd):
+		while True:
+			c = self.ser.read (1)
+			if not c:
+				raise CommandError ("Timeout")
+			if c[0] != SOF:
+				continue
+			n = self.ser.read (1)[0]
+			body = self.ser.read (n)
+			chk = self.ser.read (1)[0]
+			if (n + sum (body) + chk) & 0xFF != 0:
+				continue
+			if body[0] == cmd | REPLY:
+				return body[1], body[2:]
+
+
+def parseKey (s):
+	if len (s) == 3 and s[0] == s[2] == "'":
+		return ord (s[1]) | MASK_ASCIIKEY
+	return int (s, 0)
+
+
+def main ():
+	if len (sys.argv) < 3:
+		sys.exit (__doc__)
+
+	kbd = Keyboard (sys.argv[1])
+	cmd, args = sys.argv[2], sys.argv[3:]
+
+	if cmd == "ping":
+		print ("Mechware16 %d.%d.%d" % tuple (kbd.command (CMD_PING)))
+	elif cmd == "profile":
+		r = kbd.command (CMD_GET_PROFILE, [int (args[0])])
+		print ("active=%d mode=%d animation=%d brightness=%d keymap=%d debounce=%d" % tuple (r))
+	elif cmd == "set":
+		kbd.command (CMD_SET_SETTING, [int (args[0]), FIELDS[args[1]], int (args[2], 0)])
+	elif cmd == "matrix":
+		for row in kbd.command (CMD_DUMP_MATRIX):
+			print ("".join ("#" if row & (1 << c) else "." for c in range (8)))
+	elif cmd == "counters":
+		scans, presses, releases, failures = struct.unpack ("<LHHH", kbd.command (CMD_GET_COUNTERS))
+		print ("scans=%d presses=%d releases=%d failures=%d" % (scans, presses, releases, failures))
+	elif cmd == "latency":
+		if args and args[0] == "reset":
+			kbd.command (CMD_ACTION, [2])
+		else:
+			for i, name in enumerate (LATENCY_INTERVALS):
+				hist = []
+				for first in range (0, LATENCY_BUCKETS, 8):
+					data = kbd.command (CMD_GET_LATENCY, [i, first])
+					hist += struct.unpack ("<%dH" % (len (data) // 2), data)
+				print ("%s:" % name)
+				for n, count in enumerate (hist):
+					if count:
+						print ("  %6d-%d us: %d" % ((1 << n) * US_PER_TICK if n else 0, (2 << n) * US_PER_TICK, count))
+	elif cmd == "bounce":
+		if args and args[0] == "reset":
+			kbd.command (CMD_ACTION, [3])
+		else:
+			print ("row col transitions edges/tr settle chatter window")
+			for row in range (MATRIX_ROWS):
+				for col in range (MATRIX_COLS):
+					data = kbd.command (CMD_GET_BOUNCE, [row, col])
+					transitions, edges, settle, chatter, window = struct.unpack ("<HHBBB", data)
+					if transitions:
+						print ("%3d %3d %11d %8.2f %6d %7d %6d" % (row, col, transitions, edges / transitions, settle, chatter, window))
+	elif cmd == "loop":
+		if args and args[0] == "reset":
+			kbd.command (CMD_ACTION, [4])
+		else:
+			print ("stage           count    min us   mean us    max us  mean cycles")
+			for i, name in enumerate (LOOP_STAGES):
+				lo, hi, total, count, elapsed = struct.unpack ("<HHLLL", kbd.command (CMD_GET_LOOP_STATS, [i]))
+				if count:
+					mean = total / count
+					print ("%-9s %11d %9d %9.1f %9d %12.0f" % (name, count, lo * US_PER_TICK, mean * US_PER_TICK, hi * US_PER_TICK, mean * CYCLES_PER_TICK))
+				if name == "iteration" and elapsed:
+					print ("%.0f iterations/s over %.1f s" % (count * 1000.0 / elapsed, elapsed / 1000.0))
+	elif cmd == "release-all":
+		kbd.command (CMD_ACTION, [0])
+	elif cmd == "save":
+		kbd.command (CMD_ACTION, [1])
+	elif cmd == "keymap":
+		overrides = []
+		with open (args[0]) as f:
+			for line in f:
+				tokens = line.split ()
+				if tokens and not tokens[0].startswith ("#"):
+					layer, row, col = [int (x, 0) for x in tokens[:3]]
+					overrides.append ((layer, row, col, parseKey (tokens[3])))
+		kbd.command (CMD_KEYMAP_EDIT)
+		for layer, row, col, key in overrides:
+			kbd.command (CMD_KEYMAP_ADD, [layer, row, col] + list (struct.pack ("<H", key)))
+		kbd.command (CMD_KEYMAP_APPLY)
+		print ("Applied %d overrides" % len (overrides))
+	elif cmd == "trace":
+		seconds = float (args[1]) if len (args) > 1 else None
+		trace = bytearray ()
+		kbd.command (CMD_ACTION, [5])
+		start = time.time ()
+		try:
+			# Keep emptying the ring, or recording stops when it is full
+			while seconds is None or time.time () - start < seconds:
+				data = kbd.command (CMD_GET_TRACE)
+				trace += data[1:]
+				if not data[0] & TRACE_RECORDING:
+					break
+		except KeyboardInterrupt:
+			pass
+		kbd.command (CMD_ACTION, [6])
+		while True:
+			data = kbd.command (CMD_GET_TRACE)
+			if len (data) == 1:
+				break
+			trace += data[1:]
+		if data[0] & TRACE_OVERFLOW:
+			print ("Trace ring overflowed, recording stopped after %.1f s" % (time.time () - start))
+		with open (args[0], "wb") as f:
+			f.write (trace)
+		print ("Saved %d bytes" % len (trace))
+	else:
+		sys.exit (__doc__)
+
+
+if __name__ == "__main__":
+	try:
+		main ()
+	except CommandError as ex:
+		sys.exit ("Error: %s" % ex)